@@ -63,10 +63,44 @@ Check if given C source compiles and links into an executable.
   In order to force the check to be re-evaluated, the variable named by
   ``<resultVar>`` must be manually removed from the cache.
 
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<resultVar>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_C_SOURCE_COMPILES_RESULT SOURCE VAR FAIL_REGEX QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Performing Test ${VAR}")
+  endif()
+  foreach(_regex ${FAIL_REGEX})
+    if("${OUTPUT}" MATCHES "${_regex}")
+      set(${VAR} 0)
+    endif()
+  endforeach()
+
+  if(${VAR})
+    set(${VAR} 1 CACHE INTERNAL "Test ${VAR}")
+    if(NOT QUIET)
+      message(CHECK_PASS "Success")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Performing C SOURCE FILE Test ${VAR} succeeded with the following output:\n"
+      "${OUTPUT}\n"
+      "Source file was:\n${SOURCE}\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "Failed")
+    endif()
+    set(${VAR} "" CACHE INTERNAL "Test ${VAR}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Performing C SOURCE FILE Test ${VAR} failed with the following output:\n"
+      "${OUTPUT}\n"
+      "Source file was:\n${SOURCE}\n")
+  endif()
+endfunction()
+
 macro(CHECK_C_SOURCE_COMPILES SOURCE VAR)
   if(NOT DEFINED "${VAR}")
     set(_FAIL_REGEX)
@@ -103,9 +137,7 @@ macro(CHECK_C_SOURCE_COMPILES SOURCE VAR)
     file(WRITE "${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/src.c"
       "${SOURCE}\n")
 
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Performing Test ${VAR}")
-    endif()
+    try_compile_batch(QUEUE)
     try_compile(${VAR}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/src.c
@@ -116,30 +148,7 @@ macro(CHECK_C_SOURCE_COMPILES SOURCE VAR)
       "${CHECK_C_SOURCE_COMPILES_ADD_INCLUDES}"
       OUTPUT_VARIABLE OUTPUT)
 
-    foreach(_regex ${_FAIL_REGEX})
-      if("${OUTPUT}" MATCHES "${_regex}")
-        set(${VAR} 0)
-      endif()
-    endforeach()
-
-    if(${VAR})
-      set(${VAR} 1 CACHE INTERNAL "Test ${VAR}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "Success")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Performing C SOURCE FILE Test ${VAR} succeeded with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${SOURCE}\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "Failed")
-      endif()
-      set(${VAR} "" CACHE INTERNAL "Test ${VAR}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Performing C SOURCE FILE Test ${VAR} failed with the following output:\n"
-        "${OUTPUT}\n"
-        "Source file was:\n${SOURCE}\n")
-    endif()
+    try_compile_batch(CALL __CHECK_C_SOURCE_COMPILES_RESULT
+      "${SOURCE}" "${VAR}" "${_FAIL_REGEX}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
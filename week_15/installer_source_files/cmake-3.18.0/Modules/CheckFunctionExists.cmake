@@ -48,17 +48,40 @@ way the check is run:
 
   * ``check_function_exists()`` only verifies linking, it does not verify
     that the function is declared in system headers.
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<variable>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_FUNCTION_EXISTS_RESULT FUNCTION VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${FUNCTION}")
+  endif()
+  if(${VARIABLE})
+    set(${VARIABLE} 1 CACHE INTERNAL "Have function ${FUNCTION}")
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the function ${FUNCTION} exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have function ${FUNCTION}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the function ${FUNCTION} exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endfunction()
+
 macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
   if(NOT DEFINED "${VARIABLE}" OR "x${${VARIABLE}}" STREQUAL "x${VARIABLE}")
     set(MACRO_CHECK_FUNCTION_DEFINITIONS
       "-DCHECK_FUNCTION_EXISTS=${FUNCTION} ${CMAKE_REQUIRED_FLAGS}")
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${FUNCTION}")
-    endif()
     if(CMAKE_REQUIRED_LINK_OPTIONS)
       set(CHECK_FUNCTION_EXISTS_ADD_LINK_OPTIONS
         LINK_OPTIONS ${CMAKE_REQUIRED_LINK_OPTIONS})
@@ -87,6 +110,7 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
       message(FATAL_ERROR "CHECK_FUNCTION_EXISTS needs either C or CXX language enabled")
     endif()
 
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${_cfe_source}
@@ -98,22 +122,7 @@ macro(CHECK_FUNCTION_EXISTS FUNCTION VARIABLE)
       OUTPUT_VARIABLE OUTPUT)
     unset(_cfe_source)
 
-    if(${VARIABLE})
-      set(${VARIABLE} 1 CACHE INTERNAL "Have function ${FUNCTION}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the function ${FUNCTION} exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have function ${FUNCTION}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the function ${FUNCTION} exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
-    endif()
+    try_compile_batch(CALL __CHECK_FUNCTION_EXISTS_RESULT
+      "${FUNCTION}" "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
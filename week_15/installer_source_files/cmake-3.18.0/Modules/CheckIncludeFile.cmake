@@ -39,10 +39,38 @@ the way the check is run:
 See the :module:`CheckIncludeFiles` module to check for multiple headers
 at once.  See the :module:`CheckIncludeFileCXX` module to check for headers
 using the ``CXX`` language.
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<variable>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_INCLUDE_FILE_RESULT INCLUDE VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${INCLUDE}")
+  endif()
+  if(${VARIABLE})
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the include file ${INCLUDE} "
+      "exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the include file ${INCLUDE} "
+      "exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endfunction()
+
 macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     if(CMAKE_REQUIRED_INCLUDES)
@@ -54,9 +82,6 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
     set(CHECK_INCLUDE_FILE_VAR ${INCLUDE})
     configure_file(${CMAKE_ROOT}/Modules/CheckIncludeFile.c.in
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.c)
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${INCLUDE}")
-    endif()
     if(${ARGC} EQUAL 3)
       set(CMAKE_C_FLAGS_SAVE ${CMAKE_C_FLAGS})
       string(APPEND CMAKE_C_FLAGS " ${ARGV2}")
@@ -90,6 +115,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       unset(_CIF_CMP0075)
     endif()
 
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.c
@@ -107,24 +133,7 @@ macro(CHECK_INCLUDE_FILE INCLUDE VARIABLE)
       set(CMAKE_C_FLAGS ${CMAKE_C_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the include file ${INCLUDE} "
-        "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the include file ${INCLUDE} "
-        "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
-    endif()
+    try_compile_batch(CALL __CHECK_INCLUDE_FILE_RESULT
+      "${INCLUDE}" "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
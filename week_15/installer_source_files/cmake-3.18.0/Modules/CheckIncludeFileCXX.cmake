@@ -38,10 +38,38 @@ the way the check is run:
 
 See modules :module:`CheckIncludeFile` and :module:`CheckIncludeFiles`
 to check for one or more ``C`` headers.
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<variable>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_INCLUDE_FILE_CXX_RESULT INCLUDE VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for C++ include ${INCLUDE}")
+  endif()
+  if(${VARIABLE})
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the include file ${INCLUDE} "
+      "exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the include file ${INCLUDE} "
+      "exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endfunction()
+
 macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
   if(NOT DEFINED "${VARIABLE}" OR "x${${VARIABLE}}" STREQUAL "x${VARIABLE}")
     if(CMAKE_REQUIRED_INCLUDES)
@@ -53,9 +81,6 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
     set(CHECK_INCLUDE_FILE_VAR ${INCLUDE})
     configure_file(${CMAKE_ROOT}/Modules/CheckIncludeFile.cxx.in
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.cxx)
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for C++ include ${INCLUDE}")
-    endif()
     if(${ARGC} EQUAL 3)
       set(CMAKE_CXX_FLAGS_SAVE ${CMAKE_CXX_FLAGS})
       string(APPEND CMAKE_CXX_FLAGS " ${ARGV2}")
@@ -89,6 +114,7 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       unset(_CIF_CMP0075)
     endif()
 
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckIncludeFile.cxx
@@ -106,24 +132,7 @@ macro(CHECK_INCLUDE_FILE_CXX INCLUDE VARIABLE)
       set(CMAKE_CXX_FLAGS ${CMAKE_CXX_FLAGS_SAVE})
     endif()
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the include file ${INCLUDE} "
-        "exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the include file ${INCLUDE} "
-        "exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
-    endif()
+    try_compile_batch(CALL __CHECK_INCLUDE_FILE_CXX_RESULT
+      "${INCLUDE}" "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
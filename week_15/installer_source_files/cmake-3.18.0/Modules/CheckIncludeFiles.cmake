@@ -44,10 +44,38 @@ the way the check is run:
 
 See modules :module:`CheckIncludeFile` and :module:`CheckIncludeFileCXX`
 to check for a single header file in ``C`` or ``CXX`` languages.
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<variable>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_INCLUDE_FILES_RESULT INCLUDE DESCRIPTION CONTENT VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${DESCRIPTION}")
+  endif()
+  if(${VARIABLE})
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if files ${INCLUDE} "
+      "exist passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have includes ${INCLUDE}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if files ${INCLUDE} "
+      "exist failed with the following output:\n"
+      "${OUTPUT}\nSource:\n${CONTENT}\n")
+  endif()
+endfunction()
+
 macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     set(CMAKE_CONFIGURABLE_FILE_CONTENT "/* */\n")
@@ -130,9 +158,7 @@ macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
       unset(_CIF_CMP0075)
     endif()
 
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${_description}")
-    endif()
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${src}
@@ -145,24 +171,8 @@ macro(CHECK_INCLUDE_FILES INCLUDE VARIABLE)
       OUTPUT_VARIABLE OUTPUT)
     unset(_CIF_LINK_OPTIONS)
     unset(_CIF_LINK_LIBRARIES)
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have include ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if files ${INCLUDE} "
-        "exist passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have includes ${INCLUDE}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if files ${INCLUDE} "
-        "exist failed with the following output:\n"
-        "${OUTPUT}\nSource:\n${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
-    endif()
+    try_compile_batch(CALL __CHECK_INCLUDE_FILES_RESULT
+      "${INCLUDE}" "${_description}" "${CMAKE_CONFIGURABLE_FILE_CONTENT}"
+      "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
@@ -33,17 +33,42 @@ the way the check is run:
   CMAKE_REQUIRED_LINK_OPTIONS = list of options to pass to link command
   CMAKE_REQUIRED_LIBRARIES = list of libraries to link
   CMAKE_REQUIRED_QUIET = execute quietly without messages
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``VARIABLE`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_LIBRARY_EXISTS_RESULT LIBRARY FUNCTION VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${FUNCTION} in ${LIBRARY}")
+  endif()
+  if(${VARIABLE})
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have library ${LIBRARY}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
+      "passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have library ${LIBRARY}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
+      "failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endfunction()
+
 macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     set(MACRO_CHECK_LIBRARY_EXISTS_DEFINITION
       "-DCHECK_FUNCTION_EXISTS=${FUNCTION} ${CMAKE_REQUIRED_FLAGS}")
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${FUNCTION} in ${LIBRARY}")
-    endif()
     set(CHECK_LIBRARY_EXISTS_LINK_OPTIONS)
     if(CMAKE_REQUIRED_LINK_OPTIONS)
       set(CHECK_LIBRARY_EXISTS_LINK_OPTIONS
@@ -64,6 +89,7 @@ macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
       message(FATAL_ERROR "CHECK_FUNCTION_EXISTS needs either C or CXX language enabled")
     endif()
 
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${_cle_source}
@@ -76,24 +102,7 @@ macro(CHECK_LIBRARY_EXISTS LIBRARY FUNCTION LOCATION VARIABLE)
       OUTPUT_VARIABLE OUTPUT)
     unset(_cle_source)
 
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have library ${LIBRARY}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
-        "passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have library ${LIBRARY}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the function ${FUNCTION} exists in the ${LIBRARY} "
-        "failed with the following output:\n"
-        "${OUTPUT}\n\n")
-    endif()
+    try_compile_batch(CALL __CHECK_LIBRARY_EXISTS_RESULT
+      "${LIBRARY}" "${FUNCTION}" "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
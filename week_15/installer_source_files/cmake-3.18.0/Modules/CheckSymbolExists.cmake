@@ -56,6 +56,9 @@ For example:
   check_symbol_exists(SEEK_SET "stdio.h" HAVE_SEEK_SET)
   # Check for function fopen
   check_symbol_exists(fopen "stdio.h" HAVE_FOPEN)
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``<variable>`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
@@ -63,6 +66,33 @@ include_guard(GLOBAL)
 cmake_policy(PUSH)
 cmake_policy(SET CMP0054 NEW) # if() quoted variables not dereferenced
 
+function(__CHECK_SYMBOL_EXISTS_RESULT SYMBOL SOURCEFILE CONTENT VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${SYMBOL}")
+  endif()
+  if(${VARIABLE})
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    set(${VARIABLE} 1 CACHE INTERNAL "Have symbol ${SYMBOL}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the ${SYMBOL} "
+      "exist passed with the following output:\n"
+      "${OUTPUT}\nFile ${SOURCEFILE}:\n"
+      "${CONTENT}\n")
+  else()
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    set(${VARIABLE} "" CACHE INTERNAL "Have symbol ${SYMBOL}")
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the ${SYMBOL} "
+      "exist failed with the following output:\n"
+      "${OUTPUT}\nFile ${SOURCEFILE}:\n"
+      "${CONTENT}\n")
+  endif()
+endfunction()
+
 macro(CHECK_SYMBOL_EXISTS SYMBOL FILES VARIABLE)
   if(CMAKE_C_COMPILER_LOADED)
     __CHECK_SYMBOL_EXISTS_IMPL("${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeTmp/CheckSymbolExists.c" "${SYMBOL}" "${FILES}" "${VARIABLE}" )
@@ -125,9 +155,7 @@ int main(int argc, char** argv)
     configure_file("${CMAKE_ROOT}/Modules/CMakeConfigurableFile.in"
       "${SOURCEFILE}" @ONLY)
 
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${SYMBOL}")
-    endif()
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       "${SOURCEFILE}"
@@ -138,27 +166,9 @@ int main(int argc, char** argv)
       -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_SYMBOL_EXISTS_FLAGS}
       "${CMAKE_SYMBOL_EXISTS_INCLUDES}"
       OUTPUT_VARIABLE OUTPUT)
-    if(${VARIABLE})
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      set(${VARIABLE} 1 CACHE INTERNAL "Have symbol ${SYMBOL}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the ${SYMBOL} "
-        "exist passed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
-        "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
-    else()
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      set(${VARIABLE} "" CACHE INTERNAL "Have symbol ${SYMBOL}")
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the ${SYMBOL} "
-        "exist failed with the following output:\n"
-        "${OUTPUT}\nFile ${SOURCEFILE}:\n"
-        "${CMAKE_CONFIGURABLE_FILE_CONTENT}\n")
-    endif()
+    try_compile_batch(CALL __CHECK_SYMBOL_EXISTS_RESULT
+      "${SYMBOL}" "${SOURCEFILE}" "${CMAKE_CONFIGURABLE_FILE_CONTENT}"
+      "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
     unset(CMAKE_CONFIGURABLE_FILE_CONTENT)
   endif()
 endmacro()
@@ -33,17 +33,40 @@ the way the check is run:
   CMAKE_REQUIRED_LINK_OPTIONS = list of options to pass to link command
   CMAKE_REQUIRED_LIBRARIES = list of libraries to link
   CMAKE_REQUIRED_QUIET = execute quietly without messages
+
+The check may be queued by :command:`try_compile_batch`, in which case
+``VARIABLE`` is set by ``try_compile_batch(END)``.
 #]=======================================================================]
 
 include_guard(GLOBAL)
 
+function(__CHECK_VARIABLE_EXISTS_RESULT VAR VARIABLE QUIET)
+  if(NOT QUIET)
+    message(CHECK_START "Looking for ${VAR}")
+  endif()
+  if(${VARIABLE})
+    set(${VARIABLE} 1 CACHE INTERNAL "Have variable ${VAR}")
+    if(NOT QUIET)
+      message(CHECK_PASS "found")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
+      "Determining if the variable ${VAR} exists passed with the following output:\n"
+      "${OUTPUT}\n\n")
+  else()
+    set(${VARIABLE} "" CACHE INTERNAL "Have variable ${VAR}")
+    if(NOT QUIET)
+      message(CHECK_FAIL "not found")
+    endif()
+    file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
+      "Determining if the variable ${VAR} exists failed with the following output:\n"
+      "${OUTPUT}\n\n")
+  endif()
+endfunction()
+
 macro(CHECK_VARIABLE_EXISTS VAR VARIABLE)
   if(NOT DEFINED "${VARIABLE}")
     set(MACRO_CHECK_VARIABLE_DEFINITIONS
       "-DCHECK_VARIABLE_EXISTS=${VAR} ${CMAKE_REQUIRED_FLAGS}")
-    if(NOT CMAKE_REQUIRED_QUIET)
-      message(CHECK_START "Looking for ${VAR}")
-    endif()
     if(CMAKE_REQUIRED_LINK_OPTIONS)
       set(CHECK_VARIABLE_EXISTS_ADD_LINK_OPTIONS
         LINK_OPTIONS ${CMAKE_REQUIRED_LINK_OPTIONS})
@@ -56,6 +79,7 @@ macro(CHECK_VARIABLE_EXISTS VAR VARIABLE)
     else()
       set(CHECK_VARIABLE_EXISTS_ADD_LIBRARIES)
     endif()
+    try_compile_batch(QUEUE)
     try_compile(${VARIABLE}
       ${CMAKE_BINARY_DIR}
       ${CMAKE_ROOT}/Modules/CheckVariableExists.c
@@ -64,22 +88,7 @@ macro(CHECK_VARIABLE_EXISTS VAR VARIABLE)
       ${CHECK_VARIABLE_EXISTS_ADD_LIBRARIES}
       CMAKE_FLAGS -DCOMPILE_DEFINITIONS:STRING=${MACRO_CHECK_VARIABLE_DEFINITIONS}
       OUTPUT_VARIABLE OUTPUT)
-    if(${VARIABLE})
-      set(${VARIABLE} 1 CACHE INTERNAL "Have variable ${VAR}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_PASS "found")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeOutput.log
-        "Determining if the variable ${VAR} exists passed with the following output:\n"
-        "${OUTPUT}\n\n")
-    else()
-      set(${VARIABLE} "" CACHE INTERNAL "Have variable ${VAR}")
-      if(NOT CMAKE_REQUIRED_QUIET)
-        message(CHECK_FAIL "not found")
-      endif()
-      file(APPEND ${CMAKE_BINARY_DIR}${CMAKE_FILES_DIRECTORY}/CMakeError.log
-        "Determining if the variable ${VAR} exists failed with the following output:\n"
-        "${OUTPUT}\n\n")
-    endif()
+    try_compile_batch(CALL __CHECK_VARIABLE_EXISTS_RESULT
+      "${VAR}" "${VARIABLE}" "${CMAKE_REQUIRED_QUIET}")
   endif()
 endmacro()
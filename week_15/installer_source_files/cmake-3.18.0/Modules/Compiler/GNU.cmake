@@ -51,6 +51,7 @@ macro(__compiler_gnu lang)
     # even though it isn't strictly necessary.
     set(CMAKE_DEPFILE_FLAGS_${lang} "-MD -MT <OBJECT> -MF <DEPFILE>")
   endif()
+  set(CMAKE_${lang}_DEPFILE_FORMAT gcc)
 
   # Initial configuration flags.
   string(APPEND CMAKE_${lang}_FLAGS_INIT " ")
@@ -98,6 +98,7 @@ void cmCTestMultiProcessHandler::SetTests(TestMap& tests,
       return;
     }
     this->CreateTestCostList();
+    this->CreateReadyQueue();
   }
 }
 
@@ -420,8 +421,10 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
 void cmCTestMultiProcessHandler::EraseTest(int test)
 {
   this->Tests.erase(test);
-  this->SortedTests.erase(
-    std::find(this->SortedTests.begin(), this->SortedTests.end(), test));
+  auto priority = this->TestPriority.find(test);
+  if (priority != this->TestPriority.end()) {
+    this->ReadyTests.erase(std::make_pair(priority->second, test));
+  }
 }
 
 inline size_t cmCTestMultiProcessHandler::GetProcessorsUsed(int test)
@@ -461,14 +464,8 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
     return false;
   }
 
-  // if there are no depends left then run this test
-  if (this->Tests[test].empty()) {
-    return this->StartTestProcess(test);
-  }
-  // This test was not able to start because it is waiting
-  // on depends to run
-  this->DeallocateResources(test);
-  return false;
+  // Only tests with no depends left are queued, so run this test
+  return this->StartTestProcess(test);
 }
 
 void cmCTestMultiProcessHandler::StartNextTests()
@@ -508,6 +505,11 @@ void cmCTestMultiProcessHandler::StartNextTests()
     return;
   }
 
+  // Tests still waiting on depends are queued when those finish.
+  if (this->ReadyTests.empty()) {
+    return;
+  }
+
   bool allTestsFailedTestLoadCheck = false;
   size_t minProcessorsRequired = this->ParallelLevel;
   std::string testWithMinProcessors;
@@ -540,8 +542,11 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
   }
 
-  TestList copy = this->SortedTests;
-  for (auto const& test : copy) {
+  for (auto it = this->ReadyTests.begin(); it != this->ReadyTests.end();) {
+    // Advance first because starting the test removes it from the queue.
+    auto const current = *it++;
+    int test = current.second;
+
     // Take a nap if we're currently performing a RUN_SERIAL test.
     if (this->SerialTestRunning) {
       break;
@@ -571,7 +576,14 @@ void cmCTestMultiProcessHandler::StartNextTests()
       testWithMinProcessors = GetName(test);
     }
 
-    if (testLoadOk && processors <= numToStart && this->StartTest(test)) {
+    bool started =
+      testLoadOk && processors <= numToStart && this->StartTest(test);
+
+    // A test that failed to start has finished and may have queued its
+    // dependents.  Resume after the current test so they are considered.
+    it = this->ReadyTests.upper_bound(current);
+
+    if (started) {
       numToStart -= processors;
     } else if (numToStart == 0) {
       break;
@@ -582,8 +594,8 @@ void cmCTestMultiProcessHandler::StartNextTests()
     // Find out whether there are any non RUN_SERIAL tests left, so that the
     // correct warning may be displayed.
     bool onlyRunSerialTestsLeft = true;
-    for (auto const& test : copy) {
-      if (!this->Properties[test]->RunSerial) {
+    for (auto const& ready : this->ReadyTests) {
+      if (!this->Properties[ready.second]->RunSerial) {
         onlyRunSerialTestsLeft = false;
       }
     }
@@ -651,9 +663,7 @@ void cmCTestMultiProcessHandler::FinishTestProcess(
     this->Failed->push_back(properties->Name);
   }
 
-  for (auto& t : this->Tests) {
-    t.second.erase(test);
-  }
+  this->ReleaseDependents(test);
 
   this->TestFinishMap[test] = true;
   this->TestRunningMap[test] = false;
@@ -900,6 +910,42 @@ void cmCTestMultiProcessHandler::CreateSerialTestCostList()
   }
 }
 
+void cmCTestMultiProcessHandler::CreateReadyQueue()
+{
+  for (size_t i = 0; i < this->SortedTests.size(); ++i) {
+    this->TestPriority[this->SortedTests[i]] = i;
+  }
+
+  for (auto const& t : this->Tests) {
+    this->PendingDependencies[t.first] = t.second.size();
+    for (int d : t.second) {
+      this->Dependents[d].insert(t.first);
+    }
+  }
+
+  for (auto const& t : this->Tests) {
+    if (t.second.empty()) {
+      this->ReadyTests.emplace(this->TestPriority[t.first], t.first);
+    }
+  }
+}
+
+void cmCTestMultiProcessHandler::ReleaseDependents(int index)
+{
+  auto dependents = this->Dependents.find(index);
+  if (dependents == this->Dependents.end()) {
+    return;
+  }
+  for (int d : dependents->second) {
+    size_t& pending = this->PendingDependencies[d];
+    if (pending > 0 && --pending == 0 &&
+        this->Tests.find(d) != this->Tests.end()) {
+      this->ReadyTests.emplace(this->TestPriority[d], d);
+    }
+  }
+  this->Dependents.erase(dependents);
+}
+
 void cmCTestMultiProcessHandler::WriteCheckpoint(int index)
 {
   std::string fname =
@@ -1386,6 +1432,7 @@ void cmCTestMultiProcessHandler::CheckResume()
 void cmCTestMultiProcessHandler::RemoveTest(int index)
 {
   this->EraseTest(index);
+  this->ReleaseDependents(index);
   this->Properties.erase(index);
   this->TestRunningMap[index] = false;
   this->TestFinishMap[index] = true;
@@ -9,6 +9,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <cm3p/uv.h>
@@ -121,6 +122,11 @@ protected:
 
   void CreateParallelTestCostList();
 
+  // Build the dependency counters and the queue of tests ready to run
+  void CreateReadyQueue();
+  // A test is no longer pending: release the tests that depend on it
+  void ReleaseDependents(int index);
+
   // Removes the checkpoint file
   void MarkFinished();
   void EraseTest(int index);
@@ -163,6 +169,15 @@ protected:
   // map from test number to set of depend tests
   TestMap Tests;
   TestList SortedTests;
+  // map from test number to its position in SortedTests
+  std::map<int, size_t> TestPriority;
+  // map from test number to set of tests depending on it
+  TestMap Dependents;
+  // map from test number to number of depend tests not yet finished
+  std::map<int, size_t> PendingDependencies;
+  // pending tests whose depends have all finished, ordered by
+  // (priority, test number) so the most important one comes first
+  std::set<std::pair<size_t, int>> ReadyTests;
   // Total number of tests we'll be running
   size_t Total;
   // Number of tests that are complete
@@ -0,0 +1,341 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmBinaryTraceWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <cm3p/json/value.h>
+#include <cm3p/json/writer.h>
+
+namespace {
+
+// The file starts with this magic followed by the format version.
+const char cmBinaryTraceMagic[] = "CMKTRACE";
+const std::size_t cmBinaryTraceMagicSize = sizeof(cmBinaryTraceMagic) - 1;
+const std::uint64_t cmBinaryTraceVersion = 1;
+
+// Record types.
+enum : unsigned char
+{
+  // Interns the next string: <size> <bytes>.
+  RecordString = 1,
+  // A traced command: <file> <line> <command> <frame> <time delta>
+  // <argument count> then <size> <bytes> for each argument.  The file and
+  // command are indexes of interned strings, and the time delta is the
+  // zigzag-encoded difference in microseconds to the previous command.
+  RecordCommand = 2
+};
+
+// Size of the ring buffer between the interpreter and the writer thread.
+const std::size_t RingSize = std::size_t(1) << 20;
+
+void WriteVarint(std::string& out, std::uint64_t value)
+{
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+std::uint64_t ZigZag(std::int64_t value)
+{
+  return (static_cast<std::uint64_t>(value) << 1) ^
+    static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t UnZigZag(std::uint64_t value)
+{
+  return static_cast<std::int64_t>(value >> 1) ^
+    -static_cast<std::int64_t>(value & 1);
+}
+
+class Reader
+{
+public:
+  Reader(std::string const& data)
+    : Cur(data.data())
+    , End(data.data() + data.size())
+  {
+  }
+
+  bool AtEnd() const { return this->Cur == this->End; }
+
+  bool ReadByte(unsigned char& value)
+  {
+    if (this->Cur == this->End) {
+      return false;
+    }
+    value = static_cast<unsigned char>(*this->Cur++);
+    return true;
+  }
+
+  bool ReadVarint(std::uint64_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+      unsigned char byte;
+      if (!this->ReadByte(byte)) {
+        return false;
+      }
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadString(std::string& value)
+  {
+    std::uint64_t size;
+    if (!this->ReadVarint(size) ||
+        size > static_cast<std::uint64_t>(this->End - this->Cur)) {
+      return false;
+    }
+    value.assign(this->Cur, static_cast<std::size_t>(size));
+    this->Cur += size;
+    return true;
+  }
+
+  bool ReadMagic()
+  {
+    if (static_cast<std::size_t>(this->End - this->Cur) <
+          cmBinaryTraceMagicSize ||
+        std::memcmp(this->Cur, cmBinaryTraceMagic, cmBinaryTraceMagicSize) !=
+          0) {
+      return false;
+    }
+    this->Cur += cmBinaryTraceMagicSize;
+    return true;
+  }
+
+private:
+  const char* Cur;
+  const char* End;
+};
+}
+
+cmBinaryTraceWriter::cmBinaryTraceWriter()
+  : Head(0)
+  , Tail(0)
+  , Done(false)
+{
+}
+
+cmBinaryTraceWriter::~cmBinaryTraceWriter()
+{
+  if (this->Writer.joinable()) {
+    this->Done.store(true, std::memory_order_release);
+    this->Writer.join();
+  }
+}
+
+bool cmBinaryTraceWriter::Open(std::string const& path)
+{
+  this->Stream.open(path.c_str(),
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!this->Stream) {
+    return false;
+  }
+  this->Stream.write(cmBinaryTraceMagic, cmBinaryTraceMagicSize);
+  std::string version;
+  WriteVarint(version, cmBinaryTraceVersion);
+  this->Stream.write(version.data(),
+                     static_cast<std::streamsize>(version.size()));
+
+  this->Ring.reset(new char[RingSize]);
+  this->Writer = std::thread(&cmBinaryTraceWriter::WriterLoop, this);
+  return true;
+}
+
+std::uint64_t cmBinaryTraceWriter::Intern(std::string const& value)
+{
+  auto it = this->Strings.find(value);
+  if (it != this->Strings.end()) {
+    return it->second;
+  }
+  std::uint64_t const index = this->Strings.size();
+  this->Strings.emplace(value, index);
+  this->Record += static_cast<char>(RecordString);
+  WriteVarint(this->Record, value.size());
+  this->Record += value;
+  return index;
+}
+
+void cmBinaryTraceWriter::BeginCommand(std::string const& file, long line,
+                                       std::string const& command,
+                                       double time, std::size_t frame,
+                                       std::size_t numArgs)
+{
+  this->Record.clear();
+  std::uint64_t const fileIndex = this->Intern(file);
+  std::uint64_t const commandIndex = this->Intern(command);
+  std::int64_t const micros = std::llround(time * 1e6);
+
+  this->Record += static_cast<char>(RecordCommand);
+  WriteVarint(this->Record, fileIndex);
+  WriteVarint(this->Record, static_cast<std::uint64_t>(line));
+  WriteVarint(this->Record, commandIndex);
+  WriteVarint(this->Record, frame);
+  WriteVarint(this->Record, ZigZag(micros - this->LastTime));
+  WriteVarint(this->Record, numArgs);
+  this->LastTime = micros;
+}
+
+void cmBinaryTraceWriter::AddArgument(cm::string_view arg)
+{
+  WriteVarint(this->Record, arg.size());
+  this->Record.append(arg.data(), arg.size());
+}
+
+void cmBinaryTraceWriter::EndCommand()
+{
+  this->Push(this->Record.data(), this->Record.size());
+}
+
+void cmBinaryTraceWriter::Push(const char* data, std::size_t size)
+{
+  while (size > 0) {
+    std::size_t const head = this->Head.load(std::memory_order_relaxed);
+    std::size_t const tail = this->Tail.load(std::memory_order_acquire);
+    std::size_t const space = RingSize - (head - tail);
+    if (space == 0) {
+      // The writer thread is behind; let it catch up.
+      std::this_thread::yield();
+      continue;
+    }
+    std::size_t const offset = head % RingSize;
+    std::size_t const chunk = std::min({ size, space, RingSize - offset });
+    std::memcpy(this->Ring.get() + offset, data, chunk);
+    this->Head.store(head + chunk, std::memory_order_release);
+    data += chunk;
+    size -= chunk;
+  }
+}
+
+void cmBinaryTraceWriter::WriterLoop()
+{
+  for (;;) {
+    // Read Done before Head so that everything pushed before the
+    // destructor set it is seen below.
+    bool const done = this->Done.load(std::memory_order_acquire);
+    std::size_t const tail = this->Tail.load(std::memory_order_relaxed);
+    std::size_t const head = this->Head.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (done) {
+        break;
+      }
+      this->Stream.flush();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    std::size_t const offset = tail % RingSize;
+    std::size_t const chunk = std::min(head - tail, RingSize - offset);
+    this->Stream.write(this->Ring.get() + offset,
+                       static_cast<std::streamsize>(chunk));
+    this->Tail.store(tail + chunk, std::memory_order_release);
+  }
+  this->Stream.close();
+}
+
+bool cmBinaryTraceWriter::ConvertToJson(std::string const& path,
+                                        std::ostream& os, std::string& error)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::string const data((std::istreambuf_iterator<char>(fin)),
+                         std::istreambuf_iterator<char>());
+
+  Reader reader(data);
+  std::uint64_t version;
+  if (!reader.ReadMagic() || !reader.ReadVarint(version)) {
+    error = path + " is not a binary trace file";
+    return false;
+  }
+  if (version != cmBinaryTraceVersion) {
+    error = path + " has unsupported binary trace version " +
+      std::to_string(version);
+    return false;
+  }
+
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  {
+    Json::Value val;
+    val["version"]["major"] = 1;
+    val["version"]["minor"] = 0;
+    os << Json::writeString(builder, val) << '\n';
+  }
+
+  std::vector<std::string> strings;
+  std::int64_t time = 0;
+  bool truncated = false;
+  while (!reader.AtEnd()) {
+    unsigned char type;
+    reader.ReadByte(type);
+    if (type == RecordString) {
+      std::string value;
+      if (!reader.ReadString(value)) {
+        truncated = true;
+        break;
+      }
+      strings.push_back(std::move(value));
+      continue;
+    }
+    if (type != RecordCommand) {
+      error = path + " contains an unknown record type";
+      return false;
+    }
+
+    std::uint64_t file;
+    std::uint64_t line;
+    std::uint64_t command;
+    std::uint64_t frame;
+    std::uint64_t delta;
+    std::uint64_t numArgs;
+    if (!reader.ReadVarint(file) || !reader.ReadVarint(line) ||
+        !reader.ReadVarint(command) || !reader.ReadVarint(frame) ||
+        !reader.ReadVarint(delta) || !reader.ReadVarint(numArgs)) {
+      truncated = true;
+      break;
+    }
+    if (file >= strings.size() || command >= strings.size()) {
+      error = path + " refers to an unknown string";
+      return false;
+    }
+    Json::Value val;
+    val["file"] = strings[file];
+    val["line"] = static_cast<Json::Value::Int64>(line);
+    val["cmd"] = strings[command];
+    val["args"] = Json::Value(Json::arrayValue);
+    std::string arg;
+    for (std::uint64_t i = 0; !truncated && i < numArgs; ++i) {
+      truncated = !reader.ReadString(arg);
+      val["args"].append(arg);
+    }
+    if (truncated) {
+      break;
+    }
+    time += UnZigZag(delta);
+    val["time"] = static_cast<double>(time) / 1e6;
+    val["frame"] = static_cast<Json::Value::UInt64>(frame);
+    os << Json::writeString(builder, val) << '\n';
+  }
+
+  if (truncated) {
+    error = path + " is truncated";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,80 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmBinaryTraceWriter_h
+#define cmBinaryTraceWriter_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <cm/string_view>
+
+#include "cmsys/FStream.hxx"
+
+/** \class cmBinaryTraceWriter
+ * \brief Writes the binary-v1 trace format from a background thread.
+ *
+ * Each traced command is encoded on the interpreter thread into a compact
+ * record: file paths and command names are interned and referred to by
+ * index, and integers are stored as varints.  The records are handed to a
+ * writer thread through a single-producer, single-consumer ring buffer so
+ * that the interpreter never waits on file I/O unless the buffer is full.
+ *
+ * Use ConvertToJson to turn a binary trace into the json-v1 format.
+ */
+class cmBinaryTraceWriter
+{
+public:
+  cmBinaryTraceWriter();
+  ~cmBinaryTraceWriter();
+
+  cmBinaryTraceWriter(cmBinaryTraceWriter const&) = delete;
+  cmBinaryTraceWriter& operator=(cmBinaryTraceWriter const&) = delete;
+
+  /** Open the trace file and start the writer thread.  */
+  bool Open(std::string const& path);
+
+  /** Record one traced command.  BeginCommand must be followed by exactly
+      numArgs calls to AddArgument and then by EndCommand.  */
+  void BeginCommand(std::string const& file, long line,
+                    std::string const& command, double time,
+                    std::size_t frame, std::size_t numArgs);
+  void AddArgument(cm::string_view arg);
+  void EndCommand();
+
+  /** Convert the binary trace in the given file to json-v1 documents.
+      On failure the documents of all complete records are still written
+      and a description of the problem is stored in error.  */
+  static bool ConvertToJson(std::string const& path, std::ostream& os,
+                            std::string& error);
+
+private:
+  std::uint64_t Intern(std::string const& value);
+  void Push(const char* data, std::size_t size);
+  void WriterLoop();
+
+  cmsys::ofstream Stream;
+  std::thread Writer;
+
+  // Ring buffer shared with the writer thread.  Head and Tail count bytes
+  // ever written and read; only the interpreter thread advances Head and
+  // only the writer thread advances Tail.
+  std::unique_ptr<char[]> Ring;
+  std::atomic<std::size_t> Head;
+  std::atomic<std::size_t> Tail;
+  std::atomic<bool> Done;
+
+  // Encoder state, only used by the interpreter thread.
+  std::string Record;
+  std::unordered_map<std::string, std::uint64_t> Strings;
+  std::int64_t LastTime = 0;
+};
+
+#endif
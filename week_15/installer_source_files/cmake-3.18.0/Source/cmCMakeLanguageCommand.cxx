@@ -128,7 +128,7 @@ bool cmCMakeLanguageCommand(std::vector<cmListFileArgument> const& args,
     const std::string code =
       cmJoin(cmMakeRange(expandedArgs.begin() + 2, expandedArgs.end()), " ");
     result = makefile.ReadListFileAsString(
-      code, cmStrCat(context.FilePath, ":", context.Line, ":EVAL"));
+      code, cmStrCat(context.FilePath.str(), ":", context.Line, ":EVAL"));
   } else {
     status.SetError("called with unknown meta-operation");
   }
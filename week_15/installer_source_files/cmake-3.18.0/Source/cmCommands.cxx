@@ -81,6 +81,7 @@
 #include "cmTargetLinkOptionsCommand.h"
 #include "cmTargetPrecompileHeadersCommand.h"
 #include "cmTargetSourcesCommand.h"
+#include "cmTryCompileBatchCommand.h"
 #include "cmTryCompileCommand.h"
 #include "cmTryRunCommand.h"
 #include "cmUnsetCommand.h"
@@ -263,6 +264,8 @@ void GetProjectCommands(cmState* state)
   state->AddBuiltinCommand("target_sources", cmTargetSourcesCommand);
   state->AddBuiltinCommand("try_compile",
                            cm::make_unique<cmTryCompileCommand>());
+  state->AddBuiltinCommand("try_compile_batch",
+                           cm::make_unique<cmTryCompileBatchCommand>());
   state->AddBuiltinCommand("try_run", cm::make_unique<cmTryRunCommand>());
   state->AddBuiltinCommand("target_precompile_headers",
                            cmTargetPrecompileHeadersCommand);
@@ -356,6 +359,7 @@ void GetProjectCommandsInScriptMode(cmState* state)
   CM_UNEXPECTED_PROJECT_COMMAND("target_link_libraries");
   CM_UNEXPECTED_PROJECT_COMMAND("target_sources");
   CM_UNEXPECTED_PROJECT_COMMAND("try_compile");
+  CM_UNEXPECTED_PROJECT_COMMAND("try_compile_batch");
   CM_UNEXPECTED_PROJECT_COMMAND("try_run");
 
   // deprecated commands
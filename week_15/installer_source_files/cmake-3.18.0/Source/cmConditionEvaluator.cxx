@@ -6,7 +6,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #include <cmext/algorithm>
@@ -15,6 +17,7 @@
 
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#include "cmRegularExpressionCache.h"
 #include "cmState.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
@@ -55,6 +58,605 @@ static std::string const keyVERSION_GREATER_EQUAL = "VERSION_GREATER_EQUAL";
 static std::string const keyVERSION_LESS = "VERSION_LESS";
 static std::string const keyVERSION_LESS_EQUAL = "VERSION_LESS_EQUAL";
 
+namespace {
+enum class Keyword
+{
+  None,
+  AND,
+  COMMAND,
+  DEFINED,
+  EQUAL,
+  EXISTS,
+  GREATER,
+  GREATER_EQUAL,
+  IN_LIST,
+  IS_ABSOLUTE,
+  IS_DIRECTORY,
+  IS_NEWER_THAN,
+  IS_SYMLINK,
+  LESS,
+  LESS_EQUAL,
+  MATCHES,
+  NOT,
+  OR,
+  ParenL,
+  ParenR,
+  POLICY,
+  STREQUAL,
+  STRGREATER,
+  STRGREATER_EQUAL,
+  STRLESS,
+  STRLESS_EQUAL,
+  TARGET,
+  TEST,
+  VERSION_EQUAL,
+  VERSION_GREATER,
+  VERSION_GREATER_EQUAL,
+  VERSION_LESS,
+  VERSION_LESS_EQUAL
+};
+
+Keyword LookupKeyword(std::string const& value)
+{
+  static std::unordered_map<std::string, Keyword> const keywords = {
+    { keyAND, Keyword::AND },
+    { keyCOMMAND, Keyword::COMMAND },
+    { keyDEFINED, Keyword::DEFINED },
+    { keyEQUAL, Keyword::EQUAL },
+    { keyEXISTS, Keyword::EXISTS },
+    { keyGREATER, Keyword::GREATER },
+    { keyGREATER_EQUAL, Keyword::GREATER_EQUAL },
+    { keyIN_LIST, Keyword::IN_LIST },
+    { keyIS_ABSOLUTE, Keyword::IS_ABSOLUTE },
+    { keyIS_DIRECTORY, Keyword::IS_DIRECTORY },
+    { keyIS_NEWER_THAN, Keyword::IS_NEWER_THAN },
+    { keyIS_SYMLINK, Keyword::IS_SYMLINK },
+    { keyLESS, Keyword::LESS },
+    { keyLESS_EQUAL, Keyword::LESS_EQUAL },
+    { keyMATCHES, Keyword::MATCHES },
+    { keyNOT, Keyword::NOT },
+    { keyOR, Keyword::OR },
+    { keyParenL, Keyword::ParenL },
+    { keyParenR, Keyword::ParenR },
+    { keyPOLICY, Keyword::POLICY },
+    { keySTREQUAL, Keyword::STREQUAL },
+    { keySTRGREATER, Keyword::STRGREATER },
+    { keySTRGREATER_EQUAL, Keyword::STRGREATER_EQUAL },
+    { keySTRLESS, Keyword::STRLESS },
+    { keySTRLESS_EQUAL, Keyword::STRLESS_EQUAL },
+    { keyTARGET, Keyword::TARGET },
+    { keyTEST, Keyword::TEST },
+    { keyVERSION_EQUAL, Keyword::VERSION_EQUAL },
+    { keyVERSION_GREATER, Keyword::VERSION_GREATER },
+    { keyVERSION_GREATER_EQUAL, Keyword::VERSION_GREATER_EQUAL },
+    { keyVERSION_LESS, Keyword::VERSION_LESS },
+    { keyVERSION_LESS_EQUAL, Keyword::VERSION_LESS_EQUAL },
+  };
+  // All keywords are upper case words or parentheses.
+  if (value.empty() ||
+      !((value[0] >= 'A' && value[0] <= 'Z') || value[0] == '(' ||
+        value[0] == ')')) {
+    return Keyword::None;
+  }
+  auto it = keywords.find(value);
+  return it != keywords.end() ? it->second : Keyword::None;
+}
+
+cmSystemTools::CompareOp CompareOpFor(Keyword keyword)
+{
+  switch (keyword) {
+    case Keyword::LESS:
+    case Keyword::STRLESS:
+    case Keyword::VERSION_LESS:
+      return cmSystemTools::OP_LESS;
+    case Keyword::LESS_EQUAL:
+    case Keyword::STRLESS_EQUAL:
+    case Keyword::VERSION_LESS_EQUAL:
+      return cmSystemTools::OP_LESS_EQUAL;
+    case Keyword::GREATER:
+    case Keyword::STRGREATER:
+    case Keyword::VERSION_GREATER:
+      return cmSystemTools::OP_GREATER;
+    case Keyword::GREATER_EQUAL:
+    case Keyword::STRGREATER_EQUAL:
+    case Keyword::VERSION_GREATER_EQUAL:
+      return cmSystemTools::OP_GREATER_EQUAL;
+    default:
+      return cmSystemTools::OP_EQUAL;
+  }
+}
+
+cmSystemTools::CompareOp CompareOpForKeyword(std::string const& value)
+{
+  return CompareOpFor(LookupKeyword(value));
+}
+
+bool IsNumericCompare(Keyword keyword)
+{
+  return keyword == Keyword::LESS || keyword == Keyword::LESS_EQUAL ||
+    keyword == Keyword::GREATER || keyword == Keyword::GREATER_EQUAL ||
+    keyword == Keyword::EQUAL;
+}
+
+bool IsStringCompare(Keyword keyword)
+{
+  return keyword == Keyword::STRLESS || keyword == Keyword::STRLESS_EQUAL ||
+    keyword == Keyword::STRGREATER || keyword == Keyword::STRGREATER_EQUAL ||
+    keyword == Keyword::STREQUAL;
+}
+
+bool IsVersionCompare(Keyword keyword)
+{
+  return keyword == Keyword::VERSION_LESS ||
+    keyword == Keyword::VERSION_LESS_EQUAL ||
+    keyword == Keyword::VERSION_GREATER ||
+    keyword == Keyword::VERSION_GREATER_EQUAL ||
+    keyword == Keyword::VERSION_EQUAL;
+}
+
+bool IsNewerThan(cmExpandedCommandArgument const& lhs,
+                 cmExpandedCommandArgument const& rhs)
+{
+  int fileIsNewer = 0;
+  bool success = cmSystemTools::FileTimeCompare(lhs.GetValue(), rhs.GetValue(),
+                                                &fileIsNewer);
+  return !success || fileIsNewer == 1 || fileIsNewer == 0;
+}
+}
+
+/** \class cmCompiledCondition
+ * \brief A condition reduced to the operations IsTrue would perform.
+ *
+ * The order in which IsTrue reduces its arguments only depends on which
+ * arguments are keywords, never on the values of the others.  The compiled
+ * form records that order once as a sequence of steps per parenthesized
+ * group, each combining argument or earlier result slots into a new
+ * result slot.  Evaluating it then only has to look at the values.
+ */
+class cmCompiledCondition
+{
+public:
+  enum class Op
+  {
+    Exists,
+    IsDirectory,
+    IsSymlink,
+    IsAbsolute,
+    Command,
+    Policy,
+    Target,
+    Test,
+    Defined,
+    Matches,
+    MatchesNothing,
+    CompareNumbers,
+    CompareStrings,
+    CompareVersions,
+    IsNewerThan,
+    InList,
+    Not,
+    And,
+    Or,
+    Group
+  };
+
+  struct Step
+  {
+    Op Code;
+    cmSystemTools::CompareOp Compare;
+    // Argument or result slots, or the program index for Op::Group.
+    std::size_t Lhs;
+    std::size_t Rhs;
+    std::size_t Result;
+  };
+
+  enum class Finish
+  {
+    Empty,
+    Result,
+    MismatchedParenthesis,
+    UnknownArguments
+  };
+
+  struct Program
+  {
+    std::vector<Step> Steps;
+    Finish End = Finish::Empty;
+    std::size_t Result = 0;
+  };
+
+  cmCompiledCondition(std::vector<cmExpandedCommandArgument> const& args,
+                      cmPolicies::PolicyStatus policy54,
+                      cmPolicies::PolicyStatus policy57,
+                      cmPolicies::PolicyStatus policy64);
+
+  bool IsCompiledFor(std::vector<cmExpandedCommandArgument> const& args,
+                     cmPolicies::PolicyStatus policy54,
+                     cmPolicies::PolicyStatus policy57,
+                     cmPolicies::PolicyStatus policy64) const;
+
+  static Keyword GetKeyword(cmExpandedCommandArgument const& arg,
+                            cmPolicies::PolicyStatus policy54)
+  {
+    if (arg.WasQuoted() && policy54 != cmPolicies::OLD) {
+      return Keyword::None;
+    }
+    return LookupKeyword(arg.GetValue());
+  }
+
+  cmPolicies::PolicyStatus Policy54Status;
+  cmPolicies::PolicyStatus Policy57Status;
+  cmPolicies::PolicyStatus Policy64Status;
+  std::vector<Keyword> Keywords;
+
+  // False if evaluating the condition may warn about a policy, which
+  // only the uncompiled evaluation does at the right moments.
+  bool Compiled = false;
+  std::size_t NumberOfTemporaries = 0;
+  // The whole condition is the first program.
+  std::vector<Program> Programs;
+
+private:
+  struct Item
+  {
+    std::size_t Slot;
+    Keyword Key;
+  };
+  using ItemList = std::list<Item>;
+
+  bool Compile(ItemList items, std::size_t& program);
+  bool CompileLevel0(ItemList& items, std::size_t program, bool& done);
+  bool CompileLevel1(ItemList& items, std::size_t program);
+  bool CompileLevel2(ItemList& items, std::size_t program);
+  void CompileLevel3(ItemList& items, std::size_t program);
+  void CompileLevel4(ItemList& items, std::size_t program);
+
+  std::size_t AddStep(std::size_t program, Op code, std::size_t lhs,
+                      std::size_t rhs = 0,
+                      cmSystemTools::CompareOp compare =
+                        cmSystemTools::OP_EQUAL);
+  static void IncrementItems(ItemList& items, ItemList::iterator& argP1,
+                             ItemList::iterator& argP2);
+  void AddPredicate(std::size_t program, Op code, int& reducible,
+                    ItemList::iterator& arg, ItemList& items,
+                    ItemList::iterator& argP1, ItemList::iterator& argP2);
+  void AddBinaryOp(std::size_t program, Op code,
+                   cmSystemTools::CompareOp compare, int& reducible,
+                   ItemList::iterator& arg, ItemList& items,
+                   ItemList::iterator& argP1, ItemList::iterator& argP2);
+};
+
+cmCompiledCondition::cmCompiledCondition(
+  std::vector<cmExpandedCommandArgument> const& args,
+  cmPolicies::PolicyStatus policy54, cmPolicies::PolicyStatus policy57,
+  cmPolicies::PolicyStatus policy64)
+  : Policy54Status(policy54)
+  , Policy57Status(policy57)
+  , Policy64Status(policy64)
+{
+  ItemList items;
+  this->Keywords.reserve(args.size());
+  for (cmExpandedCommandArgument const& arg : args) {
+    Keyword key = GetKeyword(arg, policy54);
+    items.push_back({ this->Keywords.size(), key });
+    this->Keywords.push_back(key);
+  }
+  std::size_t program;
+  this->Compiled = this->Compile(std::move(items), program);
+  if (!this->Compiled) {
+    this->Programs.clear();
+  }
+}
+
+bool cmCompiledCondition::IsCompiledFor(
+  std::vector<cmExpandedCommandArgument> const& args,
+  cmPolicies::PolicyStatus policy54, cmPolicies::PolicyStatus policy57,
+  cmPolicies::PolicyStatus policy64) const
+{
+  if (this->Policy54Status != policy54 || this->Policy57Status != policy57 ||
+      this->Policy64Status != policy64 ||
+      this->Keywords.size() != args.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    if (this->Keywords[i] != GetKeyword(args[i], policy54)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::size_t cmCompiledCondition::AddStep(std::size_t program, Op code,
+                                         std::size_t lhs, std::size_t rhs,
+                                         cmSystemTools::CompareOp compare)
+{
+  std::size_t result = this->Keywords.size() + this->NumberOfTemporaries++;
+  this->Programs[program].Steps.push_back({ code, compare, lhs, rhs, result });
+  return result;
+}
+
+void cmCompiledCondition::IncrementItems(ItemList& items,
+                                         ItemList::iterator& argP1,
+                                         ItemList::iterator& argP2)
+{
+  if (argP1 != items.end()) {
+    argP1++;
+    argP2 = argP1;
+    if (argP1 != items.end()) {
+      argP2++;
+    }
+  }
+}
+
+void cmCompiledCondition::AddPredicate(std::size_t program, Op code,
+                                       int& reducible,
+                                       ItemList::iterator& arg,
+                                       ItemList& items,
+                                       ItemList::iterator& argP1,
+                                       ItemList::iterator& argP2)
+{
+  *arg = { this->AddStep(program, code, argP1->Slot), Keyword::None };
+  items.erase(argP1);
+  argP1 = arg;
+  IncrementItems(items, argP1, argP2);
+  reducible = 1;
+}
+
+void cmCompiledCondition::AddBinaryOp(std::size_t program, Op code,
+                                      cmSystemTools::CompareOp compare,
+                                      int& reducible, ItemList::iterator& arg,
+                                      ItemList& items,
+                                      ItemList::iterator& argP1,
+                                      ItemList::iterator& argP2)
+{
+  *arg = { this->AddStep(program, code, arg->Slot, argP2->Slot, compare),
+           Keyword::None };
+  items.erase(argP2);
+  items.erase(argP1);
+  argP1 = arg;
+  IncrementItems(items, argP1, argP2);
+  reducible = 1;
+}
+
+// The CompileLevel methods mirror the HandleLevel methods of
+// cmConditionEvaluator, but record steps instead of evaluating them.
+bool cmCompiledCondition::Compile(ItemList items, std::size_t& program)
+{
+  program = this->Programs.size();
+  this->Programs.emplace_back();
+  if (items.empty()) {
+    return true;
+  }
+
+  bool done = false;
+  if (!this->CompileLevel0(items, program, done)) {
+    return false;
+  }
+  if (done) {
+    return true;
+  }
+  if (!this->CompileLevel1(items, program) ||
+      !this->CompileLevel2(items, program)) {
+    return false;
+  }
+  this->CompileLevel3(items, program);
+  this->CompileLevel4(items, program);
+
+  Program& p = this->Programs[program];
+  if (items.size() != 1) {
+    p.End = Finish::UnknownArguments;
+  } else {
+    p.End = Finish::Result;
+    p.Result = items.front().Slot;
+  }
+  return true;
+}
+
+bool cmCompiledCondition::CompileLevel0(ItemList& items, std::size_t program,
+                                        bool& done)
+{
+  auto arg = items.begin();
+  while (arg != items.end()) {
+    if (arg->Key == Keyword::ParenL) {
+      auto argClose = arg;
+      argClose++;
+      unsigned int depth = 1;
+      while (argClose != items.end() && depth) {
+        if (argClose->Key == Keyword::ParenL) {
+          depth++;
+        }
+        if (argClose->Key == Keyword::ParenR) {
+          depth--;
+        }
+        argClose++;
+      }
+      if (depth) {
+        this->Programs[program].End = Finish::MismatchedParenthesis;
+        done = true;
+        return true;
+      }
+      auto argP1 = arg;
+      argP1++;
+      ItemList inner(argP1, argClose);
+      inner.pop_back();
+      std::size_t group;
+      if (!this->Compile(std::move(inner), group)) {
+        return false;
+      }
+      *arg = { this->AddStep(program, Op::Group, group), Keyword::None };
+      argP1 = arg;
+      argP1++;
+      items.erase(argP1, argClose);
+    }
+    ++arg;
+  }
+  return true;
+}
+
+bool cmCompiledCondition::CompileLevel1(ItemList& items, std::size_t program)
+{
+  // In the order HandleLevel1 checks them.
+  static std::pair<Keyword, Op> const predicates[] = {
+    { Keyword::EXISTS, Op::Exists },
+    { Keyword::IS_DIRECTORY, Op::IsDirectory },
+    { Keyword::IS_SYMLINK, Op::IsSymlink },
+    { Keyword::IS_ABSOLUTE, Op::IsAbsolute },
+    { Keyword::COMMAND, Op::Command },
+    { Keyword::POLICY, Op::Policy },
+    { Keyword::TARGET, Op::Target },
+  };
+  int reducible;
+  do {
+    reducible = 0;
+    auto arg = items.begin();
+    ItemList::iterator argP1;
+    ItemList::iterator argP2;
+    while (arg != items.end()) {
+      argP1 = arg;
+      IncrementItems(items, argP1, argP2);
+      for (auto const& predicate : predicates) {
+        if (arg->Key == predicate.first && argP1 != items.end()) {
+          this->AddPredicate(program, predicate.second, reducible, arg, items,
+                             argP1, argP2);
+        }
+      }
+      if (this->Policy64Status != cmPolicies::OLD &&
+          this->Policy64Status != cmPolicies::WARN) {
+        if (arg->Key == Keyword::TEST && argP1 != items.end()) {
+          this->AddPredicate(program, Op::Test, reducible, arg, items, argP1,
+                             argP2);
+        }
+      } else if (this->Policy64Status == cmPolicies::WARN &&
+                 arg->Key == Keyword::TEST) {
+        return false;
+      }
+      if (arg->Key == Keyword::DEFINED && argP1 != items.end()) {
+        this->AddPredicate(program, Op::Defined, reducible, arg, items, argP1,
+                           argP2);
+      }
+      ++arg;
+    }
+  } while (reducible);
+  return true;
+}
+
+bool cmCompiledCondition::CompileLevel2(ItemList& items, std::size_t program)
+{
+  int reducible;
+  do {
+    reducible = 0;
+    auto arg = items.begin();
+    ItemList::iterator argP1;
+    ItemList::iterator argP2;
+    while (arg != items.end()) {
+      argP1 = arg;
+      IncrementItems(items, argP1, argP2);
+      if (argP1 != items.end() && argP2 != items.end() &&
+          argP1->Key == Keyword::MATCHES) {
+        this->AddBinaryOp(program, Op::Matches, cmSystemTools::OP_EQUAL,
+                          reducible, arg, items, argP1, argP2);
+      }
+
+      if (argP1 != items.end() && arg->Key == Keyword::MATCHES) {
+        *arg = { this->AddStep(program, Op::MatchesNothing, 0),
+                 Keyword::None };
+        items.erase(argP1);
+        argP1 = arg;
+        IncrementItems(items, argP1, argP2);
+        reducible = 1;
+      }
+
+      if (argP1 != items.end() && argP2 != items.end() &&
+          IsNumericCompare(argP1->Key)) {
+        this->AddBinaryOp(program, Op::CompareNumbers,
+                          CompareOpFor(argP1->Key), reducible, arg, items,
+                          argP1, argP2);
+      }
+
+      if (argP1 != items.end() && argP2 != items.end() &&
+          IsStringCompare(argP1->Key)) {
+        this->AddBinaryOp(program, Op::CompareStrings,
+                          CompareOpFor(argP1->Key), reducible, arg, items,
+                          argP1, argP2);
+      }
+
+      if (argP1 != items.end() && argP2 != items.end() &&
+          IsVersionCompare(argP1->Key)) {
+        this->AddBinaryOp(program, Op::CompareVersions,
+                          CompareOpFor(argP1->Key), reducible, arg, items,
+                          argP1, argP2);
+      }
+
+      if (argP1 != items.end() && argP2 != items.end() &&
+          argP1->Key == Keyword::IS_NEWER_THAN) {
+        this->AddBinaryOp(program, Op::IsNewerThan, cmSystemTools::OP_EQUAL,
+                          reducible, arg, items, argP1, argP2);
+      }
+
+      if (argP1 != items.end() && argP2 != items.end() &&
+          argP1->Key == Keyword::IN_LIST) {
+        if (this->Policy57Status != cmPolicies::OLD &&
+            this->Policy57Status != cmPolicies::WARN) {
+          this->AddBinaryOp(program, Op::InList, cmSystemTools::OP_EQUAL,
+                            reducible, arg, items, argP1, argP2);
+        } else if (this->Policy57Status == cmPolicies::WARN) {
+          return false;
+        }
+      }
+
+      ++arg;
+    }
+  } while (reducible);
+  return true;
+}
+
+void cmCompiledCondition::CompileLevel3(ItemList& items, std::size_t program)
+{
+  int reducible;
+  do {
+    reducible = 0;
+    auto arg = items.begin();
+    ItemList::iterator argP1;
+    ItemList::iterator argP2;
+    while (arg != items.end()) {
+      argP1 = arg;
+      IncrementItems(items, argP1, argP2);
+      if (argP1 != items.end() && arg->Key == Keyword::NOT) {
+        this->AddPredicate(program, Op::Not, reducible, arg, items, argP1,
+                           argP2);
+      }
+      ++arg;
+    }
+  } while (reducible);
+}
+
+void cmCompiledCondition::CompileLevel4(ItemList& items, std::size_t program)
+{
+  int reducible;
+  do {
+    reducible = 0;
+    auto arg = items.begin();
+    ItemList::iterator argP1;
+    ItemList::iterator argP2;
+    while (arg != items.end()) {
+      argP1 = arg;
+      IncrementItems(items, argP1, argP2);
+      if (argP1 != items.end() && argP1->Key == Keyword::AND &&
+          argP2 != items.end()) {
+        this->AddBinaryOp(program, Op::And, cmSystemTools::OP_EQUAL,
+                          reducible, arg, items, argP1, argP2);
+      }
+
+      if (argP1 != items.end() && argP1->Key == Keyword::OR &&
+          argP2 != items.end()) {
+        this->AddBinaryOp(program, Op::Or, cmSystemTools::OP_EQUAL,
+                          reducible, arg, items, argP1, argP2);
+      }
+      ++arg;
+    }
+  } while (reducible);
+}
+
 cmConditionEvaluator::cmConditionEvaluator(cmMakefile& makefile,
                                            cmListFileContext context,
                                            cmListFileBacktrace bt)
@@ -133,6 +735,159 @@ bool cmConditionEvaluator::IsTrue(
                                                   status, true);
 }
 
+bool cmConditionEvaluator::IsTrue(
+  const std::vector<cmExpandedCommandArgument>& args, std::string& errorString,
+  MessageType& status, const std::vector<cmListFileArgument>& unexpandedArgs)
+{
+  // There is nowhere to cache a condition without arguments, and quoted
+  // arguments may warn about CMP0054 whenever they are looked at.
+  if (unexpandedArgs.empty() || this->Policy54Status == cmPolicies::WARN) {
+    return this->IsTrue(args, errorString, status);
+  }
+
+  std::shared_ptr<cmCompiledCondition const>& cache =
+    unexpandedArgs.front().Cache->Condition;
+  if (!cache ||
+      !cache->IsCompiledFor(args, this->Policy54Status, this->Policy57Status,
+                            this->Policy64Status)) {
+    cache = std::make_shared<cmCompiledCondition const>(
+      args, this->Policy54Status, this->Policy57Status, this->Policy64Status);
+  }
+  cmCompiledCondition const& condition = *cache;
+  if (!condition.Compiled) {
+    return this->IsTrue(args, errorString, status);
+  }
+
+  std::vector<cmExpandedCommandArgument> temps(
+    condition.NumberOfTemporaries);
+  return this->EvaluateCompiled(condition, 0, args, temps, errorString,
+                                status);
+}
+
+bool cmConditionEvaluator::EvaluateCompiled(
+  cmCompiledCondition const& condition, std::size_t program,
+  const std::vector<cmExpandedCommandArgument>& args,
+  std::vector<cmExpandedCommandArgument>& temps, std::string& errorString,
+  MessageType& status)
+{
+  using Op = cmCompiledCondition::Op;
+  using Finish = cmCompiledCondition::Finish;
+
+  errorString.clear();
+
+  auto slot = [&args, &temps](std::size_t index)
+    -> cmExpandedCommandArgument const& {
+    return index < args.size() ? args[index] : temps[index - args.size()];
+  };
+
+  cmCompiledCondition::Program const& p = condition.Programs[program];
+  if (p.End == Finish::Empty) {
+    return false;
+  }
+
+  for (cmCompiledCondition::Step const& step : p.Steps) {
+    bool value = false;
+    switch (step.Code) {
+      case Op::Exists:
+        value = cmSystemTools::FileExists(slot(step.Lhs).c_str());
+        break;
+      case Op::IsDirectory:
+        value = cmSystemTools::FileIsDirectory(slot(step.Lhs).c_str());
+        break;
+      case Op::IsSymlink:
+        value = cmSystemTools::FileIsSymlink(slot(step.Lhs).c_str());
+        break;
+      case Op::IsAbsolute:
+        value = cmSystemTools::FileIsFullPath(slot(step.Lhs).c_str());
+        break;
+      case Op::Command:
+        value = this->Makefile.GetState()->GetCommand(
+                  slot(step.Lhs).GetValue()) != nullptr;
+        break;
+      case Op::Policy: {
+        cmPolicies::PolicyID pid;
+        value = cmPolicies::GetPolicyID(slot(step.Lhs).c_str(), pid);
+      } break;
+      case Op::Target:
+        value = this->Makefile.FindTargetToUse(slot(step.Lhs).GetValue()) !=
+          nullptr;
+        break;
+      case Op::Test:
+        value = this->Makefile.GetTest(slot(step.Lhs).c_str()) != nullptr;
+        break;
+      case Op::Defined:
+        value = this->IsDefined(slot(step.Lhs).GetValue());
+        break;
+      case Op::Matches:
+        if (!this->Matches(slot(step.Lhs), slot(step.Rhs).GetValue(), value,
+                           errorString, status)) {
+          return false;
+        }
+        break;
+      case Op::MatchesNothing:
+        break;
+      case Op::CompareNumbers:
+        value =
+          this->CompareNumbers(slot(step.Lhs), step.Compare, slot(step.Rhs));
+        break;
+      case Op::CompareStrings:
+        value =
+          this->CompareStrings(slot(step.Lhs), step.Compare, slot(step.Rhs));
+        break;
+      case Op::CompareVersions:
+        value =
+          this->CompareVersions(slot(step.Lhs), step.Compare, slot(step.Rhs));
+        break;
+      case Op::IsNewerThan:
+        value = IsNewerThan(slot(step.Lhs), slot(step.Rhs));
+        break;
+      case Op::InList:
+        value = this->IsInList(slot(step.Lhs), slot(step.Rhs));
+        break;
+      case Op::Not:
+        value = !this->GetBooleanValueWithAutoDereference(
+          slot(step.Lhs), errorString, status);
+        break;
+      case Op::And: {
+        bool lhs = this->GetBooleanValueWithAutoDereference(
+          slot(step.Lhs), errorString, status);
+        bool rhs = this->GetBooleanValueWithAutoDereference(
+          slot(step.Rhs), errorString, status);
+        value = lhs && rhs;
+      } break;
+      case Op::Or: {
+        bool lhs = this->GetBooleanValueWithAutoDereference(
+          slot(step.Lhs), errorString, status);
+        bool rhs = this->GetBooleanValueWithAutoDereference(
+          slot(step.Rhs), errorString, status);
+        value = lhs || rhs;
+      } break;
+      case Op::Group:
+        value = this->EvaluateCompiled(condition, step.Lhs, args, temps,
+                                       errorString, status);
+        break;
+    }
+    temps[step.Result - args.size()] =
+      cmExpandedCommandArgument(value ? "1" : "0", true);
+  }
+
+  switch (p.End) {
+    case Finish::MismatchedParenthesis:
+      errorString = "mismatched parenthesis in condition";
+      status = MessageType::FATAL_ERROR;
+      return false;
+    case Finish::UnknownArguments:
+      errorString = "Unknown arguments specified";
+      status = MessageType::FATAL_ERROR;
+      return false;
+    case Finish::Result:
+    case Finish::Empty:
+      break;
+  }
+  return this->GetBooleanValueWithAutoDereference(slot(p.Result), errorString,
+                                                  status, true);
+}
+
 //=========================================================================
 const char* cmConditionEvaluator::GetDefinitionIfUnquoted(
   cmExpandedCommandArgument const& argument) const
@@ -178,8 +933,8 @@ const char* cmConditionEvaluator::GetVariableOrString(
 }
 
 //=========================================================================
-bool cmConditionEvaluator::IsKeyword(std::string const& keyword,
-                                     cmExpandedCommandArgument& argument) const
+bool cmConditionEvaluator::IsKeyword(
+  std::string const& keyword, cmExpandedCommandArgument const& argument) const
 {
   if ((this->Policy54Status != cmPolicies::WARN &&
        this->Policy54Status != cmPolicies::OLD) &&
@@ -210,7 +965,7 @@ bool cmConditionEvaluator::IsKeyword(std::string const& keyword,
 
 //=========================================================================
 bool cmConditionEvaluator::GetBooleanValue(
-  cmExpandedCommandArgument& arg) const
+  cmExpandedCommandArgument const& arg) const
 {
   // Check basic constants.
   if (arg == "0") {
@@ -270,7 +1025,7 @@ bool cmConditionEvaluator::GetBooleanValueOld(
 //=========================================================================
 // returns the resulting boolean value
 bool cmConditionEvaluator::GetBooleanValueWithAutoDereference(
-  cmExpandedCommandArgument& newArg, std::string& errorString,
+  cmExpandedCommandArgument const& newArg, std::string& errorString,
   MessageType& status, bool oneArg) const
 {
   // Use the policy if it is set.
@@ -308,6 +1063,129 @@ bool cmConditionEvaluator::GetBooleanValueWithAutoDereference(
   return newResult;
 }
 
+//=========================================================================
+bool cmConditionEvaluator::IsDefined(std::string const& name) const
+{
+  size_t len = name.size();
+  if (len > 4 && cmHasLiteralPrefix(name, "ENV{") && name[len - 1] == '}') {
+    std::string env = name.substr(4, len - 5);
+    return cmSystemTools::HasEnv(env);
+  }
+  if (len > 6 && cmHasLiteralPrefix(name, "CACHE{") && name[len - 1] == '}') {
+    std::string cache = name.substr(6, len - 7);
+    return this->Makefile.GetState()->GetCacheEntryValue(cache) != nullptr;
+  }
+  return this->Makefile.IsDefinitionSet(name);
+}
+
+//=========================================================================
+bool cmConditionEvaluator::Matches(cmExpandedCommandArgument const& arg,
+                                   std::string const& regex, bool& result,
+                                   std::string& errorString,
+                                   MessageType& status)
+{
+  std::string def_buf;
+  const char* def = this->GetVariableOrString(arg);
+  if (def != arg.c_str() // yes, we compare the pointer value
+      && cmHasLiteralPrefix(arg.GetValue(), "CMAKE_MATCH_")) {
+    // The string to match is owned by our match result variables.
+    // Move it to our own buffer before clearing them.
+    def_buf = def;
+    def = def_buf.c_str();
+  }
+  this->Makefile.ClearMatches();
+  std::shared_ptr<cmsys::RegularExpression const> regEntry =
+    this->Makefile.GetCMakeInstance()->GetRegularExpressionCache()->Get(regex);
+  if (!regEntry) {
+    std::ostringstream error;
+    error << "Regular expression \"" << regex << "\" cannot compile";
+    errorString = error.str();
+    status = MessageType::FATAL_ERROR;
+    return false;
+  }
+  cmsys::RegularExpressionMatch match;
+  result = regEntry->find(def, match);
+  if (result) {
+    this->Makefile.StoreMatches(match);
+  }
+  return true;
+}
+
+//=========================================================================
+bool cmConditionEvaluator::CompareNumbers(
+  cmExpandedCommandArgument const& lhs, cmSystemTools::CompareOp op,
+  cmExpandedCommandArgument const& rhs) const
+{
+  const char* def = this->GetVariableOrString(lhs);
+  const char* def2 = this->GetVariableOrString(rhs);
+  double lhsValue;
+  double rhsValue;
+  if (sscanf(def, "%lg", &lhsValue) != 1 ||
+      sscanf(def2, "%lg", &rhsValue) != 1) {
+    return false;
+  }
+  switch (op) {
+    case cmSystemTools::OP_LESS:
+      return lhsValue < rhsValue;
+    case cmSystemTools::OP_LESS_EQUAL:
+      return lhsValue <= rhsValue;
+    case cmSystemTools::OP_GREATER:
+      return lhsValue > rhsValue;
+    case cmSystemTools::OP_GREATER_EQUAL:
+      return lhsValue >= rhsValue;
+    case cmSystemTools::OP_EQUAL:
+      break;
+  }
+  return lhsValue == rhsValue;
+}
+
+//=========================================================================
+bool cmConditionEvaluator::CompareStrings(
+  cmExpandedCommandArgument const& lhs, cmSystemTools::CompareOp op,
+  cmExpandedCommandArgument const& rhs) const
+{
+  const char* def = this->GetVariableOrString(lhs);
+  const char* def2 = this->GetVariableOrString(rhs);
+  int val = strcmp(def, def2);
+  switch (op) {
+    case cmSystemTools::OP_LESS:
+      return val < 0;
+    case cmSystemTools::OP_LESS_EQUAL:
+      return val <= 0;
+    case cmSystemTools::OP_GREATER:
+      return val > 0;
+    case cmSystemTools::OP_GREATER_EQUAL:
+      return val >= 0;
+    case cmSystemTools::OP_EQUAL:
+      break;
+  }
+  return val == 0;
+}
+
+//=========================================================================
+bool cmConditionEvaluator::CompareVersions(
+  cmExpandedCommandArgument const& lhs, cmSystemTools::CompareOp op,
+  cmExpandedCommandArgument const& rhs) const
+{
+  const char* def = this->GetVariableOrString(lhs);
+  const char* def2 = this->GetVariableOrString(rhs);
+  return cmSystemTools::VersionCompare(op, def, def2);
+}
+
+//=========================================================================
+bool cmConditionEvaluator::IsInList(
+  cmExpandedCommandArgument const& arg,
+  cmExpandedCommandArgument const& list) const
+{
+  const char* def = this->GetVariableOrString(arg);
+  const char* def2 = this->Makefile.GetDefinition(list.GetValue());
+  if (!def2) {
+    return false;
+  }
+  std::vector<std::string> values = cmExpandedList(def2, true);
+  return cm::contains(values, def);
+}
+
 //=========================================================================
 void cmConditionEvaluator::IncrementArguments(
   cmArgumentList& newArgs, cmArgumentList::iterator& argP1,
@@ -491,21 +1369,7 @@ bool cmConditionEvaluator::HandleLevel1(cmArgumentList& newArgs, std::string&,
       }
       // is a variable defined
       if (this->IsKeyword(keyDEFINED, *arg) && argP1 != newArgs.end()) {
-        size_t argP1len = argP1->GetValue().size();
-        bool bdef = false;
-        if (argP1len > 4 && cmHasLiteralPrefix(argP1->GetValue(), "ENV{") &&
-            argP1->GetValue().operator[](argP1len - 1) == '}') {
-          std::string env = argP1->GetValue().substr(4, argP1len - 5);
-          bdef = cmSystemTools::HasEnv(env);
-        } else if (argP1len > 6 &&
-                   cmHasLiteralPrefix(argP1->GetValue(), "CACHE{") &&
-                   argP1->GetValue().operator[](argP1len - 1) == '}') {
-          std::string cache = argP1->GetValue().substr(6, argP1len - 7);
-          bdef =
-            this->Makefile.GetState()->GetCacheEntryValue(cache) != nullptr;
-        } else {
-          bdef = this->Makefile.IsDefinitionSet(argP1->GetValue());
-        }
+        bool bdef = this->IsDefined(argP1->GetValue());
         this->HandlePredicate(bdef, reducible, arg, newArgs, argP1, argP2);
       }
       ++arg;
@@ -521,9 +1385,6 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
                                         MessageType& status)
 {
   int reducible;
-  std::string def_buf;
-  const char* def;
-  const char* def2;
   do {
     reducible = 0;
     auto arg = newArgs.begin();
@@ -534,30 +1395,12 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
       this->IncrementArguments(newArgs, argP1, argP2);
       if (argP1 != newArgs.end() && argP2 != newArgs.end() &&
           IsKeyword(keyMATCHES, *argP1)) {
-        def = this->GetVariableOrString(*arg);
-        if (def != arg->c_str() // yes, we compare the pointer value
-            && cmHasLiteralPrefix(arg->GetValue(), "CMAKE_MATCH_")) {
-          // The string to match is owned by our match result variables.
-          // Move it to our own buffer before clearing them.
-          def_buf = def;
-          def = def_buf.c_str();
-        }
-        const char* rex = argP2->c_str();
-        this->Makefile.ClearMatches();
-        cmsys::RegularExpression regEntry;
-        if (!regEntry.compile(rex)) {
-          std::ostringstream error;
-          error << "Regular expression \"" << rex << "\" cannot compile";
-          errorString = error.str();
-          status = MessageType::FATAL_ERROR;
+        bool result;
+        if (!this->Matches(*arg, argP2->GetValue(), result, errorString,
+                           status)) {
           return false;
         }
-        if (regEntry.find(def)) {
-          this->Makefile.StoreMatches(regEntry);
-          *arg = cmExpandedCommandArgument("1", true);
-        } else {
-          *arg = cmExpandedCommandArgument("0", true);
-        }
+        *arg = cmExpandedCommandArgument(result ? "1" : "0", true);
         newArgs.erase(argP2);
         newArgs.erase(argP1);
         argP1 = arg;
@@ -579,24 +1422,8 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
            this->IsKeyword(keyGREATER, *argP1) ||
            this->IsKeyword(keyGREATER_EQUAL, *argP1) ||
            this->IsKeyword(keyEQUAL, *argP1))) {
-        def = this->GetVariableOrString(*arg);
-        def2 = this->GetVariableOrString(*argP2);
-        double lhs;
-        double rhs;
-        bool result;
-        if (sscanf(def, "%lg", &lhs) != 1 || sscanf(def2, "%lg", &rhs) != 1) {
-          result = false;
-        } else if (*(argP1) == keyLESS) {
-          result = (lhs < rhs);
-        } else if (*(argP1) == keyLESS_EQUAL) {
-          result = (lhs <= rhs);
-        } else if (*(argP1) == keyGREATER) {
-          result = (lhs > rhs);
-        } else if (*(argP1) == keyGREATER_EQUAL) {
-          result = (lhs >= rhs);
-        } else {
-          result = (lhs == rhs);
-        }
+        bool result = this->CompareNumbers(
+          *arg, CompareOpForKeyword(argP1->GetValue()), *argP2);
         this->HandleBinaryOp(result, reducible, arg, newArgs, argP1, argP2);
       }
 
@@ -606,22 +1433,8 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
            this->IsKeyword(keySTRGREATER, *argP1) ||
            this->IsKeyword(keySTRGREATER_EQUAL, *argP1) ||
            this->IsKeyword(keySTREQUAL, *argP1))) {
-        def = this->GetVariableOrString(*arg);
-        def2 = this->GetVariableOrString(*argP2);
-        int val = strcmp(def, def2);
-        bool result;
-        if (*(argP1) == keySTRLESS) {
-          result = (val < 0);
-        } else if (*(argP1) == keySTRLESS_EQUAL) {
-          result = (val <= 0);
-        } else if (*(argP1) == keySTRGREATER) {
-          result = (val > 0);
-        } else if (*(argP1) == keySTRGREATER_EQUAL) {
-          result = (val >= 0);
-        } else // strequal
-        {
-          result = (val == 0);
-        }
+        bool result = this->CompareStrings(
+          *arg, CompareOpForKeyword(argP1->GetValue()), *argP2);
         this->HandleBinaryOp(result, reducible, arg, newArgs, argP1, argP2);
       }
 
@@ -631,50 +1444,23 @@ bool cmConditionEvaluator::HandleLevel2(cmArgumentList& newArgs,
            this->IsKeyword(keyVERSION_GREATER, *argP1) ||
            this->IsKeyword(keyVERSION_GREATER_EQUAL, *argP1) ||
            this->IsKeyword(keyVERSION_EQUAL, *argP1))) {
-        def = this->GetVariableOrString(*arg);
-        def2 = this->GetVariableOrString(*argP2);
-        cmSystemTools::CompareOp op;
-        if (*argP1 == keyVERSION_LESS) {
-          op = cmSystemTools::OP_LESS;
-        } else if (*argP1 == keyVERSION_LESS_EQUAL) {
-          op = cmSystemTools::OP_LESS_EQUAL;
-        } else if (*argP1 == keyVERSION_GREATER) {
-          op = cmSystemTools::OP_GREATER;
-        } else if (*argP1 == keyVERSION_GREATER_EQUAL) {
-          op = cmSystemTools::OP_GREATER_EQUAL;
-        } else { // version_equal
-          op = cmSystemTools::OP_EQUAL;
-        }
-        bool result = cmSystemTools::VersionCompare(op, def, def2);
+        bool result = this->CompareVersions(
+          *arg, CompareOpForKeyword(argP1->GetValue()), *argP2);
         this->HandleBinaryOp(result, reducible, arg, newArgs, argP1, argP2);
       }
 
       // is file A newer than file B
       if (argP1 != newArgs.end() && argP2 != newArgs.end() &&
           this->IsKeyword(keyIS_NEWER_THAN, *argP1)) {
-        int fileIsNewer = 0;
-        bool success = cmSystemTools::FileTimeCompare(
-          arg->GetValue(), (argP2)->GetValue(), &fileIsNewer);
-        this->HandleBinaryOp(
-          (!success || fileIsNewer == 1 || fileIsNewer == 0), reducible, arg,
-          newArgs, argP1, argP2);
+        this->HandleBinaryOp(IsNewerThan(*arg, *argP2), reducible, arg,
+                             newArgs, argP1, argP2);
       }
 
       if (argP1 != newArgs.end() && argP2 != newArgs.end() &&
           this->IsKeyword(keyIN_LIST, *argP1)) {
         if (this->Policy57Status != cmPolicies::OLD &&
             this->Policy57Status != cmPolicies::WARN) {
-          bool result = false;
-
-          def = this->GetVariableOrString(*arg);
-          def2 = this->Makefile.GetDefinition(argP2->GetValue());
-
-          if (def2) {
-            std::vector<std::string> list = cmExpandedList(def2, true);
-
-            result = cm::contains(list, def);
-          }
-
+          bool result = this->IsInList(*arg, *argP2);
           this->HandleBinaryOp(result, reducible, arg, newArgs, argP1, argP2);
         } else if (this->Policy57Status == cmPolicies::WARN) {
           std::ostringstream e;
@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <list>
 #include <string>
 #include <vector>
@@ -13,7 +14,9 @@
 #include "cmListFileCache.h"
 #include "cmMessageType.h"
 #include "cmPolicies.h"
+#include "cmSystemTools.h"
 
+class cmCompiledCondition;
 class cmMakefile;
 
 class cmConditionEvaluator
@@ -30,7 +33,21 @@ public:
   bool IsTrue(const std::vector<cmExpandedCommandArgument>& args,
               std::string& errorString, MessageType& status);
 
+  // Same as above, but caches the compiled condition on the first of the
+  // unexpanded arguments the given ones were expanded from.  It is
+  // compiled again whenever the keywords among the expanded arguments or
+  // the relevant policies differ from the cached ones.
+  bool IsTrue(const std::vector<cmExpandedCommandArgument>& args,
+              std::string& errorString, MessageType& status,
+              const std::vector<cmListFileArgument>& unexpandedArgs);
+
 private:
+  bool EvaluateCompiled(cmCompiledCondition const& condition,
+                        std::size_t program,
+                        const std::vector<cmExpandedCommandArgument>& args,
+                        std::vector<cmExpandedCommandArgument>& temps,
+                        std::string& errorString, MessageType& status);
+
   // Filter the given variable definition based on policy CMP0054.
   const char* GetDefinitionIfUnquoted(
     const cmExpandedCommandArgument& argument) const;
@@ -39,17 +56,37 @@ private:
     const cmExpandedCommandArgument& argument) const;
 
   bool IsKeyword(std::string const& keyword,
-                 cmExpandedCommandArgument& argument) const;
+                 cmExpandedCommandArgument const& argument) const;
 
-  bool GetBooleanValue(cmExpandedCommandArgument& arg) const;
+  bool GetBooleanValue(cmExpandedCommandArgument const& arg) const;
 
   bool GetBooleanValueOld(cmExpandedCommandArgument const& arg,
                           bool one) const;
 
-  bool GetBooleanValueWithAutoDereference(cmExpandedCommandArgument& newArg,
-                                          std::string& errorString,
-                                          MessageType& status,
-                                          bool oneArg = false) const;
+  bool GetBooleanValueWithAutoDereference(
+    cmExpandedCommandArgument const& newArg, std::string& errorString,
+    MessageType& status, bool oneArg = false) const;
+
+  bool IsDefined(std::string const& name) const;
+
+  bool Matches(cmExpandedCommandArgument const& arg, std::string const& regex,
+               bool& result, std::string& errorString,
+               MessageType& status);
+
+  bool CompareNumbers(cmExpandedCommandArgument const& lhs,
+                      cmSystemTools::CompareOp op,
+                      cmExpandedCommandArgument const& rhs) const;
+
+  bool CompareStrings(cmExpandedCommandArgument const& lhs,
+                      cmSystemTools::CompareOp op,
+                      cmExpandedCommandArgument const& rhs) const;
+
+  bool CompareVersions(cmExpandedCommandArgument const& lhs,
+                       cmSystemTools::CompareOp op,
+                       cmExpandedCommandArgument const& rhs) const;
+
+  bool IsInList(cmExpandedCommandArgument const& arg,
+                cmExpandedCommandArgument const& list) const;
 
   void IncrementArguments(cmArgumentList& newArgs,
                           cmArgumentList::iterator& argP1,
@@ -2,8 +2,10 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmCoreTryCompile.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <utility>
@@ -11,7 +13,12 @@
 #include <cmext/string_view>
 
 #include "cmsys/Directory.hxx"
+#include "cmsys/FStream.hxx"
+#include "cmsys/RegularExpression.hxx"
 
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmCryptoHash.h"
+#endif
 #include "cmExportTryCompileFileGenerator.h"
 #include "cmGlobalGenerator.h"
 #include "cmMakefile.h"
@@ -22,6 +29,7 @@
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmTarget.h"
+#include "cmTryCompileBatchCommand.h"
 #include "cmVersion.h"
 #include "cmake.h"
 
@@ -79,6 +87,65 @@ static std::set<std::string> ghs_platform_vars{
   "GHS_OS_DIR_OPTION"
 };
 
+namespace {
+/* Placeholders for paths that differ between build trees in the
+   try_compile cache.  */
+std::string const BinaryDirectoryPlaceholder =
+  "<CMAKE_TRY_COMPILE_BINARY_DIR>";
+std::string const TargetNamePlaceholder = "<CMAKE_TRY_COMPILE_TARGET_NAME>";
+
+bool readWholeFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(fin),
+                 std::istreambuf_iterator<char>());
+  return !fin.bad();
+}
+
+bool writeWholeFile(std::string const& path, std::string const& content)
+{
+  cmsys::ofstream fout(path.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+  fout.write(content.data(), static_cast<std::streamsize>(content.size()));
+  fout.close();
+  return static_cast<bool>(fout);
+}
+
+#ifndef CMAKE_BOOTSTRAP
+/* Append the content hash of each header that a file includes with
+   quotes from its own directory, recursively.  Headers found only
+   through include directories are not followed.  */
+void appendQuotedIncludes(std::string const& file, std::string const& dir,
+                          cmCryptoHash& hasher, std::set<std::string>& seen,
+                          std::string& key)
+{
+  static cmsys::RegularExpression const includeLine(
+    "^[ \t]*#[ \t]*(include|import)[ \t]*\"([^\"]+)\"");
+  cmsys::ifstream fin(file.c_str());
+  std::string line;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    cmsys::RegularExpressionMatch match;
+    if (!includeLine.find(line.c_str(), match)) {
+      continue;
+    }
+    std::string const header =
+      cmSystemTools::CollapseFullPath(match.match(2), dir);
+    if (!cmSystemTools::FileExists(header, true) ||
+        !seen.insert(header).second) {
+      continue;
+    }
+    key += cmStrCat("#include ", match.match(2), '=',
+                    hasher.HashFile(header), '\n');
+    appendQuotedIncludes(header, cmSystemTools::GetFilenamePath(header),
+                         hasher, seen, key);
+  }
+}
+#endif
+}
+
 static void writeProperty(FILE* fout, std::string const& targetName,
                           std::string const& prop, std::string const& value)
 {
@@ -103,6 +170,17 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 {
   this->BinaryDirectory = argv[1];
   this->OutputFile.clear();
+  this->Queued = false;
+
+  // Only a call announced by try_compile_batch(QUEUE) may be queued.
+  cmTryCompileBatch* batch = this->Makefile->GetTryCompileBatch();
+  bool queueable = false;
+  if (batch) {
+    queueable = batch->QueueNext;
+    batch->QueueNext = false;
+    batch->LastQueued = false;
+  }
+
   // which signature were we called with ?
   this->SrcFileSignature = true;
 
@@ -466,6 +544,11 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     return -1;
   }
 
+  // While try_compile_batch() collects checks, source file signature
+  // checks are queued to be built together instead of one at a time.
+  bool const queue = queueable && this->SrcFileSignature && !isTryRun &&
+    cmakeInternal.empty() && targets.empty() && this->CanQueue(cmakeFlags);
+
   // compute the binary dir when TRY_COMPILE is called with a src file
   // signature
   if (this->SrcFileSignature) {
@@ -498,6 +581,7 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
   }
 
   std::string outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+  std::string cacheEntry;
   // which signature are we using? If we are using var srcfile bindir
   if (this->SrcFileSignature) {
     // remove any CMakeCache.txt files so we will have a clean test
@@ -532,6 +616,43 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       }
     }
 
+    // Quoted includes of each source resolve next to the original.
+    std::vector<std::string> sourceDirectories;
+    sourceDirectories.reserve(sources.size());
+    for (std::string const& si : sources) {
+      sourceDirectories.push_back(cmSystemTools::GetFilenamePath(si));
+    }
+
+    if (queue) {
+      // Each queued check gets its own project directory.  Sources may
+      // be rewritten before the batch is built (the check modules reuse
+      // one temporary file), so build from a copy of each of them.
+      this->BinaryDirectory =
+        cmStrCat(batch->Directory, '/', batch->QueuedCount++);
+      cmSystemTools::MakeDirectory(this->BinaryDirectory);
+      outFileName = this->BinaryDirectory + "/CMakeLists.txt";
+      for (std::size_t i = 0; i < sources.size(); ++i) {
+        std::string& si = sources[i];
+        // Add dependencies on any non-temporary sources.
+        if (si.find("CMakeTmp") == std::string::npos) {
+          this->Makefile->AddCMakeDependFile(si);
+        }
+        std::string const name = cmSystemTools::GetFilenameName(si);
+        std::string copy = cmStrCat(this->BinaryDirectory, '/', name);
+        if (cmSystemTools::FileExists(copy)) {
+          copy = cmStrCat(this->BinaryDirectory, "/src", i, '/', name);
+        }
+        if (!cmSystemTools::CopyFileAlways(si, copy)) {
+          this->Makefile->IssueMessage(
+            MessageType::FATAL_ERROR,
+            cmStrCat("Failed to copy\n  ", si, "\nto\n  ", copy, "\n",
+                     cmSystemTools::GetLastSystemError()));
+          return -1;
+        }
+        si = std::move(copy);
+      }
+    }
+
     std::string const tcConfig =
       this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
 
@@ -698,8 +819,17 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
 
     /* Use a random file name to avoid rapid creation and deletion
        of the same executable name (some filesystems fail on that).  */
-    sprintf(targetNameBuf, "cmTC_%05x", cmSystemTools::RandomSeed() & 0xFFFFF);
-    targetName = targetNameBuf;
+    /* Queued checks share one project, so their names must differ.  */
+    auto const sameName = [&targetName](cmTryCompileBatch::Check const& c) {
+      return c.TargetName == targetName;
+    };
+    do {
+      sprintf(targetNameBuf, "cmTC_%05x",
+              cmSystemTools::RandomSeed() & 0xFFFFF);
+      targetName = targetNameBuf;
+    } while (queue &&
+             std::any_of(batch->Checks.begin(), batch->Checks.end(),
+                         sameName));
 
     if (!targets.empty()) {
       std::string fname = "/" + std::string(targetName) + "Targets.cmake";
@@ -818,6 +948,17 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       }
     }
     fprintf(fout, ")\n");
+    if (queue) {
+      // Let the copies of project sources find the headers next to them.
+      for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (sourceDirectories[i].find("CMakeTmp") == std::string::npos) {
+          fprintf(fout,
+                  "set_property(SOURCE \"%s\" PROPERTY "
+                  "INCLUDE_DIRECTORIES \"%s\")\n",
+                  sources[i].c_str(), sourceDirectories[i].c_str());
+        }
+      }
+    }
 
     bool const testC = testLangs.find("C") != testLangs.end();
     bool const testObjC = testLangs.find("OBJC") != testLangs.end();
@@ -966,6 +1107,15 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
     fclose(fout);
     projectName = "CMAKE_TRY_COMPILE";
+
+    // Results of checks that are internal to CMake or depend on imported
+    // targets are never shared.
+    if (cmakeInternal.empty() && targets.empty() &&
+        !this->Makefile->GetState()->UseGhsMultiIDE()) {
+      cacheEntry =
+        this->GetCacheEntry(outFileName, targetName, targetType, testLangs,
+                            sources, sourceDirectories, cmakeFlags);
+    }
   }
 
   if (this->Makefile->GetState()->UseGhsMultiIDE()) {
@@ -978,45 +1128,81 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
     }
   }
 
-  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
-  cmSystemTools::ResetErrorOccuredFlag();
+  cmTryCompileBatch::Check check;
+  check.ResultVariable = argv[0];
+  check.OutputVariable = outputVariable;
+  check.CopyFile = copyFile;
+  check.CopyFileError = copyFileError;
+  check.TargetName = targetName;
+  check.TargetType = targetType;
+
   std::string output;
-  // actually do the try compile now that everything is setup
-  int res = this->Makefile->TryCompile(
-    sourceDirectory, this->BinaryDirectory, projectName, targetName,
-    this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
-    output);
-  if (erroroc) {
-    cmSystemTools::SetErrorOccured();
+  int res = 0;
+  bool const cached = !cacheEntry.empty() &&
+    this->LoadCachedResult(cacheEntry, targetName, targetType, res, output);
+  if (!cached && queue) {
+    if (!this->WriteQueuedFlags(cmakeFlags)) {
+      return -1;
+    }
+    check.BinaryDirectory = this->BinaryDirectory;
+    check.CacheEntry = cacheEntry;
+    batch->Checks.push_back(std::move(check));
+    batch->LastQueued = true;
+    this->Queued = true;
+    cmTryCompileBatchCommand::WatchQueuedResult(*this->Makefile, argv[0]);
+    return 0;
   }
+  if (!cached) {
+    bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+    cmSystemTools::ResetErrorOccuredFlag();
+    // actually do the try compile now that everything is setup
+    res = this->Makefile->TryCompile(
+      sourceDirectory, this->BinaryDirectory, projectName, targetName,
+      this->SrcFileSignature, cmake::NO_BUILD_PARALLEL_LEVEL, &cmakeFlags,
+      output);
+    if (!cacheEntry.empty() && !cmSystemTools::GetErrorOccuredFlag()) {
+      this->StoreCachedResult(cacheEntry, targetName, targetType, res,
+                              output);
+    }
+    if (erroroc) {
+      cmSystemTools::SetErrorOccured();
+    }
+  }
+
+  return this->ReportResult(check, res, output);
+}
 
+int cmCoreTryCompile::ReportResult(cmTryCompileBatch::Check const& check,
+                                   int res, std::string const& output)
+{
   // set the result var to the return value to indicate success or failure
-  this->Makefile->AddCacheDefinition(argv[0], (res == 0 ? "TRUE" : "FALSE"),
+  this->Makefile->AddCacheDefinition(check.ResultVariable,
+                                     (res == 0 ? "TRUE" : "FALSE"),
                                      "Result of TRY_COMPILE",
                                      cmStateEnums::INTERNAL);
 
-  if (!outputVariable.empty()) {
-    this->Makefile->AddDefinition(outputVariable, output);
+  if (!check.OutputVariable.empty()) {
+    this->Makefile->AddDefinition(check.OutputVariable, output);
   }
 
   if (this->SrcFileSignature) {
     std::string copyFileErrorMessage;
-    this->FindOutputFile(targetName, targetType);
+    this->FindOutputFile(check.TargetName, check.TargetType);
 
-    if ((res == 0) && !copyFile.empty()) {
+    if ((res == 0) && !check.CopyFile.empty()) {
       if (this->OutputFile.empty() ||
-          !cmSystemTools::CopyFileAlways(this->OutputFile, copyFile)) {
+          !cmSystemTools::CopyFileAlways(this->OutputFile, check.CopyFile)) {
         std::ostringstream emsg;
         /* clang-format off */
         emsg << "Cannot copy output executable\n"
              << "  '" << this->OutputFile << "'\n"
              << "to destination specified by COPY_FILE:\n"
-             << "  '" << copyFile << "'\n";
+             << "  '" << check.CopyFile << "'\n";
         /* clang-format on */
         if (!this->FindErrorMessage.empty()) {
           emsg << this->FindErrorMessage;
         }
-        if (copyFileError.empty()) {
+        if (check.CopyFileError.empty()) {
           this->Makefile->IssueMessage(MessageType::FATAL_ERROR, emsg.str());
           return -1;
         }
@@ -1024,13 +1210,76 @@ int cmCoreTryCompile::TryCompileCode(std::vector<std::string> const& argv,
       }
     }
 
-    if (!copyFileError.empty()) {
-      this->Makefile->AddDefinition(copyFileError, copyFileErrorMessage);
+    if (!check.CopyFileError.empty()) {
+      this->Makefile->AddDefinition(check.CopyFileError,
+                                    copyFileErrorMessage);
     }
   }
   return res;
 }
 
+int cmCoreTryCompile::FinishQueuedCheck(
+  cmTryCompileBatch::Check const& check, int res, std::string const& output)
+{
+  this->BinaryDirectory = check.BinaryDirectory;
+  this->SrcFileSignature = true;
+  if (!check.CacheEntry.empty() && !cmSystemTools::GetErrorOccuredFlag()) {
+    this->StoreCachedResult(check.CacheEntry, check.TargetName,
+                            check.TargetType, res, output);
+  }
+  return this->ReportResult(check, res, output);
+}
+
+bool cmCoreTryCompile::CanQueue(
+  std::vector<std::string> const& cmakeFlags) const
+{
+  if (this->Makefile->GetState()->UseGhsMultiIDE()) {
+    return false;
+  }
+  // The batch project sets the cache entries of each check as normal
+  // variables, which works only for plain -D entries.  The first
+  // element is a placeholder for the CMAKE_FLAGS keyword.
+  for (auto fi = cmakeFlags.begin() + 1; fi != cmakeFlags.end(); ++fi) {
+    std::string var;
+    std::string value;
+    cmStateEnums::CacheEntryType type = cmStateEnums::UNINITIALIZED;
+    if (!fi->empty() &&
+        (!cmHasLiteralPrefix(*fi, "-D") ||
+         !cmState::ParseCacheEntry(fi->substr(2), var, value, type))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool cmCoreTryCompile::WriteQueuedFlags(
+  std::vector<std::string> const& cmakeFlags)
+{
+  std::string content;
+  for (auto fi = cmakeFlags.begin() + 1; fi != cmakeFlags.end(); ++fi) {
+    std::string var;
+    std::string value;
+    cmStateEnums::CacheEntryType type = cmStateEnums::UNINITIALIZED;
+    if (cmHasLiteralPrefix(*fi, "-D") &&
+        cmState::ParseCacheEntry(fi->substr(2), var, value, type)) {
+      content += cmStrCat("set(", cmOutputConverter::EscapeForCMake(var), ' ',
+                          cmOutputConverter::EscapeForCMake(value), ")\n");
+    }
+  }
+  std::string const file = this->BinaryDirectory + "/TryCompileFlags.cmake";
+  if (!writeWholeFile(file, content)) {
+    std::ostringstream e;
+    /* clang-format off */
+    e << "Failed to write\n"
+      << "  " << file << "\n"
+      << cmSystemTools::GetLastSystemError();
+    /* clang-format on */
+    this->Makefile->IssueMessage(MessageType::FATAL_ERROR, e.str());
+    return false;
+  }
+  return true;
+}
+
 void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
 {
   if (binDir.empty()) {
@@ -1085,24 +1334,28 @@ void cmCoreTryCompile::CleanupFiles(std::string const& binDir)
   }
 }
 
+std::string cmCoreTryCompile::GetOutputFileName(
+  const std::string& targetName, cmStateEnums::TargetType targetType) const
+{
+  if (targetType == cmStateEnums::EXECUTABLE) {
+    return cmStrCat(
+      targetName,
+      this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX"));
+  }
+  // if (targetType == cmStateEnums::STATIC_LIBRARY)
+  return cmStrCat(
+    this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX"),
+    targetName,
+    this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX"));
+}
+
 void cmCoreTryCompile::FindOutputFile(const std::string& targetName,
                                       cmStateEnums::TargetType targetType)
 {
   this->FindErrorMessage.clear();
   this->OutputFile.clear();
-  std::string tmpOutputFile = "/";
-  if (targetType == cmStateEnums::EXECUTABLE) {
-    tmpOutputFile += targetName;
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_EXECUTABLE_SUFFIX");
-  } else // if (targetType == cmStateEnums::STATIC_LIBRARY)
-  {
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_PREFIX");
-    tmpOutputFile += targetName;
-    tmpOutputFile +=
-      this->Makefile->GetSafeDefinition("CMAKE_STATIC_LIBRARY_SUFFIX");
-  }
+  std::string tmpOutputFile =
+    cmStrCat('/', this->GetOutputFileName(targetName, targetType));
 
   // a list of directories where to search for the compilation result
   // at first directly in the binary dir
@@ -1143,3 +1396,149 @@ void cmCoreTryCompile::FindOutputFile(const std::string& targetName,
        << "\n";
   this->FindErrorMessage = emsg.str();
 }
+
+std::string cmCoreTryCompile::GetCacheEntry(
+  std::string const& projectFile, std::string const& targetName,
+  cmStateEnums::TargetType targetType, std::set<std::string> const& testLangs,
+  std::vector<std::string> const& sources,
+  std::vector<std::string> const& sourceDirectories,
+  std::vector<std::string> const& cmakeFlags)
+{
+#ifndef CMAKE_BOOTSTRAP
+  std::string const& cacheDir =
+    this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CACHE_DIR");
+  if (cacheDir.empty()) {
+    return std::string();
+  }
+
+  // Collect everything that affects the outcome of the check.
+  std::string key = cmStrCat(
+    "cmTryCompileCache 1\n", cmVersion::GetCMakeVersion(), '\n',
+    this->Makefile->GetGlobalGenerator()->GetName(), '\n',
+    cmState::GetTargetTypeName(targetType), '\n',
+    this->Makefile->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION"),
+    '\n');
+  for (std::string const& li : testLangs) {
+    for (const char* suffix : { "", "_ID", "_VERSION" }) {
+      std::string const var = cmStrCat("CMAKE_", li, "_COMPILER", suffix);
+      key += cmStrCat(var, '=', this->Makefile->GetSafeDefinition(var), '\n');
+    }
+  }
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA256);
+  std::string const& toolchainFile =
+    this->Makefile->GetSafeDefinition("CMAKE_TOOLCHAIN_FILE");
+  if (!toolchainFile.empty()) {
+    std::string const toolchainHash = hasher.HashFile(toolchainFile);
+    if (toolchainHash.empty()) {
+      return std::string();
+    }
+    key += cmStrCat("CMAKE_TOOLCHAIN_FILE=", toolchainHash, '\n');
+  }
+  for (std::string const& flag : cmakeFlags) {
+    key += cmStrCat(flag, '\n');
+  }
+
+  // The sources are identified by their content rather than their path.
+  std::string project;
+  if (!readWholeFile(projectFile, project)) {
+    return std::string();
+  }
+  std::set<std::string> headers;
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    std::string const& si = sources[i];
+    std::string const sourceHash = hasher.HashFile(si);
+    if (sourceHash.empty()) {
+      return std::string();
+    }
+    cmSystemTools::ReplaceString(project, cmStrCat('"', si, '"'),
+                                 cmStrCat('"', sourceHash, '"'));
+    appendQuotedIncludes(si, sourceDirectories[i], hasher, headers, key);
+  }
+  key += project;
+
+  cmSystemTools::ReplaceString(key, this->BinaryDirectory,
+                               BinaryDirectoryPlaceholder);
+  cmSystemTools::ReplaceString(key, targetName, TargetNamePlaceholder);
+  return cmStrCat(cmSystemTools::CollapseFullPath(
+                    cacheDir, this->Makefile->GetHomeOutputDirectory()),
+                  '/', hasher.HashString(key));
+#else
+  static_cast<void>(projectFile);
+  static_cast<void>(targetName);
+  static_cast<void>(targetType);
+  static_cast<void>(testLangs);
+  static_cast<void>(sources);
+  static_cast<void>(sourceDirectories);
+  static_cast<void>(cmakeFlags);
+  return std::string();
+#endif
+}
+
+bool cmCoreTryCompile::LoadCachedResult(std::string const& entry,
+                                        std::string const& targetName,
+                                        cmStateEnums::TargetType targetType,
+                                        int& res, std::string& output)
+{
+  if (this->Makefile->IsOn("CMAKE_TRY_COMPILE_CACHE_INVALIDATE")) {
+    return false;
+  }
+  std::string result;
+  long value;
+  if (!readWholeFile(entry + "/result.txt", result) ||
+      !cmStrToLong(cmTrimWhitespace(result), &value) ||
+      !readWholeFile(entry + "/output.txt", output)) {
+    return false;
+  }
+
+  // Put the output file where the build would have placed it.
+  std::string const artifact = entry + "/artifact";
+  if (cmSystemTools::FileExists(artifact) &&
+      !cmSystemTools::CopyFileAlways(
+        artifact,
+        cmStrCat(this->BinaryDirectory, '/',
+                 this->GetOutputFileName(targetName, targetType)))) {
+    return false;
+  }
+
+  cmSystemTools::ReplaceString(output, BinaryDirectoryPlaceholder,
+                               this->BinaryDirectory);
+  cmSystemTools::ReplaceString(output, TargetNamePlaceholder, targetName);
+  res = static_cast<int>(value);
+  return true;
+}
+
+void cmCoreTryCompile::StoreCachedResult(std::string const& entry,
+                                         std::string const& targetName,
+                                         cmStateEnums::TargetType targetType,
+                                         int res, std::string output)
+{
+  cmSystemTools::ReplaceString(output, this->BinaryDirectory,
+                               BinaryDirectoryPlaceholder);
+  cmSystemTools::ReplaceString(output, targetName, TargetNamePlaceholder);
+
+  // Fill a temporary directory and move it into place so that other
+  // build trees never see a partial entry.
+  char suffix[16];
+  sprintf(suffix, ".tmp%05x", cmSystemTools::RandomSeed() & 0xFFFFF);
+  std::string const tmpEntry = entry + suffix;
+  if (!cmSystemTools::MakeDirectory(tmpEntry)) {
+    return;
+  }
+  bool ok = writeWholeFile(tmpEntry + "/output.txt", output);
+  if (ok && res == 0) {
+    this->FindOutputFile(targetName, targetType);
+    ok = this->OutputFile.empty() ||
+      cmSystemTools::CopyFileAlways(this->OutputFile, tmpEntry + "/artifact");
+  }
+  ok = ok && writeWholeFile(tmpEntry + "/result.txt", std::to_string(res));
+  if (ok) {
+    // An entry that exists here was deliberately not used.
+    if (cmSystemTools::FileIsDirectory(entry)) {
+      cmSystemTools::RemoveADirectory(entry);
+    }
+    ok = cmSystemTools::RenameFile(tmpEntry, entry);
+  }
+  if (!ok) {
+    cmSystemTools::RemoveADirectory(tmpEntry);
+  }
+}
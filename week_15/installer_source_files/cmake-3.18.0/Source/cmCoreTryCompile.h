@@ -5,11 +5,13 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <set>
 #include <string>
 #include <vector>
 
 #include "cmCommand.h"
 #include "cmStateTypes.h"
+#include "cmTryCompileBatch.h"
 
 /** \class cmCoreTryCompile
  * \brief Base class for cmTryCompileCommand and cmTryRunCommand
@@ -43,14 +45,61 @@ protected:
   void FindOutputFile(const std::string& targetName,
                       cmStateEnums::TargetType targetType);
 
+  /**
+   * Report the result of a check queued by TryCompileCode once the
+   * batch has been built.  Returns res, or -1 on a fatal error.
+   */
+  int FinishQueuedCheck(cmTryCompileBatch::Check const& check, int res,
+                        std::string const& output);
+
   std::string BinaryDirectory;
   std::string OutputFile;
   std::string FindErrorMessage;
   bool SrcFileSignature = false;
 
+  /** Whether TryCompileCode queued the check into a batch.  */
+  bool Queued = false;
+
 private:
   std::vector<std::string> WarnCMP0067;
   std::string LookupStdVar(std::string const& var, bool warnCMP0067);
+
+  std::string GetOutputFileName(const std::string& targetName,
+                                cmStateEnums::TargetType targetType) const;
+
+  /**
+   * Results of source file signature checks may be shared between build
+   * trees through the directory named by CMAKE_TRY_COMPILE_CACHE_DIR.
+   * Each entry is a directory named by a hash of everything that goes
+   * into the test project, including the headers each source includes
+   * with quotes from its directory in sourceDirectories.
+   */
+  std::string GetCacheEntry(
+    std::string const& projectFile, std::string const& targetName,
+    cmStateEnums::TargetType targetType,
+    std::set<std::string> const& testLangs,
+    std::vector<std::string> const& sources,
+    std::vector<std::string> const& sourceDirectories,
+    std::vector<std::string> const& cmakeFlags);
+  bool LoadCachedResult(std::string const& entry,
+                        std::string const& targetName,
+                        cmStateEnums::TargetType targetType, int& res,
+                        std::string& output);
+  void StoreCachedResult(std::string const& entry,
+                         std::string const& targetName,
+                         cmStateEnums::TargetType targetType, int res,
+                         std::string output);
+
+  /**
+   * Store the result of a build in the variables named by the check
+   * and copy its output file if requested.  Returns res, or -1 on a
+   * fatal error.
+   */
+  int ReportResult(cmTryCompileBatch::Check const& check, int res,
+                   std::string const& output);
+
+  bool CanQueue(std::vector<std::string> const& cmakeFlags) const;
+  bool WriteQueuedFlags(std::vector<std::string> const& cmakeFlags);
 };
 
 #endif
@@ -2,122 +2,371 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmDefinitions.h"
 
-#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <unordered_set>
 #include <utility>
 
 #include <cm/string_view>
 
+#include "cmStringAlgorithms.h"
+
+namespace {
+// Whether an element joined into a ;-list splits back into itself.
+bool IsPlainListElement(std::string const& element)
+{
+  return !element.empty() &&
+    element.find_first_of(";[]") == std::string::npos &&
+    element.back() != '\\';
+}
+}
+
 cmDefinitions::Def cmDefinitions::NoDef;
 
-cmDefinitions::Def const& cmDefinitions::GetInternal(const std::string& key,
-                                                     StackIter begin,
-                                                     StackIter end, bool raise)
+const std::string* cmDefinitions::Def::GetValue() const
 {
-  assert(begin != end);
-  {
-    auto it = begin->Map.find(cm::String::borrow(key));
-    if (it != begin->Map.end()) {
-      it->second.Used = true;
-      return it->second;
+  if (!this->Value && this->Elements) {
+    this->Value = cmJoin(*this->Elements, ";");
+  }
+  return this->Value ? this->Value.str_if_stable() : nullptr;
+}
+
+const cmDefinitions::List* cmDefinitions::Def::GetList() const
+{
+  if (!this->Elements && !this->ListChecked && this->Value) {
+    this->ListChecked = true;
+    auto elements = std::make_shared<List>();
+    if (!this->Value.empty()) {
+      cmExpandList(this->Value.view(), *elements, true);
+      if (!std::all_of(elements->begin(), elements->end(),
+                       IsPlainListElement)) {
+        return nullptr;
+      }
     }
+    this->Elements = std::move(elements);
   }
-  StackIter it = begin;
-  ++it;
-  if (it == end) {
-    return cmDefinitions::NoDef;
+  return this->Elements.get();
+}
+
+/** A node of the trie.  Each level uses five bits of the key hash to
+    select one of 32 slots that holds either a definition or a subtree.
+    Nodes below the last level hold colliding keys in a plain list.  */
+struct cmDefinitions::Node
+{
+  struct Leaf
+  {
+    cmInternedString Key;
+    Def Value;
+  };
+
+  std::uint32_t LeafMap = 0;
+  std::uint32_t ChildMap = 0;
+  std::vector<Leaf> Leaves;
+  std::vector<std::shared_ptr<Node>> Children;
+};
+
+/** The definitions used in a directory scope.  A directory starts with
+    the uses recorded by its parent directory when it was created.  */
+struct cmDefinitions::Usage
+{
+  bool Contains(std::size_t serial) const
+  {
+    for (Usage const* usage = this; usage; usage = usage->Parent.get()) {
+      if (usage->Serials.count(serial)) {
+        return true;
+      }
+    }
+    return false;
   }
-  Def const& def = cmDefinitions::GetInternal(key, it, end, raise);
-  if (!raise) {
-    return def;
+
+  std::unordered_set<std::size_t> Serials;
+  std::shared_ptr<Usage const> Parent;
+};
+
+namespace {
+const unsigned int BitsPerLevel = 5;
+const unsigned int HashBits = sizeof(std::size_t) * 8;
+
+std::atomic<std::size_t> NextScopeId(1);
+std::atomic<std::size_t> NextSerial(1);
+
+// Hash a key the same way cmInternedString does.
+std::size_t HashKey(cm::string_view key)
+{
+  return std::hash<cm::string_view>{}(key);
+}
+
+std::uint32_t SlotBit(std::size_t hash, unsigned int shift)
+{
+  return std::uint32_t(1) << ((hash >> shift) & 0x1F);
+}
+
+// Index of the entry for the given bit in a compressed slot array.
+std::size_t SlotIndex(std::uint32_t map, std::uint32_t bit)
+{
+  std::uint32_t v = map & (bit - 1);
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+  return static_cast<std::size_t>((((v + (v >> 4)) & 0x0F0F0F0F) *
+                                   0x01010101) >>
+                                  24);
+}
+
+template <typename Node>
+Node& MakeUnique(std::shared_ptr<Node>& node)
+{
+  if (!node) {
+    node = std::make_shared<Node>();
+  } else if (node.use_count() != 1) {
+    // The node is shared with another scope, so copy it before changing.
+    node = std::make_shared<Node>(*node);
   }
-  return begin->Map.emplace(key, def).first->second;
+  return *node;
+}
+}
+
+cmDefinitions::cmDefinitions()
+  : Id(NextScopeId++)
+  , ClosureId(this->Id)
+  , Used(std::make_shared<Usage>())
+{
 }
 
-const std::string* cmDefinitions::Get(const std::string& key, StackIter begin,
-                                      StackIter end)
+cmDefinitions::cmDefinitions(std::shared_ptr<Node> root,
+                             std::size_t closureId,
+                             std::shared_ptr<Usage> used)
+  : Root(std::move(root))
+  , Id(NextScopeId++)
+  , ClosureId(closureId ? closureId : this->Id)
+  , Used(std::move(used))
 {
-  Def const& def = cmDefinitions::GetInternal(key, begin, end, false);
-  return def.Value ? def.Value.str_if_stable() : nullptr;
 }
 
-void cmDefinitions::Raise(const std::string& key, StackIter begin,
-                          StackIter end)
+cmDefinitions cmDefinitions::MakeChild() const
 {
-  cmDefinitions::GetInternal(key, begin, end, true);
+  return cmDefinitions(this->Root, this->ClosureId, this->Used);
 }
 
-bool cmDefinitions::HasKey(const std::string& key, StackIter begin,
-                           StackIter end)
+cmDefinitions cmDefinitions::MakeClosure() const
 {
-  for (StackIter it = begin; it != end; ++it) {
-    if (it->Map.find(cm::String::borrow(key)) != it->Map.end()) {
-      return true;
+  auto used = std::make_shared<Usage>();
+  used->Parent = this->Used;
+  return cmDefinitions(this->Root, 0, std::move(used));
+}
+
+cmDefinitions::Def const& cmDefinitions::Find(const std::string& key) const
+{
+  std::size_t const hash = HashKey(key);
+  Node const* node = this->Root.get();
+  for (unsigned int shift = 0; node; shift += BitsPerLevel) {
+    if (shift >= HashBits) {
+      for (Node::Leaf const& leaf : node->Leaves) {
+        if (leaf.Key == key) {
+          return leaf.Value;
+        }
+      }
+      break;
+    }
+    std::uint32_t const bit = SlotBit(hash, shift);
+    if (node->LeafMap & bit) {
+      Node::Leaf const& leaf = node->Leaves[SlotIndex(node->LeafMap, bit)];
+      if (leaf.Key.hash() == hash && leaf.Key == key) {
+        return leaf.Value;
+      }
+      break;
     }
+    if (!(node->ChildMap & bit)) {
+      break;
+    }
+    node = node->Children[SlotIndex(node->ChildMap, bit)].get();
   }
-  return false;
-}
-
-cmDefinitions cmDefinitions::MakeClosure(StackIter begin, StackIter end)
-{
-  cmDefinitions closure;
-  std::unordered_set<cm::string_view> undefined;
-  for (StackIter it = begin; it != end; ++it) {
-    // Consider local definitions.
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (closure.Map.find(mi.first) == closure.Map.end() &&
-          undefined.find(mi.first.view()) == undefined.end()) {
-        if (mi.second.Value) {
-          closure.Map.insert(mi);
-        } else {
-          undefined.emplace(mi.first.view());
+  return cmDefinitions::NoDef;
+}
+
+cmDefinitions::Def& cmDefinitions::Emplace(const std::string& key)
+{
+  cmInternedString const name(key);
+  std::size_t const hash = name.hash();
+  Node* node = &MakeUnique(this->Root);
+  for (unsigned int shift = 0;; shift += BitsPerLevel) {
+    if (shift >= HashBits) {
+      for (Node::Leaf& leaf : node->Leaves) {
+        if (leaf.Key == name) {
+          return leaf.Value;
         }
       }
+      node->Leaves.push_back(Node::Leaf{ name, Def() });
+      return node->Leaves.back().Value;
+    }
+    std::uint32_t const bit = SlotBit(hash, shift);
+    if (node->ChildMap & bit) {
+      node = &MakeUnique(node->Children[SlotIndex(node->ChildMap, bit)]);
+      continue;
+    }
+    std::size_t const index = SlotIndex(node->LeafMap, bit);
+    if (!(node->LeafMap & bit)) {
+      node->LeafMap |= bit;
+      node->Leaves.insert(node->Leaves.begin() + index,
+                          Node::Leaf{ name, Def() });
+      return node->Leaves[index].Value;
     }
+    if (node->Leaves[index].Key == name) {
+      return node->Leaves[index].Value;
+    }
+    // Another key uses this slot.  Move it down into a new subtree where
+    // the next bits of the hashes tell the keys apart.
+    auto child = std::make_shared<Node>();
+    unsigned int const childShift = shift + BitsPerLevel;
+    Node::Leaf& moved = node->Leaves[index];
+    if (childShift < HashBits) {
+      child->LeafMap = SlotBit(moved.Key.hash(), childShift);
+    }
+    child->Leaves.push_back(std::move(moved));
+    node->Leaves.erase(node->Leaves.begin() + index);
+    node->LeafMap &= ~bit;
+    node->ChildMap |= bit;
+    node->Children.insert(
+      node->Children.begin() + SlotIndex(node->ChildMap, bit), child);
+    node = child.get();
   }
-  return closure;
 }
 
-std::vector<std::string> cmDefinitions::ClosureKeys(StackIter begin,
-                                                    StackIter end)
+void cmDefinitions::ForEach(
+  std::function<void(cmInternedString const&, Def const&)> const& fn) const
 {
-  std::vector<std::string> defined;
-  std::unordered_set<cm::string_view> bound;
-
-  for (StackIter it = begin; it != end; ++it) {
-    defined.reserve(defined.size() + it->Map.size());
-    for (auto const& mi : it->Map) {
-      // Use this key if it is not already set or unset.
-      if (bound.emplace(mi.first.view()).second && mi.second.Value) {
-        defined.push_back(*mi.first.str_if_stable());
-      }
+  std::vector<Node const*> pending;
+  if (this->Root) {
+    pending.push_back(this->Root.get());
+  }
+  while (!pending.empty()) {
+    Node const* node = pending.back();
+    pending.pop_back();
+    for (Node::Leaf const& leaf : node->Leaves) {
+      fn(leaf.Key, leaf.Value);
+    }
+    for (std::shared_ptr<Node> const& child : node->Children) {
+      pending.push_back(child.get());
     }
   }
+}
+
+void cmDefinitions::MarkUsed(Def const& def) const
+{
+  if (def.Serial && def.UsedBy != this->ClosureId) {
+    this->Used->Serials.insert(def.Serial);
+    def.UsedBy = this->ClosureId;
+  }
+}
+
+const std::string* cmDefinitions::Get(const std::string& key) const
+{
+  Def const& def = this->Find(key);
+  this->MarkUsed(def);
+  return def.GetValue();
+}
+
+const std::vector<std::string>* cmDefinitions::GetList(
+  const std::string& key) const
+{
+  Def const& def = this->Find(key);
+  this->MarkUsed(def);
+  return def.GetList();
+}
+
+std::shared_ptr<cmDefinitions::List> cmDefinitions::TakeList(
+  const std::string& key)
+{
+  // Replace the definition so that we own the only reference, unless
+  // another scope still shares the elements.
+  Def& def = this->Emplace(key);
+  std::shared_ptr<List> elements = std::move(def.Elements);
+  this->Define(def, Def());
+  if (!elements) {
+    elements = std::make_shared<List>();
+  } else if (elements.use_count() > 1) {
+    elements = std::make_shared<List>(*elements);
+  }
+  def.Elements = elements;
+  def.ListChecked = true;
+  return elements;
+}
+
+bool cmDefinitions::Append(const std::string& key,
+                           std::vector<std::string>::const_iterator first,
+                           std::vector<std::string>::const_iterator last)
+{
+  if (!std::all_of(first, last, IsPlainListElement)) {
+    return false;
+  }
+  Def const& def = this->Find(key);
+  if (def.IsDefined() && !def.GetList()) {
+    return false;
+  }
+  std::shared_ptr<List> elements = this->TakeList(key);
+  elements->insert(elements->end(), first, last);
+  return true;
+}
 
+bool cmDefinitions::PopBack(const std::string& key, std::size_t count)
+{
+  List const* list = this->Find(key).GetList();
+  if (!list || list->size() < count) {
+    return false;
+  }
+  std::shared_ptr<List> elements = this->TakeList(key);
+  elements->erase(elements->end() - count, elements->end());
+  return true;
+}
+
+bool cmDefinitions::HasKey(const std::string& key) const
+{
+  Def const& def = this->Find(key);
+  // Unset keys inherited through a directory closure are not initialized.
+  return def.IsDefined() || def.Owner >= this->ClosureId;
+}
+
+std::vector<std::string> cmDefinitions::ClosureKeys() const
+{
+  std::vector<std::string> defined;
+  this->ForEach([&defined](cmInternedString const& key, Def const& def) {
+    if (def.IsDefined()) {
+      defined.push_back(key.str());
+    }
+  });
   return defined;
 }
 
+void cmDefinitions::Define(Def& def, Def value)
+{
+  def = std::move(value);
+  def.Owner = this->Id;
+  def.Serial = NextSerial++;
+}
+
 void cmDefinitions::Set(const std::string& key, cm::string_view value)
 {
-  this->Map[key] = Def(value);
+  this->Define(this->Emplace(key), Def(value));
 }
 
 void cmDefinitions::Unset(const std::string& key)
 {
-  this->Map[key] = Def();
+  this->Define(this->Emplace(key), Def());
 }
 
 std::vector<std::string> cmDefinitions::UnusedKeys() const
 {
   std::vector<std::string> keys;
-  keys.reserve(this->Map.size());
-  // Consider local definitions.
-  for (auto const& mi : this->Map) {
-    if (!mi.second.Used) {
-      keys.push_back(*mi.first.str_if_stable());
+  // Consider local definitions and, in a directory scope, those inherited
+  // from its parent directory.
+  bool const isClosure = this->Id == this->ClosureId;
+  this->ForEach([&](cmInternedString const& key, Def const& def) {
+    if ((def.Owner == this->Id ||
+         (isClosure && def.Owner < this->Id && def.IsDefined())) &&
+        !this->Used->Contains(def.Serial)) {
+      keys.push_back(key.str());
     }
-  }
+  });
   return keys;
 }
@@ -5,42 +5,60 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include <cm/string_view>
 
-#include "cmLinkedTree.h"
+#include "cmInternedString.h"
 #include "cmString.hxx"
 
 /** \class cmDefinitions
  * \brief Store a scope of variable definitions for CMake language.
  *
- * This stores the state of variable definitions (set or unset) for
- * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * This stores the state of variable definitions (set or unset) visible
+ * in one scope.  The definitions are kept in a persistent hash array
+ * mapped trie whose nodes are shared with the scope the definitions were
+ * inherited from, so creating a scope is O(1), gets never walk parent
+ * scopes, and sets copy only the path to the changed entry.
  */
 class cmDefinitions
 {
-  using StackIter = cmLinkedTree<cmDefinitions>::iterator;
-
 public:
-  // -- Static member functions
+  cmDefinitions();
+
+  /** Create a scope that starts with the definitions of this one.  */
+  cmDefinitions MakeChild() const;
+
+  /** Create a directory scope that starts with the definitions of this
+      one but does not consider unset keys to be initialized.  */
+  cmDefinitions MakeClosure() const;
 
-  static const std::string* Get(const std::string& key, StackIter begin,
-                                StackIter end);
+  const std::string* Get(const std::string& key) const;
 
-  static void Raise(const std::string& key, StackIter begin, StackIter end);
+  /** Get the elements of a list value without splitting its string.
+      Returns nullptr if the key is not defined or if the value has
+      elements that do not join back into the same string.  */
+  const std::vector<std::string>* GetList(const std::string& key) const;
 
-  static bool HasKey(const std::string& key, StackIter begin, StackIter end);
+  /** Append elements to a list value, as if the joined value were set.
+      Returns false without changing anything if the result cannot be
+      kept as a list of elements.  */
+  bool Append(const std::string& key,
+              std::vector<std::string>::const_iterator first,
+              std::vector<std::string>::const_iterator last);
 
-  static std::vector<std::string> ClosureKeys(StackIter begin, StackIter end);
+  /** Remove trailing elements from a list value.  Returns false without
+      changing anything if the value has no list of elements or has fewer
+      than the given count.  */
+  bool PopBack(const std::string& key, std::size_t count);
 
-  static cmDefinitions MakeClosure(StackIter begin, StackIter end);
+  bool HasKey(const std::string& key) const;
 
-  // -- Member functions
+  std::vector<std::string> ClosureKeys() const;
 
   /** Set a value associated with a key.  */
   void Set(const std::string& key, cm::string_view value);
@@ -52,7 +70,12 @@ public:
   std::vector<std::string> UnusedKeys() const;
 
 private:
-  /** String with existence boolean.  */
+  using List = std::vector<std::string>;
+
+  /** String with existence boolean.  A value may also hold its list
+      elements.  Either form is computed from the other on demand, and
+      the elements are shared between scopes until one of them is
+      modified.  */
   struct Def
   {
   public:
@@ -61,15 +84,45 @@ private:
       : Value(value)
     {
     }
-    cm::String Value;
-    bool Used = false;
+    bool IsDefined() const { return this->Value || this->Elements; }
+    const std::string* GetValue() const;
+    const List* GetList() const;
+    mutable cm::String Value;
+    mutable std::shared_ptr<List> Elements;
+    mutable bool ListChecked = false;
+    // Id of the scope that set or unset the key.
+    std::size_t Owner = 0;
+    // Unique id of this definition, which copies of it keep.
+    std::size_t Serial = 0;
+    // Id of the last directory scope that recorded a use of it.
+    mutable std::size_t UsedBy = 0;
   };
   static Def NoDef;
 
-  std::unordered_map<cm::String, Def> Map;
-
-  static Def const& GetInternal(const std::string& key, StackIter begin,
-                                StackIter end, bool raise);
+  struct Node;
+  struct Usage;
+
+  cmDefinitions(std::shared_ptr<Node> root, std::size_t closureId,
+                std::shared_ptr<Usage> used);
+
+  Def const& Find(const std::string& key) const;
+  Def& Emplace(const std::string& key);
+  std::shared_ptr<List> TakeList(const std::string& key);
+  void Define(Def& def, Def value);
+  void MarkUsed(Def const& def) const;
+  void ForEach(
+    std::function<void(cmInternedString const&, Def const&)> const& fn) const;
+
+  std::shared_ptr<Node> Root;
+  // Unique id of this scope.
+  std::size_t Id;
+  // Id of the directory scope this scope belongs to.  Definitions owned
+  // by older scopes were inherited through its closure.
+  std::size_t ClosureId;
+  // Definitions used in the directory scope, shared with its children.
+  // The trie nodes are shared between scopes, so uses are not recorded
+  // in them.
+  std::shared_ptr<Usage> Used;
 };
 
 #endif
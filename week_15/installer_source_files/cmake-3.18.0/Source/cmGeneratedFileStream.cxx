@@ -8,9 +8,42 @@
 #include "cmSystemTools.h"
 
 #if !defined(CMAKE_BOOTSTRAP)
+#  include <cassert>
+#  include <condition_variable>
+#  include <deque>
+#  include <functional>
+#  include <mutex>
+#  include <set>
+#  include <thread>
+#  include <utility>
+#  include <vector>
+
+#  include <cm/memory>
+
 #  include <cm3p/zlib.h>
 
 #  include "cm_codecvt.hxx"
+
+class cmGeneratedFileStreamDeferredCommit::Internals
+{
+public:
+  void Push(std::string const& tempName, std::function<void()> job);
+  void WaitFor(std::string const& tempName);
+  void Wait();
+  void Work();
+
+  std::mutex Mutex;
+  std::condition_variable JobQueued;
+  std::condition_variable JobDone;
+  std::deque<std::pair<std::string, std::function<void()>>> Jobs;
+  // Temporary file names of queued or running jobs.
+  std::multiset<std::string> Pending;
+  bool Stop = false;
+  std::vector<std::thread> Threads;
+};
+
+cmGeneratedFileStreamDeferredCommit::Internals*
+  cmGeneratedFileStreamDeferredCommit::Active = nullptr;
 #endif
 
 cmGeneratedFileStream::cmGeneratedFileStream(Encoding encoding)
@@ -127,6 +160,13 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
   this->TempName += ".tmp";
 #endif
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // A previous stream for the same file may still be queued.
+  if (cmGeneratedFileStreamDeferredCommit::Active) {
+    cmGeneratedFileStreamDeferredCommit::Active->WaitFor(this->TempName);
+  }
+#endif
+
   // Make sure the temporary file that will be used is not present.
   cmSystemTools::RemoveFile(this->TempName);
 
@@ -136,8 +176,6 @@ void cmGeneratedFileStreamBase::Open(std::string const& name)
 
 bool cmGeneratedFileStreamBase::Close()
 {
-  bool replaced = false;
-
   std::string resname = this->Name;
   if (this->Compress && this->CompressExtraExtension) {
     resname += ".gz";
@@ -145,19 +183,49 @@ bool cmGeneratedFileStreamBase::Close()
 
   // Only consider replacing the destination file if no error
   // occurred.
-  if (!this->Name.empty() && this->Okay &&
-      (!this->CopyIfDifferent ||
-       cmSystemTools::FilesDiffer(this->TempName, resname))) {
+  if (this->Name.empty() || !this->Okay) {
+    // Always delete the temporary file. We never want it to stay around.
+    cmSystemTools::RemoveFile(this->TempName);
+    return false;
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmGeneratedFileStreamDeferredCommit::Internals* deferred =
+        cmGeneratedFileStreamDeferredCommit::Active) {
+    // This stream may have been closed before.
+    deferred->WaitFor(this->TempName);
+
+    std::string tempName = this->TempName;
+    bool copyIfDifferent = this->CopyIfDifferent;
+    bool compress = this->Compress;
+    deferred->Push(tempName, [tempName, resname, copyIfDifferent, compress]() {
+      Commit(tempName, resname, copyIfDifferent, compress);
+    });
+    return true;
+  }
+#endif
+
+  return Commit(this->TempName, resname, this->CopyIfDifferent,
+                this->Compress);
+}
+
+bool cmGeneratedFileStreamBase::Commit(std::string const& tempName,
+                                       std::string const& resName,
+                                       bool copyIfDifferent, bool compress)
+{
+  bool replaced = false;
+
+  if (!copyIfDifferent || cmSystemTools::FilesDiffer(tempName, resName)) {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
-    if (this->Compress) {
-      std::string gzname = cmStrCat(this->TempName, ".temp.gz");
-      if (this->CompressFile(this->TempName, gzname)) {
-        this->RenameFile(gzname, resname);
+    if (compress) {
+      std::string gzname = cmStrCat(tempName, ".temp.gz");
+      if (CompressFile(tempName, gzname)) {
+        RenameFile(gzname, resName);
       }
       cmSystemTools::RemoveFile(gzname);
     } else {
-      this->RenameFile(this->TempName, resname);
+      RenameFile(tempName, resName);
     }
 
     replaced = true;
@@ -166,7 +234,7 @@ bool cmGeneratedFileStreamBase::Close()
   // Else, the destination was not replaced.
   //
   // Always delete the temporary file. We never want it to stay around.
-  cmSystemTools::RemoveFile(this->TempName);
+  cmSystemTools::RemoveFile(tempName);
 
   return replaced;
 }
@@ -216,3 +284,86 @@ void cmGeneratedFileStream::SetName(const std::string& fname)
 {
   this->Name = fname;
 }
+
+#if !defined(CMAKE_BOOTSTRAP)
+cmGeneratedFileStreamDeferredCommit::cmGeneratedFileStreamDeferredCommit(
+  unsigned int threadCount)
+  : Internal(cm::make_unique<Internals>())
+{
+  assert(!Active);
+  if (threadCount < 1) {
+    threadCount = 1;
+  }
+  Internals* internal = this->Internal.get();
+  for (unsigned int i = 0; i < threadCount; ++i) {
+    internal->Threads.emplace_back([internal]() { internal->Work(); });
+  }
+  Active = internal;
+}
+
+cmGeneratedFileStreamDeferredCommit::~cmGeneratedFileStreamDeferredCommit()
+{
+  this->Wait();
+  Active = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->Stop = true;
+  }
+  this->Internal->JobQueued.notify_all();
+  for (std::thread& thread : this->Internal->Threads) {
+    thread.join();
+  }
+}
+
+void cmGeneratedFileStreamDeferredCommit::Wait()
+{
+  this->Internal->Wait();
+}
+
+void cmGeneratedFileStreamDeferredCommit::Internals::Push(
+  std::string const& tempName, std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Pending.insert(tempName);
+    this->Jobs.emplace_back(tempName, std::move(job));
+  }
+  this->JobQueued.notify_one();
+}
+
+void cmGeneratedFileStreamDeferredCommit::Internals::WaitFor(
+  std::string const& tempName)
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->JobDone.wait(
+    lock, [this, &tempName]() { return this->Pending.count(tempName) == 0; });
+}
+
+void cmGeneratedFileStreamDeferredCommit::Internals::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->JobDone.wait(lock, [this]() { return this->Pending.empty(); });
+}
+
+void cmGeneratedFileStreamDeferredCommit::Internals::Work()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;) {
+    this->JobQueued.wait(
+      lock, [this]() { return this->Stop || !this->Jobs.empty(); });
+    if (this->Jobs.empty()) {
+      return;
+    }
+    std::pair<std::string, std::function<void()>> job =
+      std::move(this->Jobs.front());
+    this->Jobs.pop_front();
+
+    lock.unlock();
+    job.second();
+    lock.lock();
+
+    this->Pending.erase(this->Pending.find(job.first));
+    this->JobDone.notify_all();
+  }
+}
+#endif
@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <memory>
 #include <string>
 
 #include "cmsys/FStream.hxx"
@@ -35,10 +36,17 @@ protected:
   bool Close();
 
   // Internal file replacement implementation.
-  int RenameFile(std::string const& oldname, std::string const& newname);
+  static int RenameFile(std::string const& oldname,
+                        std::string const& newname);
 
   // Internal file compression implementation.
-  int CompressFile(std::string const& oldname, std::string const& newname);
+  static int CompressFile(std::string const& oldname,
+                          std::string const& newname);
+
+  // Replace the destination file with the temporary file, if needed,
+  // and always remove the temporary file.
+  static bool Commit(std::string const& tempName, std::string const& resName,
+                     bool copyIfDifferent, bool compress);
 
   // The name of the final destination file for the output.
   std::string Name;
@@ -140,4 +148,38 @@ public:
   void SetName(const std::string& fname);
 };
 
+#if !defined(CMAKE_BOOTSTRAP)
+/** \class cmGeneratedFileStreamDeferredCommit
+ * \brief Replace generated files on worker threads.
+ *
+ * While an instance exists, closing a cmGeneratedFileStream only queues
+ * the comparison with and replacement of the destination file, which a
+ * pool of worker threads then performs.  Close() reports every queued
+ * file as replaced, so this may only be used around code that ignores
+ * its result.  The destructor waits for all queued files.
+ */
+class cmGeneratedFileStreamDeferredCommit
+{
+public:
+  cmGeneratedFileStreamDeferredCommit(unsigned int threadCount);
+  ~cmGeneratedFileStreamDeferredCommit();
+
+  cmGeneratedFileStreamDeferredCommit(
+    cmGeneratedFileStreamDeferredCommit const&) = delete;
+  cmGeneratedFileStreamDeferredCommit& operator=(
+    cmGeneratedFileStreamDeferredCommit const&) = delete;
+
+  /** Wait until all queued files have been replaced.  */
+  void Wait();
+
+private:
+  friend class cmGeneratedFileStreamBase;
+  class Internals;
+  std::unique_ptr<Internals> Internal;
+
+  // The instance that queues files, if any.
+  static Internals* Active;
+};
+#endif
+
 #endif
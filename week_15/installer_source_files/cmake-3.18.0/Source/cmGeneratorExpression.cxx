@@ -2,10 +2,18 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGeneratorExpression.h"
 
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
+#include <cm/string_view>
+
 #include "cmsys/RegularExpression.hxx"
 
 #include "cmGeneratorExpressionContext.h"
@@ -13,8 +21,84 @@
 #include "cmGeneratorExpressionEvaluator.h"
 #include "cmGeneratorExpressionLexer.h"
 #include "cmGeneratorExpressionParser.h"
+#include "cmLocalGenerator.h"
+#include "cmMessenger.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmMakefileProfilingData.h"
+#endif
+
+/** The syntax tree of one input string.  Its nodes are allocated in the
+    arena and point into the input, which is kept here for them.  */
+struct cmParsedGeneratorExpression
+{
+  std::string Input;
+  bool NeedsEvaluation = false;
+  cmGeneratorExpressionArena Arena;
+  cmGeneratorExpressionEvaluatorVector Evaluators;
+};
+
+namespace {
+struct ParsedExpressionTable
+{
+  std::mutex Mutex;
+  // Keys view the inputs of the parsed expressions, which never move.
+  std::unordered_map<cm::string_view,
+                     std::shared_ptr<cmParsedGeneratorExpression const>>
+    Entries;
+  // Number of global generators using the table.
+  std::size_t Users = 0;
+};
+
+ParsedExpressionTable& GetParsedExpressionTable()
+{
+  // The table is intentionally leaked so that it outlives compiled
+  // expressions held by static objects.
+  static ParsedExpressionTable* table = new ParsedExpressionTable;
+  return *table;
+}
+
+// Lex and parse an input at most once for the whole process.
+std::shared_ptr<cmParsedGeneratorExpression const> ParseExpression(
+  std::string const& input)
+{
+  ParsedExpressionTable& table = GetParsedExpressionTable();
+  std::lock_guard<std::mutex> lock(table.Mutex);
+  auto it = table.Entries.find(input);
+  if (it != table.Entries.end()) {
+    return it->second;
+  }
+
+  auto parsed = std::make_shared<cmParsedGeneratorExpression>();
+  parsed->Input = input;
+  cmGeneratorExpressionLexer l;
+  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(parsed->Input);
+  parsed->NeedsEvaluation = l.GetSawGeneratorExpression();
+  if (parsed->NeedsEvaluation) {
+    cmGeneratorExpressionParser p(tokens, parsed->Arena);
+    p.Parse(parsed->Evaluators);
+  }
+  table.Entries.emplace(cm::string_view(parsed->Input), parsed);
+  return parsed;
+}
+
+// Bumped to drop the evaluations remembered by compiled expressions.
+std::atomic<std::size_t> EvaluationCachesStamp(0);
+
+// Expressions of widely used targets are evaluated for many heads.  Keep
+// the memory used by any one of them bounded.
+std::size_t const MaxCachedEvaluations = 256;
+
+unsigned int IssuedMessageCount(cmGeneratorExpressionContext const& context)
+{
+  return context.LG
+    ? context.LG->GetCMakeInstance()->GetMessenger()->GetIssuedMessageCount()
+    : 0;
+}
+}
 
 cmGeneratorExpression::cmGeneratorExpression(cmListFileBacktrace backtrace)
   : Backtrace(std::move(backtrace))
@@ -68,9 +152,39 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
     return this->Input;
   }
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // Group the evaluation time by the property being evaluated.
+  static std::string const noProperty = "(none)";
+  cmMakefileProfilingData::Scope profilingScope(
+    context.LG ? context.LG->GetCMakeInstance() : nullptr, "genex",
+    dagChecker ? dagChecker->GetProperty() : noProperty);
+#endif
+
+  // Results obtained below another expression depend on the DAG checkers
+  // of the enclosing evaluation and are not cached.
+  bool const cacheable = !dagChecker || dagChecker->Top() == dagChecker;
+  if (cacheable) {
+    if (CachedEvaluation const* cached =
+          this->FindCachedEvaluation(context, dagChecker)) {
+      this->Output = cached->Output;
+      this->DependTargets = cached->DependTargets;
+      this->AllTargetsSeen = cached->AllTargetsSeen;
+      this->MaxLanguageStandard = cached->MaxLanguageStandard;
+      this->HadContextSensitiveCondition =
+        cached->HadContextSensitiveCondition;
+      this->HadHeadSensitiveCondition = cached->HadHeadSensitiveCondition;
+      this->HadLinkLanguageSensitiveCondition = false;
+      this->SourceSensitiveTargets = cached->SourceSensitiveTargets;
+      return this->Output;
+    }
+  }
+  unsigned int const nestedCount =
+    dagChecker ? dagChecker->GetNestedCount() : 0;
+  unsigned int const messageCount = IssuedMessageCount(context);
+
   this->Output.clear();
 
-  for (const auto& it : this->Evaluators) {
+  for (cmGeneratorExpressionEvaluator const* it : this->Parsed->Evaluators) {
     this->Output += it->Evaluate(&context, dagChecker);
 
     this->SeenTargetProperties.insert(context.SeenTargetProperties.cbegin(),
@@ -93,9 +207,130 @@ const std::string& cmCompiledGeneratorExpression::EvaluateWithContext(
 
   this->DependTargets = context.DependTargets;
   this->AllTargetsSeen = context.AllTargets;
+
+  // Nested DAG checkers may have depended on, or recorded, properties
+  // seen by earlier evaluations under the same checker.  The link
+  // language may still be in the middle of being computed.  Evaluations
+  // that issued a diagnostic must do so again when repeated.
+  if (cacheable && !context.HadError &&
+      !context.HadLinkLanguageSensitiveCondition &&
+      (!dagChecker || dagChecker->GetNestedCount() == nestedCount) &&
+      IssuedMessageCount(context) == messageCount &&
+      !cmSystemTools::GetErrorOccuredFlag()) {
+    this->CacheEvaluation(context, dagChecker);
+  }
   return this->Output;
 }
 
+bool cmCompiledGeneratorExpression::EvaluationKey::operator==(
+  EvaluationKey const& other) const
+{
+  return this->LG == other.LG && this->AnyConfig == other.AnyConfig &&
+    this->HeadTarget == other.HeadTarget &&
+    this->CurrentTarget == other.CurrentTarget &&
+    this->HasDAGChecker == other.HasDAGChecker &&
+    this->DAGTarget == other.DAGTarget &&
+    this->DAGTransitivePropertiesOnly == other.DAGTransitivePropertiesOnly &&
+    this->Config == other.Config && this->Language == other.Language &&
+    this->DAGProperty == other.DAGProperty;
+}
+
+std::size_t cmCompiledGeneratorExpression::EvaluationKeyHash::operator()(
+  EvaluationKey const& key) const
+{
+  std::hash<void const*> hashPointer;
+  std::hash<std::string> hashString;
+  std::size_t result = hashPointer(key.LG);
+  for (std::size_t h :
+       { hashString(key.Config), hashPointer(key.HeadTarget),
+         hashPointer(key.CurrentTarget), hashString(key.Language),
+         hashPointer(key.DAGTarget), hashString(key.DAGProperty) }) {
+    result = result * 31 + h;
+  }
+  return result * 8 + (key.AnyConfig ? 4 : 0) + (key.HasDAGChecker ? 2 : 0) +
+    (key.DAGTransitivePropertiesOnly ? 1 : 0);
+}
+
+cmCompiledGeneratorExpression::EvaluationKey
+cmCompiledGeneratorExpression::MakeEvaluationKey(
+  cmGeneratorExpressionContext const& context,
+  cmGeneratorExpressionDAGChecker const* dagChecker)
+{
+  EvaluationKey key;
+  key.LG = context.LG;
+  key.Config = context.Config;
+  key.AnyConfig = false;
+  key.HeadTarget = context.HeadTarget;
+  key.CurrentTarget = context.CurrentTarget;
+  key.Language = context.Language;
+  key.HasDAGChecker = dagChecker != nullptr;
+  key.DAGTarget = dagChecker ? dagChecker->TopTarget() : nullptr;
+  if (dagChecker) {
+    key.DAGProperty = dagChecker->GetProperty();
+  }
+  key.DAGTransitivePropertiesOnly =
+    dagChecker && dagChecker->GetTransitivePropertiesOnly();
+  return key;
+}
+
+cmCompiledGeneratorExpression::CachedEvaluation const*
+cmCompiledGeneratorExpression::FindCachedEvaluation(
+  cmGeneratorExpressionContext const& context,
+  cmGeneratorExpressionDAGChecker const* dagChecker) const
+{
+  if (this->EvaluationCache.empty()) {
+    return nullptr;
+  }
+  if (this->EvaluationCacheStamp != EvaluationCachesStamp) {
+    this->EvaluationCache.clear();
+    return nullptr;
+  }
+
+  EvaluationKey key = MakeEvaluationKey(context, dagChecker);
+  auto i = this->EvaluationCache.find(key);
+  if (i == this->EvaluationCache.end()) {
+    key.Config.clear();
+    key.AnyConfig = true;
+    i = this->EvaluationCache.find(key);
+  }
+  return i != this->EvaluationCache.end() ? &i->second : nullptr;
+}
+
+void cmCompiledGeneratorExpression::CacheEvaluation(
+  cmGeneratorExpressionContext const& context,
+  cmGeneratorExpressionDAGChecker const* dagChecker) const
+{
+  std::size_t const stamp = EvaluationCachesStamp;
+  if (this->EvaluationCacheStamp != stamp ||
+      this->EvaluationCache.size() >= MaxCachedEvaluations) {
+    this->EvaluationCache.clear();
+    this->EvaluationCacheStamp = stamp;
+  }
+
+  EvaluationKey key = MakeEvaluationKey(context, dagChecker);
+  // Only $<CONFIG> and friends set HadContextSensitiveCondition.  Target
+  // properties may be configuration-dependent without doing so.
+  if (!context.HadContextSensitiveCondition &&
+      !context.HadHeadSensitiveCondition && context.AllTargets.empty()) {
+    key.Config.clear();
+    key.AnyConfig = true;
+  }
+
+  CachedEvaluation& entry = this->EvaluationCache[std::move(key)];
+  entry.Output = this->Output;
+  entry.DependTargets = this->DependTargets;
+  entry.AllTargetsSeen = this->AllTargetsSeen;
+  entry.MaxLanguageStandard = this->MaxLanguageStandard;
+  entry.HadContextSensitiveCondition = this->HadContextSensitiveCondition;
+  entry.HadHeadSensitiveCondition = this->HadHeadSensitiveCondition;
+  entry.SourceSensitiveTargets = this->SourceSensitiveTargets;
+}
+
+void cmCompiledGeneratorExpression::InvalidateEvaluationCaches()
+{
+  ++EvaluationCachesStamp;
+}
+
 cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   cmListFileBacktrace backtrace, std::string input)
   : Backtrace(std::move(backtrace))
@@ -105,14 +340,31 @@ cmCompiledGeneratorExpression::cmCompiledGeneratorExpression(
   , HadContextSensitiveCondition(false)
   , HadHeadSensitiveCondition(false)
   , HadLinkLanguageSensitiveCondition(false)
+  , EvaluationCacheStamp(0)
 {
-  cmGeneratorExpressionLexer l;
-  std::vector<cmGeneratorExpressionToken> tokens = l.Tokenize(this->Input);
-  this->NeedsEvaluation = l.GetSawGeneratorExpression();
-
+  // Plain strings are never lexed or parsed.
+  this->NeedsEvaluation =
+    cmGeneratorExpression::Find(this->Input) != std::string::npos;
   if (this->NeedsEvaluation) {
-    cmGeneratorExpressionParser p(tokens);
-    p.Parse(this->Evaluators);
+    this->Parsed = ParseExpression(this->Input);
+    this->NeedsEvaluation = this->Parsed->NeedsEvaluation;
+  }
+}
+
+void cmGeneratorExpression::RetainParsedExpressions()
+{
+  ParsedExpressionTable& table = GetParsedExpressionTable();
+  std::lock_guard<std::mutex> lock(table.Mutex);
+  ++table.Users;
+}
+
+void cmGeneratorExpression::ReleaseParsedExpressions()
+{
+  ParsedExpressionTable& table = GetParsedExpressionTable();
+  std::lock_guard<std::mutex> lock(table.Mutex);
+  assert(table.Users > 0);
+  if (--table.Users == 0) {
+    table.Entries.clear();
   }
 }
 
@@ -5,10 +5,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -19,7 +21,7 @@ class cmGeneratorTarget;
 class cmLocalGenerator;
 struct cmGeneratorExpressionContext;
 struct cmGeneratorExpressionDAGChecker;
-struct cmGeneratorExpressionEvaluator;
+struct cmParsedGeneratorExpression;
 
 /** \class cmGeneratorExpression
  * \brief Evaluate generate-time query expression syntax.
@@ -82,6 +84,14 @@ public:
   static void ReplaceInstallPrefix(std::string& input,
                                    const std::string& replacement);
 
+  /** Keep the table of parsed expressions shared by Parse while a global
+      generator uses it.  Generators of in-process try_compile projects
+      share the table with the outer project, so it is only dropped when
+      the last generator releases it.  Compiled expressions keep the trees
+      they already use.  */
+  static void RetainParsedExpressions();
+  static void ReleaseParsedExpressions();
+
 private:
   cmListFileBacktrace Backtrace;
 };
@@ -141,6 +151,7 @@ public:
   void SetEvaluateForBuildsystem(bool eval)
   {
     this->EvaluateForBuildsystem = eval;
+    this->EvaluationCache.clear();
   }
 
   void SetQuiet(bool quiet) { this->Quiet = quiet; }
@@ -148,6 +159,10 @@ public:
   void GetMaxLanguageStandard(cmGeneratorTarget const* tgt,
                               std::map<std::string, std::string>& mapping);
 
+  /** Forget the evaluations remembered by all compiled expressions.
+      Called when generation starts and whenever a target changes.  */
+  static void InvalidateEvaluationCaches();
+
 private:
   const std::string& EvaluateWithContext(
     cmGeneratorExpressionContext& context,
@@ -156,10 +171,58 @@ private:
   cmCompiledGeneratorExpression(cmListFileBacktrace backtrace,
                                 std::string input);
 
+  // The context of an evaluation.  Results that do not depend on the
+  // configuration are stored with AnyConfig set and an empty Config.
+  struct EvaluationKey
+  {
+    cmLocalGenerator const* LG;
+    std::string Config;
+    bool AnyConfig;
+    cmGeneratorTarget const* HeadTarget;
+    cmGeneratorTarget const* CurrentTarget;
+    std::string Language;
+    bool HasDAGChecker;
+    cmGeneratorTarget const* DAGTarget;
+    std::string DAGProperty;
+    bool DAGTransitivePropertiesOnly;
+
+    bool operator==(EvaluationKey const& other) const;
+  };
+
+  struct EvaluationKeyHash
+  {
+    std::size_t operator()(EvaluationKey const& key) const;
+  };
+
+  // The result of a previous evaluation.
+  struct CachedEvaluation
+  {
+    std::string Output;
+    std::set<cmGeneratorTarget*> DependTargets;
+    std::set<cmGeneratorTarget const*> AllTargetsSeen;
+    std::map<cmGeneratorTarget const*, std::map<std::string, std::string>>
+      MaxLanguageStandard;
+    bool HadContextSensitiveCondition;
+    bool HadHeadSensitiveCondition;
+    std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+  };
+
+  static EvaluationKey MakeEvaluationKey(
+    cmGeneratorExpressionContext const& context,
+    cmGeneratorExpressionDAGChecker const* dagChecker);
+  CachedEvaluation const* FindCachedEvaluation(
+    cmGeneratorExpressionContext const& context,
+    cmGeneratorExpressionDAGChecker const* dagChecker) const;
+  void CacheEvaluation(
+    cmGeneratorExpressionContext const& context,
+    cmGeneratorExpressionDAGChecker const* dagChecker) const;
+
   friend class cmGeneratorExpression;
 
   cmListFileBacktrace Backtrace;
-  std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>> Evaluators;
+  // Parsed trees are immutable and shared by all expressions compiled
+  // from the same input.  Null if the input has no generator expression.
+  std::shared_ptr<cmParsedGeneratorExpression const> Parsed;
   const std::string Input;
   bool NeedsEvaluation;
   bool EvaluateForBuildsystem;
@@ -176,6 +239,11 @@ private:
   mutable bool HadHeadSensitiveCondition;
   mutable bool HadLinkLanguageSensitiveCondition;
   mutable std::set<cmGeneratorTarget const*> SourceSensitiveTargets;
+  mutable std::unordered_map<EvaluationKey, CachedEvaluation,
+                             EvaluationKeyHash>
+    EvaluationCache;
+  // The invalidation count EvaluationCache was filled under.
+  mutable std::size_t EvaluationCacheStamp;
 };
 
 class cmGeneratorExpressionInterpreter
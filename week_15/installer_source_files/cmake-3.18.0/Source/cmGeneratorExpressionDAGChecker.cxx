@@ -48,25 +48,65 @@ cmGeneratorExpressionDAGChecker::cmGeneratorExpressionDAGChecker(
 void cmGeneratorExpressionDAGChecker::Initialize()
 {
   const auto* top = this->Top();
+  if (top != this) {
+    ++top->NestedCount;
+  }
   this->CheckResult = this->CheckGraph();
 
-#define TEST_TRANSITIVE_PROPERTY_METHOD(METHOD) top->METHOD() ||
-
-  if (CheckResult == DAG &&
-      (CM_FOR_EACH_TRANSITIVE_PROPERTY_METHOD(
-        TEST_TRANSITIVE_PROPERTY_METHOD) false)) // NOLINT(*)
-#undef TEST_TRANSITIVE_PROPERTY_METHOD
-  {
+  if (CheckResult == DAG && this->TracksSeenProperties()) {
     auto it = top->Seen.find(this->Target);
     if (it != top->Seen.end()) {
       const std::set<std::string>& propSet = it->second;
       if (propSet.find(this->Property) != propSet.end()) {
         this->CheckResult = ALREADY_SEEN;
+        ++top->RejectedCount;
         return;
       }
     }
     top->Seen[this->Target].insert(this->Property);
+    top->SeenOrder.emplace_back(this->Target, this->Property);
+  }
+  if (CheckResult != DAG) {
+    ++top->RejectedCount;
+  }
+}
+
+bool cmGeneratorExpressionDAGChecker::TracksSeenProperties() const
+{
+  const auto* top = this->Top();
+
+#define TEST_TRANSITIVE_PROPERTY_METHOD(METHOD) top->METHOD() ||
+
+  return CM_FOR_EACH_TRANSITIVE_PROPERTY_METHOD(
+    TEST_TRANSITIVE_PROPERTY_METHOD) false; // NOLINT(*)
+#undef TEST_TRANSITIVE_PROPERTY_METHOD
+}
+
+std::vector<cmGeneratorExpressionDAGChecker::SeenEntry>
+cmGeneratorExpressionDAGChecker::GetSeenSince(std::size_t count) const
+{
+  const auto* top = this->Top();
+  return std::vector<SeenEntry>(top->SeenOrder.begin() + count,
+                                top->SeenOrder.end());
+}
+
+bool cmGeneratorExpressionDAGChecker::MarkSeen(
+  std::vector<SeenEntry> const& entries) const
+{
+  const auto* top = this->Top();
+  for (SeenEntry const& entry : entries) {
+    auto it = top->Seen.find(entry.first);
+    if (it != top->Seen.end() && it->second.count(entry.second)) {
+      return false;
+    }
+  }
+  for (SeenEntry const& entry : entries) {
+    top->Seen[entry.first].insert(entry.second);
+    top->SeenOrder.push_back(entry);
   }
+  // The entries stand in for checkers that were never created.
+  top->NestedCount += static_cast<unsigned int>(entries.size());
+  return true;
 }
 
 cmGeneratorExpressionDAGChecker::Result
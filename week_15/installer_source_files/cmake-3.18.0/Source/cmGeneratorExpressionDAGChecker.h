@@ -5,9 +5,12 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "cmListFileCache.h"
 
@@ -84,6 +87,34 @@ struct cmGeneratorExpressionDAGChecker
 
   cmGeneratorExpressionDAGChecker const* Top() const;
   cmGeneratorTarget const* TopTarget() const;
+  std::string const& GetProperty() const { return this->Property; }
+
+  /** Number of checkers created so far with this one as their top.  */
+  unsigned int GetNestedCount() const { return this->NestedCount; }
+
+  /** Number of checkers created so far beneath the top that were not
+      part of the DAG, i.e. were skipped or reported as a loop.  */
+  unsigned int GetRejectedCount() const
+  {
+    return this->Top()->RejectedCount;
+  }
+
+  using SeenEntry = std::pair<cmGeneratorTarget const*, std::string>;
+
+  /** Whether the top checker evaluates each transitive property of a
+      target at most once, remembering those it has seen.  */
+  bool TracksSeenProperties() const;
+
+  /** Number of entries the top checker has remembered as seen.  */
+  std::size_t GetSeenCount() const { return this->Top()->SeenOrder.size(); }
+
+  /** Entries the top checker remembered since it had seen count entries.  */
+  std::vector<SeenEntry> GetSeenSince(std::size_t count) const;
+
+  /** Remember entries as seen, as if a checker had been created for each
+      of them.  Returns false and remembers nothing if one of them has
+      been seen already.  */
+  bool MarkSeen(std::vector<SeenEntry> const& entries) const;
 
 private:
   Result CheckGraph() const;
@@ -94,6 +125,9 @@ private:
   cmGeneratorTarget const* Target;
   const std::string Property;
   mutable std::map<cmGeneratorTarget const*, std::set<std::string>> Seen;
+  mutable std::vector<SeenEntry> SeenOrder;
+  mutable unsigned int NestedCount = 0;
+  mutable unsigned int RejectedCount = 0;
   const GeneratorExpressionContent* const Content;
   const cmListFileBacktrace Backtrace;
   Result CheckResult;
@@ -6,7 +6,7 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <cstddef>
-#include <memory>
+#include <deque>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,8 +37,9 @@ struct cmGeneratorExpressionEvaluator
                                cmGeneratorExpressionDAGChecker*) const = 0;
 };
 
+// Nodes are owned by the cmGeneratorExpressionArena they were created in.
 using cmGeneratorExpressionEvaluatorVector =
-  std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>>;
+  std::vector<cmGeneratorExpressionEvaluator*>;
 
 struct TextContent : public cmGeneratorExpressionEvaluator
 {
@@ -116,4 +117,32 @@ private:
   size_t ContentLength;
 };
 
+/** \class cmGeneratorExpressionArena
+ * \brief Owns the nodes of a parsed generator expression.
+ *
+ * Nodes of each kind are stored together in chunks rather than in
+ * separate heap allocations.  They never move and are all destroyed
+ * with the arena.
+ */
+class cmGeneratorExpressionArena
+{
+public:
+  TextContent* NewText(const char* start, size_t length)
+  {
+    this->Texts.emplace_back(start, length);
+    return &this->Texts.back();
+  }
+
+  GeneratorExpressionContent* NewContent(const char* startContent,
+                                         size_t length)
+  {
+    this->Contents.emplace_back(startContent, length);
+    return &this->Contents.back();
+  }
+
+private:
+  std::deque<TextContent> Texts;
+  std::deque<GeneratorExpressionContent> Contents;
+};
+
 #endif
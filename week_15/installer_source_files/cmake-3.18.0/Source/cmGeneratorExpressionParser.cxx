@@ -6,15 +6,15 @@
 #include <cstddef>
 #include <utility>
 
-#include <cm/memory>
 #include <cmext/algorithm>
-#include <cmext/memory>
 
 #include "cmGeneratorExpressionEvaluator.h"
 
 cmGeneratorExpressionParser::cmGeneratorExpressionParser(
-  std::vector<cmGeneratorExpressionToken> tokens)
+  std::vector<cmGeneratorExpressionToken> tokens,
+  cmGeneratorExpressionArena& arena)
   : Tokens(std::move(tokens))
+  , Arena(arena)
   , NestingLevel(0)
 {
 }
@@ -30,17 +30,16 @@ void cmGeneratorExpressionParser::Parse(
 }
 
 static void extendText(
+  cmGeneratorExpressionArena& arena,
   cmGeneratorExpressionEvaluatorVector& result,
   std::vector<cmGeneratorExpressionToken>::const_iterator it)
 {
   if (!result.empty() &&
       (*(result.end() - 1))->GetType() ==
         cmGeneratorExpressionEvaluator::Text) {
-    cm::static_reference_cast<TextContent>(*(result.end() - 1))
-      .Extend(it->Length);
+    static_cast<TextContent*>(*(result.end() - 1))->Extend(it->Length);
   } else {
-    auto textContent = cm::make_unique<TextContent>(it->Content, it->Length);
-    result.push_back(std::move(textContent));
+    result.push_back(arena.NewText(it->Content, it->Length));
   }
 }
 
@@ -52,9 +51,8 @@ static void extendResult(
       (*(result.end() - 1))->GetType() ==
         cmGeneratorExpressionEvaluator::Text &&
       contents.front()->GetType() == cmGeneratorExpressionEvaluator::Text) {
-    cm::static_reference_cast<TextContent>(*(result.end() - 1))
-      .Extend(
-        cm::static_reference_cast<TextContent>(contents.front()).GetLength());
+    static_cast<TextContent*>(*(result.end() - 1))
+      ->Extend(static_cast<TextContent*>(contents.front())->GetLength());
     contents.erase(contents.begin());
   }
   cm::append(result, std::move(contents));
@@ -73,7 +71,7 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
   while (this->it->TokenType != cmGeneratorExpressionToken::EndExpression &&
          this->it->TokenType != cmGeneratorExpressionToken::ColonSeparator) {
     if (this->it->TokenType == cmGeneratorExpressionToken::CommaSeparator) {
-      extendText(identifier, this->it);
+      extendText(this->Arena, identifier, this->it);
       ++this->it;
     } else {
       this->ParseContent(identifier);
@@ -88,14 +86,14 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
 
   if (this->it != this->Tokens.end() &&
       this->it->TokenType == cmGeneratorExpressionToken::EndExpression) {
-    auto content = cm::make_unique<GeneratorExpressionContent>(
+    GeneratorExpressionContent* content = this->Arena.NewContent(
       startToken->Content,
       this->it->Content - startToken->Content + this->it->Length);
     assert(this->it != this->Tokens.end());
     ++this->it;
     --this->NestingLevel;
     content->SetIdentifier(std::move(identifier));
-    result.push_back(std::move(content));
+    result.push_back(content);
     return;
   }
 
@@ -128,7 +126,7 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
     }
     while (this->it != this->Tokens.end() &&
            this->it->TokenType == cmGeneratorExpressionToken::ColonSeparator) {
-      extendText(*(parameters.end() - 1), this->it);
+      extendText(this->Arena, *(parameters.end() - 1), this->it);
       assert(this->it != this->Tokens.end());
       ++this->it;
     }
@@ -152,7 +150,7 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
       while (this->it != this->Tokens.end() &&
              this->it->TokenType ==
                cmGeneratorExpressionToken::ColonSeparator) {
-        extendText(*(parameters.end() - 1), this->it);
+        extendText(this->Arena, *(parameters.end() - 1), this->it);
         assert(this->it != this->Tokens.end());
         ++this->it;
       }
@@ -169,10 +167,10 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
     // There was a '$<' in the text, but no corresponding '>'. Rebuild to
     // treat the '$<' as having been plain text, along with the
     // corresponding : and , tokens that might have been found.
-    extendText(result, startToken);
+    extendText(this->Arena, result, startToken);
     extendResult(result, std::move(identifier));
     if (!parameters.empty()) {
-      extendText(result, colonToken);
+      extendText(this->Arena, result, colonToken);
 
       auto pit = parameters.begin();
       const auto pend = parameters.end();
@@ -183,7 +181,7 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
           extendResult(result, std::move(*pit));
         }
         if (commaIt != commaTokens.end()) {
-          extendText(result, *commaIt);
+          extendText(this->Arena, result, *commaIt);
         } else {
           break;
         }
@@ -194,11 +192,11 @@ void cmGeneratorExpressionParser::ParseGeneratorExpression(
 
   size_t contentLength =
     ((this->it - 1)->Content - startToken->Content) + (this->it - 1)->Length;
-  auto content = cm::make_unique<GeneratorExpressionContent>(
-    startToken->Content, contentLength);
+  GeneratorExpressionContent* content =
+    this->Arena.NewContent(startToken->Content, contentLength);
   content->SetIdentifier(std::move(identifier));
   content->SetParameters(std::move(parameters));
-  result.push_back(std::move(content));
+  result.push_back(content);
 }
 
 void cmGeneratorExpressionParser::ParseContent(
@@ -214,16 +212,15 @@ void cmGeneratorExpressionParser::ParseContent(
           // A comma in 'plain text' could have split text that should
           // otherwise be continuous. Extend the last text content instead of
           // creating a new one.
-          cm::static_reference_cast<TextContent>(*(result.end() - 1))
-            .Extend(this->it->Length);
+          static_cast<TextContent*>(*(result.end() - 1))
+            ->Extend(this->it->Length);
           assert(this->it != this->Tokens.end());
           ++this->it;
           return;
         }
       }
-      auto n =
-        cm::make_unique<TextContent>(this->it->Content, this->it->Length);
-      result.push_back(std::move(n));
+      result.push_back(
+        this->Arena.NewText(this->it->Content, this->it->Length));
       assert(this->it != this->Tokens.end());
       ++this->it;
       return;
@@ -237,7 +234,7 @@ void cmGeneratorExpressionParser::ParseContent(
     case cmGeneratorExpressionToken::ColonSeparator:
     case cmGeneratorExpressionToken::CommaSeparator:
       if (this->NestingLevel == 0) {
-        extendText(result, this->it);
+        extendText(this->Arena, result, this->it);
       } else {
         assert(false && "Got unexpected syntax token.");
       }
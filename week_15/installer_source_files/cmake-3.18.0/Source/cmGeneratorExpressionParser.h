@@ -5,19 +5,20 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
-#include <memory>
 #include <vector>
 
 #include "cmGeneratorExpressionLexer.h"
 
+class cmGeneratorExpressionArena;
 struct cmGeneratorExpressionEvaluator;
 
 struct cmGeneratorExpressionParser
 {
-  cmGeneratorExpressionParser(std::vector<cmGeneratorExpressionToken> tokens);
+  cmGeneratorExpressionParser(std::vector<cmGeneratorExpressionToken> tokens,
+                              cmGeneratorExpressionArena& arena);
 
   using cmGeneratorExpressionEvaluatorVector =
-    std::vector<std::unique_ptr<cmGeneratorExpressionEvaluator>>;
+    std::vector<cmGeneratorExpressionEvaluator*>;
 
   void Parse(cmGeneratorExpressionEvaluatorVector& result);
 
@@ -28,6 +29,7 @@ private:
 private:
   std::vector<cmGeneratorExpressionToken>::const_iterator it;
   const std::vector<cmGeneratorExpressionToken> Tokens;
+  cmGeneratorExpressionArena& Arena;
   unsigned int NestingLevel;
 };
 
@@ -37,6 +37,7 @@
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmMessageType.h"
+#include "cmMessenger.h"
 #include "cmOutputConverter.h"
 #include "cmPropertyMap.h"
 #include "cmRange.h"
@@ -692,10 +693,15 @@ const char* cmGeneratorTarget::GetFileSuffixInternal(
   return targetSuffix ? targetSuffix->c_str() : nullptr;
 }
 
+std::size_t cmGeneratorTarget::GetConfigIndex(std::string const& config) const
+{
+  return this->GlobalGenerator->GetConfigIndex(config);
+}
+
 void cmGeneratorTarget::ClearSourcesCache()
 {
   this->AllConfigSources.clear();
-  this->KindedSourcesMap.clear();
+  this->KindedSourcesMap.Clear();
   this->LinkImplementationLanguageIsContextDependent = true;
   this->Objects.clear();
   this->VisitedConfigsForObjects.clear();
@@ -1078,21 +1084,16 @@ bool cmGeneratorTarget::IsSystemIncludeDirectory(
   const std::string& language) const
 {
   assert(this->GetType() != cmStateEnums::INTERFACE_LIBRARY);
-  std::string config_upper;
-  if (!config.empty()) {
-    config_upper = cmSystemTools::UpperCase(config);
-  }
+  std::pair<std::vector<std::string>*, bool> const entry =
+    this->SystemIncludesCache.Emplace(this->GetConfigIndex(config));
+  std::vector<std::string>& result = *entry.first;
 
-  using IncludeCacheType = std::map<std::string, std::vector<std::string>>;
-  auto iter = this->SystemIncludesCache.find(config_upper);
-
-  if (iter == this->SystemIncludesCache.end()) {
+  if (entry.second) {
     cmGeneratorExpressionDAGChecker dagChecker(
       this, "SYSTEM_INCLUDE_DIRECTORIES", nullptr, nullptr);
 
     bool excludeImported = this->GetPropertyAsBool("NO_SYSTEM_FROM_IMPORTED");
 
-    std::vector<std::string> result;
     for (std::string const& it : this->Target->GetSystemIncludeDirectories()) {
       cmExpandList(cmGeneratorExpression::Evaluate(it, this->LocalGenerator,
                                                    config, this, &dagChecker,
@@ -1111,12 +1112,9 @@ bool cmGeneratorTarget::IsSystemIncludeDirectory(
                   cmSystemTools::ConvertToUnixSlashes);
     std::sort(result.begin(), result.end());
     result.erase(std::unique(result.begin(), result.end()), result.end());
-
-    IncludeCacheType::value_type entry(config_upper, result);
-    iter = this->SystemIncludesCache.insert(entry).first;
   }
 
-  return std::binary_search(iter->second.begin(), iter->second.end(), dir);
+  return std::binary_search(result.begin(), result.end(), dir);
 }
 
 bool cmGeneratorTarget::GetPropertyAsBool(const std::string& prop) const
@@ -1173,14 +1171,104 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
   cmGeneratorExpressionDAGChecker* dagCheckerParent,
   bool usage_requirements_only) const
 {
-  std::string result;
-
   // If the property does not appear transitively at all, we are done.
   if (!this->MaybeHaveInterfaceProperty(prop, context,
                                         usage_requirements_only)) {
-    return result;
+    return std::string();
   }
 
+  // A closure can only be shared when the walk evaluates each transitive
+  // property once.  Then the closure is exactly what this walk would
+  // compute, provided it has seen none of the pairs the closure visited.
+  // Link interfaces that are not usage requirements only may still be
+  // recomputed once the link language is known.
+  if (!dagCheckerParent || !dagCheckerParent->TracksSeenProperties() ||
+      !usage_requirements_only) {
+    return this->EvaluateInterfacePropertyClosure(prop, context,
+                                                  dagCheckerParent,
+                                                  usage_requirements_only);
+  }
+
+  // $<DEVICE_LINK> and $<HOST_LINK> depend on whether the head target is
+  // being device linked.
+  cmGeneratorExpressionDAGChecker const* top = dagCheckerParent->Top();
+  bool const deviceLink =
+    context->HeadTarget && context->HeadTarget->IsDeviceLink();
+  std::string key = cmStrCat(prop, ';', context->Language, ';',
+                             top->GetProperty(), ';',
+                             top->GetTransitivePropertiesOnly() ? '1' : '0',
+                             context->Quiet ? '1' : '0',
+                             context->EvaluateForBuildsystem ? '1' : '0',
+                             deviceLink ? '1' : '0');
+  std::map<InterfaceClosureKey, InterfaceClosure>& closures =
+    this->InterfaceClosures[this->GetConfigIndex(context->Config)];
+  auto i = closures.find(InterfaceClosureKey(context->LG, key));
+  if (i != closures.end()) {
+    if (dagCheckerParent->MarkSeen(i->second.Seen)) {
+      context->HadContextSensitiveCondition =
+        context->HadContextSensitiveCondition ||
+        i->second.HadContextSensitiveCondition;
+      return i->second.Value;
+    }
+    return this->EvaluateInterfacePropertyClosure(prop, context,
+                                                  dagCheckerParent,
+                                                  usage_requirements_only);
+  }
+
+  // Evaluate with fresh condition flags to see what this closure alone
+  // depends on.
+  bool const hadContextSensitiveCondition =
+    context->HadContextSensitiveCondition;
+  bool const hadHeadSensitiveCondition = context->HadHeadSensitiveCondition;
+  bool const hadLinkLanguageSensitiveCondition =
+    context->HadLinkLanguageSensitiveCondition;
+  bool const hadError = context->HadError;
+  context->HadContextSensitiveCondition = false;
+  context->HadHeadSensitiveCondition = false;
+  context->HadLinkLanguageSensitiveCondition = false;
+  context->HadError = false;
+  std::size_t const seenCount = dagCheckerParent->GetSeenCount();
+  unsigned int const rejectedCount = dagCheckerParent->GetRejectedCount();
+  cmMessenger* messenger =
+    this->GetLocalGenerator()->GetCMakeInstance()->GetMessenger();
+  unsigned int const messageCount = messenger->GetIssuedMessageCount();
+
+  std::string result = this->EvaluateInterfacePropertyClosure(
+    prop, context, dagCheckerParent, usage_requirements_only);
+
+  // Loops, properties skipped because the walk had already seen them and
+  // diagnostics all make the result specific to this walk.
+  if (!context->HadHeadSensitiveCondition &&
+      !context->HadLinkLanguageSensitiveCondition && !context->HadError &&
+      dagCheckerParent->GetRejectedCount() == rejectedCount &&
+      messenger->GetIssuedMessageCount() == messageCount &&
+      !cmSystemTools::GetErrorOccuredFlag()) {
+    InterfaceClosure& closure =
+      closures[InterfaceClosureKey(context->LG, std::move(key))];
+    closure.Value = result;
+    closure.HadContextSensitiveCondition =
+      context->HadContextSensitiveCondition;
+    closure.Seen = dagCheckerParent->GetSeenSince(seenCount);
+  }
+
+  context->HadContextSensitiveCondition =
+    context->HadContextSensitiveCondition || hadContextSensitiveCondition;
+  context->HadHeadSensitiveCondition =
+    context->HadHeadSensitiveCondition || hadHeadSensitiveCondition;
+  context->HadLinkLanguageSensitiveCondition =
+    context->HadLinkLanguageSensitiveCondition ||
+    hadLinkLanguageSensitiveCondition;
+  context->HadError = context->HadError || hadError;
+  return result;
+}
+
+std::string cmGeneratorTarget::EvaluateInterfacePropertyClosure(
+  std::string const& prop, cmGeneratorExpressionContext* context,
+  cmGeneratorExpressionDAGChecker* dagCheckerParent,
+  bool usage_requirements_only) const
+{
+  std::string result;
+
   // Evaluate $<TARGET_PROPERTY:this,prop> as if it were compiled.  This is
   // a subset of TargetPropertyNode::Evaluate without stringify/parse steps
   // but sufficient for transitive interface properties.
@@ -1213,6 +1301,8 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
     context->HadContextSensitiveCondition =
       context->HadContextSensitiveCondition ||
       iface->HadContextSensitiveCondition;
+    context->HadHeadSensitiveCondition =
+      context->HadHeadSensitiveCondition || iface->HadHeadSensitiveCondition;
     for (cmLinkItem const& lib : iface->Libraries) {
       // Broken code can have a target in its own link interface.
       // Don't follow such link interface entries so as not to create a
@@ -1243,6 +1333,9 @@ std::string cmGeneratorTarget::EvaluateInterfaceProperty(
         context->HadHeadSensitiveCondition =
           context->HadHeadSensitiveCondition ||
           libContext.HadHeadSensitiveCondition;
+        context->HadLinkLanguageSensitiveCondition =
+          context->HadLinkLanguageSensitiveCondition ||
+          libContext.HadLinkLanguageSensitiveCondition;
       }
     }
   }
@@ -1606,14 +1699,13 @@ cmGeneratorTarget::KindedSources const& cmGeneratorTarget::GetKindedSources(
   // If we already processed one configuration and found no dependenc
   // on configuration then always use the one result.
   if (!this->LinkImplementationLanguageIsContextDependent) {
-    return this->KindedSourcesMap.begin()->second;
+    return *this->KindedSourcesMap.First();
   }
 
   // Lookup any existing link implementation for this configuration.
-  std::string const key = cmSystemTools::UpperCase(config);
-  auto it = this->KindedSourcesMap.find(key);
-  if (it != this->KindedSourcesMap.end()) {
-    if (!it->second.Initialized) {
+  std::size_t const key = this->GetConfigIndex(config);
+  if (KindedSources const* it = this->KindedSourcesMap.Find(key)) {
+    if (!it->Initialized) {
       std::ostringstream e;
       e << "The SOURCES of \"" << this->GetName()
         << "\" use a generator expression that depends on the "
@@ -1623,7 +1715,7 @@ cmGeneratorTarget::KindedSources const& cmGeneratorTarget::GetKindedSources(
       static KindedSources empty;
       return empty;
     }
-    return it->second;
+    return *it;
   }
 
   // Add an entry to the map for this configuration.
@@ -2382,15 +2474,15 @@ private:
 cmGeneratorTarget::LinkClosure const* cmGeneratorTarget::GetLinkClosure(
   const std::string& config) const
 {
-  std::string key(cmSystemTools::UpperCase(config));
-  auto i = this->LinkClosureMap.find(key);
-  if (i == this->LinkClosureMap.end()) {
-    LinkClosure lc;
-    this->ComputeLinkClosure(config, lc);
-    LinkClosureMapType::value_type entry(key, lc);
-    i = this->LinkClosureMap.insert(entry).first;
+  std::size_t const key = this->GetConfigIndex(config);
+  LinkClosure* lc = this->LinkClosureMap.Find(key);
+  if (!lc) {
+    LinkClosure closure;
+    this->ComputeLinkClosure(config, closure);
+    lc = &this->LinkClosureMap[key];
+    *lc = std::move(closure);
   }
-  return &i->second;
+  return lc;
 }
 
 class cmTargetSelectLinker
@@ -2595,18 +2687,13 @@ cmGeneratorTarget::CompileInfo const* cmGeneratorTarget::GetCompileInfo(
   }
 
   // Lookup/compute/cache the compile information for this configuration.
-  std::string config_upper;
-  if (!config.empty()) {
-    config_upper = cmSystemTools::UpperCase(config);
-  }
-  auto i = this->CompileInfoMap.find(config_upper);
-  if (i == this->CompileInfoMap.end()) {
-    CompileInfo info;
-    this->ComputePDBOutputDir("COMPILE_PDB", config, info.CompilePdbDir);
-    CompileInfoMapType::value_type entry(config_upper, info);
-    i = this->CompileInfoMap.insert(entry).first;
+  std::pair<CompileInfo*, bool> const entry =
+    this->CompileInfoMap.Emplace(this->GetConfigIndex(config));
+  if (entry.second) {
+    this->ComputePDBOutputDir("COMPILE_PDB", config,
+                              entry.first->CompilePdbDir);
   }
-  return &i->second;
+  return entry.first;
 }
 
 cmGeneratorTarget::ModuleDefinitionInfo const*
@@ -2620,18 +2707,15 @@ cmGeneratorTarget::GetModuleDefinitionInfo(std::string const& config) const
   }
 
   // Lookup/compute/cache the compile information for this configuration.
-  std::string config_upper;
-  if (!config.empty()) {
-    config_upper = cmSystemTools::UpperCase(config);
-  }
-  auto i = this->ModuleDefinitionInfoMap.find(config_upper);
-  if (i == this->ModuleDefinitionInfoMap.end()) {
-    ModuleDefinitionInfo info;
-    this->ComputeModuleDefinitionInfo(config, info);
-    ModuleDefinitionInfoMapType::value_type entry(config_upper, info);
-    i = this->ModuleDefinitionInfoMap.insert(entry).first;
+  std::size_t const key = this->GetConfigIndex(config);
+  ModuleDefinitionInfo* info = this->ModuleDefinitionInfoMap.Find(key);
+  if (!info) {
+    ModuleDefinitionInfo computed;
+    this->ComputeModuleDefinitionInfo(config, computed);
+    info = &this->ModuleDefinitionInfoMap[key];
+    *info = std::move(computed);
   }
-  return &i->second;
+  return info;
 }
 
 void cmGeneratorTarget::ComputeModuleDefinitionInfo(
@@ -2698,7 +2782,8 @@ const std::vector<const cmGeneratorTarget*>&
 cmGeneratorTarget::GetLinkImplementationClosure(
   const std::string& config) const
 {
-  LinkImplClosure& tgts = this->LinkImplClosureMap[config];
+  LinkImplClosure& tgts =
+    this->LinkImplClosureMap[this->GetConfigIndex(config)];
   if (!tgts.Done) {
     tgts.Done = true;
     std::set<cmGeneratorTarget const*> emitted;
@@ -3701,7 +3786,8 @@ std::string cmGeneratorTarget::GetPchHeader(const std::string& config,
     generatorTarget->GetProperty("PRECOMPILE_HEADERS_REUSE_FROM");
 
   const auto inserted =
-    this->PchHeaders.insert(std::make_pair(language + config + arch, ""));
+    this->PchHeaders[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     const std::vector<BT<std::string>> headers =
       this->GetPrecompileHeaders(config, language);
@@ -3801,7 +3887,8 @@ std::string cmGeneratorTarget::GetPchSource(const std::string& config,
     return std::string();
   }
   const auto inserted =
-    this->PchSources.insert(std::make_pair(language + config + arch, ""));
+    this->PchSources[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     const std::string pchHeader = this->GetPchHeader(config, language, arch);
     if (pchHeader.empty()) {
@@ -3863,7 +3950,8 @@ std::string cmGeneratorTarget::GetPchFileObject(const std::string& config,
     return std::string();
   }
   const auto inserted =
-    this->PchObjectFiles.insert(std::make_pair(language + config + arch, ""));
+    this->PchObjectFiles[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     const std::string pchSource = this->GetPchSource(config, language, arch);
     if (pchSource.empty()) {
@@ -3888,7 +3976,8 @@ std::string cmGeneratorTarget::GetPchFile(const std::string& config,
                                           const std::string& arch)
 {
   const auto inserted =
-    this->PchFiles.insert(std::make_pair(language + config + arch, ""));
+    this->PchFiles[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     std::string& pchFile = inserted.first->second;
 
@@ -3932,8 +4021,9 @@ std::string cmGeneratorTarget::GetPchCreateCompileOptions(
   const std::string& config, const std::string& language,
   const std::string& arch)
 {
-  const auto inserted = this->PchCreateCompileOptions.insert(
-    std::make_pair(language + config + arch, ""));
+  const auto inserted =
+    this->PchCreateCompileOptions[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     std::string& createOptionList = inserted.first->second;
 
@@ -3961,8 +4051,9 @@ std::string cmGeneratorTarget::GetPchUseCompileOptions(
   const std::string& config, const std::string& language,
   const std::string& arch)
 {
-  const auto inserted = this->PchUseCompileOptions.insert(
-    std::make_pair(language + config + arch, ""));
+  const auto inserted =
+    this->PchUseCompileOptions[this->GetConfigIndex(config)].insert(
+      std::make_pair(language + arch, ""));
   if (inserted.second) {
     std::string& useOptionList = inserted.first->second;
 
@@ -4936,7 +5027,7 @@ const cmGeneratorTarget::CompatibleInterfacesBase&
 cmGeneratorTarget::GetCompatibleInterfaces(std::string const& config) const
 {
   cmGeneratorTarget::CompatibleInterfaces& compat =
-    this->CompatibleInterfacesMap[config];
+    this->CompatibleInterfacesMap[this->GetConfigIndex(config)];
   if (!compat.Done) {
     compat.Done = true;
     compat.PropsBool.insert("POSITION_INDEPENDENT_CODE");
@@ -5645,9 +5736,10 @@ cmComputeLinkInformation* cmGeneratorTarget::GetLinkInformation(
   const std::string& config) const
 {
   // Lookup any existing information for this configuration.
-  std::string key(cmSystemTools::UpperCase(config));
-  auto i = this->LinkInformation.find(key);
-  if (i == this->LinkInformation.end()) {
+  std::size_t const key = this->GetConfigIndex(config);
+  std::unique_ptr<cmComputeLinkInformation>* i =
+    this->LinkInformation.Find(key);
+  if (!i) {
     // Compute information for this configuration.
     auto info = cm::make_unique<cmComputeLinkInformation>(this, config);
     if (info && !info->Compute()) {
@@ -5655,13 +5747,14 @@ cmComputeLinkInformation* cmGeneratorTarget::GetLinkInformation(
     }
 
     // Store the information for this configuration.
-    i = this->LinkInformation.emplace(key, std::move(info)).first;
+    i = &this->LinkInformation[key];
+    *i = std::move(info);
 
-    if (i->second) {
-      this->CheckPropertyCompatibility(*i->second, config);
+    if (*i) {
+      this->CheckPropertyCompatibility(**i, config);
     }
   }
-  return i->second.get();
+  return i->get();
 }
 
 void cmGeneratorTarget::GetTargetVersion(int& major, int& minor) const
@@ -6114,16 +6207,11 @@ cmGeneratorTarget::OutputInfo const* cmGeneratorTarget::GetOutputInfo(
   }
 
   // Lookup/compute/cache the output information for this configuration.
-  std::string config_upper;
-  if (!config.empty()) {
-    config_upper = cmSystemTools::UpperCase(config);
-  }
-  auto i = this->OutputInfoMap.find(config_upper);
-  if (i == this->OutputInfoMap.end()) {
-    // Add empty info in map to detect potential recursion.
+  // Adding an empty entry first detects potential recursion.
+  std::pair<OutputInfo*, bool> const entry =
+    this->OutputInfoMap.Emplace(this->GetConfigIndex(config));
+  if (entry.second) {
     OutputInfo info;
-    OutputInfoMapType::value_type entry(config_upper, info);
-    i = this->OutputInfoMap.insert(entry).first;
 
     // Compute output directories.
     this->ComputeOutputDir(config, cmStateEnums::RuntimeBinaryArtifact,
@@ -6135,8 +6223,8 @@ cmGeneratorTarget::OutputInfo const* cmGeneratorTarget::GetOutputInfo(
     }
 
     // Now update the previously-prepared map entry.
-    i->second = info;
-  } else if (i->second.empty()) {
+    *entry.first = info;
+  } else if (entry.first->empty()) {
     // An empty map entry indicates we have been called recursively
     // from the above block.
     this->LocalGenerator->GetCMakeInstance()->IssueMessage(
@@ -6145,7 +6233,7 @@ cmGeneratorTarget::OutputInfo const* cmGeneratorTarget::GetOutputInfo(
       this->GetBacktrace());
     return nullptr;
   }
-  return &i->second;
+  return entry.first;
 }
 
 bool cmGeneratorTarget::ComputeOutputDir(const std::string& config,
@@ -6515,32 +6603,32 @@ cmGeneratorTarget::ImportInfo const* cmGeneratorTarget::GetImportInfo(
 
   // Lookup/compute/cache the import information for this
   // configuration.
-  std::string config_upper;
-  if (!config.empty()) {
-    config_upper = cmSystemTools::UpperCase(config);
-  } else {
-    config_upper = "NOCONFIG";
-  }
-
-  auto i = this->ImportInfoMap.find(config_upper);
-  if (i == this->ImportInfoMap.end()) {
-    ImportInfo info;
-    this->ComputeImportInfo(config_upper, info);
-    ImportInfoMapType::value_type entry(config_upper, info);
-    i = this->ImportInfoMap.insert(entry).first;
+  std::size_t const key = this->GetConfigIndex(config);
+  ImportInfo* info = this->ImportInfoMap.Find(key);
+  if (!info) {
+    std::string config_upper;
+    if (!config.empty()) {
+      config_upper = cmSystemTools::UpperCase(config);
+    } else {
+      config_upper = "NOCONFIG";
+    }
+    ImportInfo computed;
+    this->ComputeImportInfo(config_upper, computed);
+    info = &this->ImportInfoMap[key];
+    *info = std::move(computed);
   }
 
   if (this->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
-    return &i->second;
+    return info;
   }
   // If the location is empty then the target is not available for
   // this configuration.
-  if (i->second.Location.empty() && i->second.ImportLibrary.empty()) {
+  if (info->Location.empty() && info->ImportLibrary.empty()) {
     return nullptr;
   }
 
   // Return the import information.
-  return &i->second;
+  return info;
 }
 
 void cmGeneratorTarget::ComputeImportInfo(std::string const& desired_config,
@@ -6686,15 +6774,15 @@ void cmGeneratorTarget::ComputeImportInfo(std::string const& desired_config,
 cmHeadToLinkInterfaceMap& cmGeneratorTarget::GetHeadToLinkInterfaceMap(
   const std::string& config) const
 {
-  return this->LinkInterfaceMap[cmSystemTools::UpperCase(config)];
+  return this->LinkInterfaceMap[this->GetConfigIndex(config)];
 }
 
 cmHeadToLinkInterfaceMap&
 cmGeneratorTarget::GetHeadToLinkInterfaceUsageRequirementsMap(
   const std::string& config) const
 {
-  return this
-    ->LinkInterfaceUsageRequirementsOnlyMap[cmSystemTools::UpperCase(config)];
+  return this->LinkInterfaceUsageRequirementsOnlyMap[this->GetConfigIndex(
+    config)];
 }
 
 const cmLinkImplementation* cmGeneratorTarget::GetLinkImplementation(
@@ -6712,7 +6800,7 @@ const cmLinkImplementation* cmGeneratorTarget::GetLinkImplementation(
   }
 
   cmOptionalLinkImplementation& impl =
-    this->LinkImplMap[cmSystemTools::UpperCase(config)][this];
+    this->LinkImplMap[this->GetConfigIndex(config)][this];
   if (secondPass) {
     impl = cmOptionalLinkImplementation();
   }
@@ -6972,7 +7060,7 @@ cmGeneratorTarget::GetLinkImplementationLibrariesInternal(
 
   // Populate the link implementation libraries for this configuration.
   HeadToLinkImplementationMap& hm =
-    this->LinkImplMap[cmSystemTools::UpperCase(config)];
+    this->LinkImplMap[this->GetConfigIndex(config)];
 
   // If the link implementation does not depend on the head target
   // then return the one we computed first.
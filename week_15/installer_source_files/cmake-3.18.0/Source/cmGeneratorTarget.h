@@ -17,6 +17,7 @@
 
 #include "cmLinkItem.h"
 #include "cmListFileCache.h"
+#include "cmPerConfig.h"
 #include "cmPolicies.h"
 #include "cmProperty.h"
 #include "cmStateTypes.h"
@@ -574,8 +575,7 @@ public:
 
   CompileInfo const* GetCompileInfo(const std::string& config) const;
 
-  using CompileInfoMapType = std::map<std::string, CompileInfo>;
-  mutable CompileInfoMapType CompileInfoMap;
+  mutable cmPerConfig<CompileInfo> CompileInfoMap;
 
   bool IsNullImpliedByLinkLibraries(const std::string& p) const;
 
@@ -793,6 +793,9 @@ public:
 private:
   void AddSourceCommon(const std::string& src, bool before = false);
 
+  // Index of the configuration in the per-configuration caches below.
+  std::size_t GetConfigIndex(std::string const& config) const;
+
   std::string CreateFortranModuleDirectory(
     std::string const& working_dir) const;
   mutable bool FortranModuleDirectoryCreated;
@@ -808,7 +811,7 @@ private:
   mutable std::set<std::string> VisitedConfigsForObjects;
   mutable std::map<cmSourceFile const*, std::string> Objects;
   std::set<cmSourceFile const*> ExplicitObjectName;
-  mutable std::map<std::string, std::vector<std::string>> SystemIncludesCache;
+  mutable cmPerConfig<std::vector<std::string>> SystemIncludesCache;
 
   mutable std::string ExportMacro;
 
@@ -835,8 +838,7 @@ private:
                            std::string& outSuffix) const;
 
   mutable std::string LinkerLanguage;
-  using LinkClosureMapType = std::map<std::string, LinkClosure>;
-  mutable LinkClosureMapType LinkClosureMap;
+  mutable cmPerConfig<LinkClosure> LinkClosureMap;
   bool DeviceLink = false;
 
   // Returns ARCHIVE, LIBRARY, or RUNTIME based on platform and type.
@@ -861,11 +863,10 @@ private:
   {
     bool Done = false;
   };
-  mutable std::map<std::string, CompatibleInterfaces> CompatibleInterfacesMap;
+  mutable cmPerConfig<CompatibleInterfaces> CompatibleInterfacesMap;
 
-  using cmTargetLinkInformationMap =
-    std::map<std::string, std::unique_ptr<cmComputeLinkInformation>>;
-  mutable cmTargetLinkInformationMap LinkInformation;
+  mutable cmPerConfig<std::unique_ptr<cmComputeLinkInformation>>
+    LinkInformation;
 
   void CheckPropertyCompatibility(cmComputeLinkInformation& info,
                                   const std::string& config) const;
@@ -878,11 +879,11 @@ private:
   {
     bool Done = false;
   };
-  mutable std::map<std::string, LinkImplClosure> LinkImplClosureMap;
+  mutable cmPerConfig<LinkImplClosure> LinkImplClosureMap;
 
-  using LinkInterfaceMapType = std::map<std::string, cmHeadToLinkInterfaceMap>;
-  mutable LinkInterfaceMapType LinkInterfaceMap;
-  mutable LinkInterfaceMapType LinkInterfaceUsageRequirementsOnlyMap;
+  mutable cmPerConfig<cmHeadToLinkInterfaceMap> LinkInterfaceMap;
+  mutable cmPerConfig<cmHeadToLinkInterfaceMap>
+    LinkInterfaceUsageRequirementsOnlyMap;
 
   cmHeadToLinkInterfaceMap& GetHeadToLinkInterfaceMap(
     std::string const& config) const;
@@ -919,8 +920,7 @@ private:
     std::string SharedDeps;
   };
 
-  using ImportInfoMapType = std::map<std::string, ImportInfo>;
-  mutable ImportInfoMapType ImportInfoMap;
+  mutable cmPerConfig<ImportInfo> ImportInfoMap;
   void ComputeImportInfo(std::string const& desired_config,
                          ImportInfo& info) const;
   ImportInfo const* GetImportInfo(const std::string& config) const;
@@ -934,8 +934,7 @@ private:
                                                 bool usage_requirements_only,
                                                 bool secondPass = false) const;
 
-  using KindedSourcesMapType = std::map<std::string, KindedSources>;
-  mutable KindedSourcesMapType KindedSourcesMap;
+  mutable cmPerConfig<KindedSources> KindedSourcesMap;
   void ComputeKindedSources(KindedSources& files,
                             std::string const& config) const;
 
@@ -947,6 +946,25 @@ private:
                                   cmGeneratorExpressionContext* context,
                                   bool usage_requirements_only) const;
 
+  // The evaluated transitive closure of an INTERFACE_* property of this
+  // target, shared by every consumer in the same directory whose walk
+  // does not depend on the head target.
+  struct InterfaceClosure
+  {
+    std::string Value;
+    bool HadContextSensitiveCondition = false;
+    // The (target, property) pairs the closure's DAG checkers visited.
+    std::vector<std::pair<cmGeneratorTarget const*, std::string>> Seen;
+  };
+  using InterfaceClosureKey =
+    std::pair<cmLocalGenerator const*, std::string>;
+  mutable cmPerConfig<std::map<InterfaceClosureKey, InterfaceClosure>>
+    InterfaceClosures;
+  std::string EvaluateInterfacePropertyClosure(
+    std::string const& prop, cmGeneratorExpressionContext* context,
+    cmGeneratorExpressionDAGChecker* dagCheckerParent,
+    bool usage_requirements_only) const;
+
   using TargetPropertyEntryVector =
     std::vector<std::unique_ptr<TargetPropertyEntry>>;
 
@@ -959,12 +977,14 @@ private:
   TargetPropertyEntryVector PrecompileHeadersEntries;
   TargetPropertyEntryVector SourceEntries;
   mutable std::set<std::string> LinkImplicitNullProperties;
-  mutable std::map<std::string, std::string> PchHeaders;
-  mutable std::map<std::string, std::string> PchSources;
-  mutable std::map<std::string, std::string> PchObjectFiles;
-  mutable std::map<std::string, std::string> PchFiles;
-  mutable std::map<std::string, std::string> PchCreateCompileOptions;
-  mutable std::map<std::string, std::string> PchUseCompileOptions;
+  // Precompiled header caches, keyed by language and architecture.
+  using PchMap = std::map<std::string, std::string>;
+  mutable cmPerConfig<PchMap> PchHeaders;
+  mutable cmPerConfig<PchMap> PchSources;
+  mutable cmPerConfig<PchMap> PchObjectFiles;
+  mutable cmPerConfig<PchMap> PchFiles;
+  mutable cmPerConfig<PchMap> PchCreateCompileOptions;
+  mutable cmPerConfig<PchMap> PchUseCompileOptions;
 
   std::unordered_set<std::string> UnityBatchedSourceFiles;
 
@@ -994,8 +1014,7 @@ private:
     : public std::map<cmGeneratorTarget const*, cmOptionalLinkImplementation>
   {
   };
-  using LinkImplMapType = std::map<std::string, HeadToLinkImplementationMap>;
-  mutable LinkImplMapType LinkImplMap;
+  mutable cmPerConfig<HeadToLinkImplementationMap> LinkImplMap;
 
   cmLinkImplementationLibraries const* GetLinkImplementationLibrariesInternal(
     const std::string& config, const cmGeneratorTarget* head) const;
@@ -1003,12 +1022,9 @@ private:
                         cmStateEnums::ArtifactType artifact,
                         std::string& out) const;
 
-  using OutputInfoMapType = std::map<std::string, OutputInfo>;
-  mutable OutputInfoMapType OutputInfoMap;
+  mutable cmPerConfig<OutputInfo> OutputInfoMap;
 
-  using ModuleDefinitionInfoMapType =
-    std::map<std::string, ModuleDefinitionInfo>;
-  mutable ModuleDefinitionInfoMapType ModuleDefinitionInfoMap;
+  mutable cmPerConfig<ModuleDefinitionInfo> ModuleDefinitionInfoMap;
   void ComputeModuleDefinitionInfo(std::string const& config,
                                    ModuleDefinitionInfo& info) const;
 
@@ -2,16 +2,188 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmGlobVerificationManager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <sstream>
 
+#include <cm/string_view>
+
+#include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
+#include "cmsys/Glob.hxx"
+#include "cmsys/RegularExpression.hxx"
 
+#include "cmFileTime.h"
 #include "cmGeneratedFileStream.h"
 #include "cmListFileCache.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
 #include "cmVersion.h"
 
+namespace {
+// First line of the state file.  Bump the version whenever the format
+// changes so that older state is ignored in favor of the script.
+const char* const StateFileSignature = "cmake_verify_globs 1";
+
+// A directory modified this close to the time it was recorded may be
+// modified again without its time changing on file systems with coarse
+// time stamps.  Such a directory is always re-globbed.
+const cmFileTime::NSC RacyInterval = 2 * cmFileTime::NsPerS;
+const long long RacyMTime = -1;
+
+// The current time in the units and epoch of cmFileTime.
+cmFileTime::NSC CurrentFileTime()
+{
+  cmFileTime::NSC now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  // Windows file times count from 1601 rather than 1970.
+  now += 11644473600LL * cmFileTime::NsPerS;
+#endif
+  return now;
+}
+
+// Walk the directories cmsys::Glob lists to evaluate an expression,
+// recording each of them.  This follows Glob::ProcessDirectory and
+// Glob::RecurseDirectory.
+class DirectoryRecorder
+{
+public:
+  DirectoryRecorder(bool recurse, bool followSymlinks)
+    : Recurse(recurse)
+    , FollowSymlinks(followSymlinks)
+  {
+  }
+
+  std::vector<std::string> Directories;
+
+  void Find(const std::string& expression)
+  {
+    std::string::size_type lastSlash = 0;
+    for (std::string::size_type cc = 0; cc < expression.size(); ++cc) {
+      char const ch = expression[cc];
+      if (cc > 0 && ch == '/' && expression[cc - 1] != '\\') {
+        lastSlash = cc;
+      }
+      if (cc > 0 && (ch == '[' || ch == '?' || ch == '*') &&
+          expression[cc - 1] != '\\') {
+        break;
+      }
+    }
+    std::string::size_type skip = lastSlash;
+    if (skip == 0 && expression.size() > 1 && expression[1] == ':' &&
+        expression[0] != '/') {
+      skip = 2;
+    }
+
+    for (std::string const& component :
+         cmTokenize(expression.substr(skip), "/")) {
+      if (!component.empty()) {
+        this->Expressions.emplace_back(
+          cmsys::Glob::PatternToRegex(component));
+      }
+    }
+    if (this->Expressions.empty()) {
+      return;
+    }
+    this->ProcessDirectory(
+      0, skip > 0 ? expression.substr(0, skip) + "/" : std::string("/"));
+  }
+
+private:
+  bool Recurse;
+  bool FollowSymlinks;
+  std::vector<cmsys::RegularExpression> Expressions;
+  std::vector<std::string> VisitedSymlinks;
+
+  static std::string JoinPath(const std::string& dir, const std::string& name)
+  {
+    if (!dir.empty() && dir.back() == '/') {
+      return dir + name;
+    }
+    return cmStrCat(dir, '/', name);
+  }
+
+  static std::string MatchName(std::string name)
+  {
+#if defined(_WIN32) || defined(__APPLE__) || defined(__CYGWIN__)
+    name = cmSystemTools::LowerCase(name);
+#endif
+    return name;
+  }
+
+  void ProcessDirectory(std::size_t start, const std::string& dir)
+  {
+    bool const last = (start == this->Expressions.size() - 1);
+    if (last && this->Recurse) {
+      if (cmSystemTools::FileIsDirectory(dir)) {
+        this->RecurseDirectory(dir);
+      } else {
+        this->Directories.push_back(dir);
+      }
+      return;
+    }
+
+    this->Directories.push_back(dir);
+    cmsys::Directory d;
+    if (last || !d.Load(dir)) {
+      return;
+    }
+    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+      std::string const fname = d.GetFile(i);
+      if (fname == "." || fname == "..") {
+        continue;
+      }
+      std::string const realname = JoinPath(dir, fname);
+      if (cmSystemTools::FileIsDirectory(realname) &&
+          this->Expressions[start].find(MatchName(fname))) {
+        this->ProcessDirectory(start + 1, realname);
+      }
+    }
+  }
+
+  void RecurseDirectory(const std::string& dir)
+  {
+    this->Directories.push_back(dir);
+    cmsys::Directory d;
+    if (!d.Load(dir)) {
+      return;
+    }
+    for (unsigned long i = 0; i < d.GetNumberOfFiles(); ++i) {
+      std::string const fname = d.GetFile(i);
+      if (fname == "." || fname == "..") {
+        continue;
+      }
+      std::string const realname = JoinPath(dir, fname);
+      if (!cmSystemTools::FileIsDirectory(realname)) {
+        continue;
+      }
+      if (!cmSystemTools::FileIsSymlink(realname)) {
+        this->RecurseDirectory(realname);
+      } else if (this->FollowSymlinks) {
+        // Stop at symlink cycles, which the glob reports.
+        std::string const canonicalPath =
+          cmSystemTools::GetRealPath(realname);
+        if (std::find(this->VisitedSymlinks.begin(),
+                      this->VisitedSymlinks.end(),
+                      canonicalPath) == this->VisitedSymlinks.end()) {
+          this->VisitedSymlinks.push_back(canonicalPath);
+          this->RecurseDirectory(realname);
+          this->VisitedSymlinks.pop_back();
+        }
+      }
+    }
+  }
+};
+
+bool HasNewline(const std::string& s)
+{
+  return s.find_first_of("\r\n") != std::string::npos;
+}
+}
+
 bool cmGlobVerificationManager::SaveVerificationScript(const std::string& path)
 {
   if (this->Cache.empty()) {
@@ -19,9 +191,11 @@ bool cmGlobVerificationManager::SaveVerificationScript(const std::string& path)
   }
 
   std::string scriptFile = cmStrCat(path, "/CMakeFiles");
+  std::string stateFile = scriptFile;
   std::string stampFile = scriptFile;
   cmSystemTools::MakeDirectory(scriptFile);
   scriptFile += "/VerifyGlobs.cmake";
+  stateFile += "/VerifyGlobs.state";
   stampFile += "/cmake.verify_globs";
   cmGeneratedFileStream verifyScriptFile(scriptFile);
   verifyScriptFile.SetCopyIfDifferent(true);
@@ -72,6 +246,10 @@ bool cmGlobVerificationManager::SaveVerificationScript(const std::string& path)
   }
   verifyScriptFile.Close();
 
+  if (!SaveVerificationState(stateFile, stampFile, this->Cache)) {
+    return false;
+  }
+
   cmsys::ofstream verifyStampFile(stampFile.c_str());
   if (!verifyStampFile) {
     cmSystemTools::Error("Unable to open verification stamp file for write. " +
@@ -81,6 +259,7 @@ bool cmGlobVerificationManager::SaveVerificationScript(const std::string& path)
   verifyStampFile << "# This file is generated by CMake for checking of the "
                      "VerifyGlobs.cmake file\n";
   this->VerifyScript = scriptFile;
+  this->VerifyState = stateFile;
   this->VerifyStamp = stampFile;
   return true;
 }
@@ -152,6 +331,7 @@ void cmGlobVerificationManager::AddCacheEntry(
   CacheEntryValue& value = this->Cache[key];
   if (!value.Initialized) {
     value.Files = files;
+    value.Directories = key.RecordDirectories();
     value.Initialized = true;
     value.Backtraces.emplace_back(variable, backtrace);
   } else if (value.Initialized && value.Files != files) {
@@ -177,5 +357,229 @@ void cmGlobVerificationManager::Reset()
 {
   this->Cache.clear();
   this->VerifyScript.clear();
+  this->VerifyState.clear();
   this->VerifyStamp.clear();
 }
+
+cmGlobVerificationManager::DirectoryRecords
+cmGlobVerificationManager::CacheEntryKey::RecordDirectories() const
+{
+  DirectoryRecorder recorder(this->Recurse, this->FollowSymlinks);
+  recorder.Find(this->Expression);
+
+  cmFileTime::NSC const now = CurrentFileTime();
+  DirectoryRecords records;
+  records.reserve(recorder.Directories.size());
+  for (std::string const& dir : recorder.Directories) {
+    DirectoryRecord record;
+    record.Path = dir;
+    cmFileTime mtime;
+    cmSystemTools::Stat_t st;
+    if (mtime.Load(dir) && cmSystemTools::Stat(dir, &st) == 0) {
+      record.Exists = true;
+      record.MTime = mtime.GetNS();
+      record.Inode = static_cast<unsigned long long>(st.st_ino);
+      if (now - record.MTime < RacyInterval) {
+        record.MTime = RacyMTime;
+      }
+    }
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+std::vector<std::string> cmGlobVerificationManager::CacheEntryKey::FindFiles(
+  bool& error) const
+{
+  // Evaluate the expression as the verification script would.
+  cmsys::Glob g;
+  g.SetRecurse(this->Recurse);
+  g.SetRecurseThroughSymlinks(this->Recurse && this->FollowSymlinks);
+  g.SetListDirs(this->ListDirectories);
+  g.SetRecurseListDirs(this->ListDirectories);
+  if (!this->Relative.empty()) {
+    g.SetRelative(this->Relative.c_str());
+  }
+
+  cmsys::Glob::GlobMessages messages;
+  g.FindFiles(this->Expression, &messages);
+  error = std::any_of(messages.begin(), messages.end(),
+                      [](cmsys::Glob::Message const& message) {
+                        return message.type == cmsys::Glob::error;
+                      });
+
+  std::vector<std::string> files = g.GetFiles();
+  std::sort(files.begin(), files.end());
+  files.erase(std::unique(files.begin(), files.end()), files.end());
+  return files;
+}
+
+bool cmGlobVerificationManager::SaveVerificationState(
+  const std::string& stateFile, const std::string& stampFile,
+  const CacheEntryMap& cache)
+{
+  // The state is line based.  Leave it to the script to handle any path
+  // that cannot be written on one line.
+  bool writable = !HasNewline(stampFile);
+  for (auto const& i : cache) {
+    CacheEntryKey const& k = i.first;
+    CacheEntryValue const& v = i.second;
+    writable = writable && !HasNewline(k.Relative) &&
+      !HasNewline(k.Expression) &&
+      std::none_of(v.Files.begin(), v.Files.end(), HasNewline) &&
+      std::none_of(v.Directories.begin(), v.Directories.end(),
+                   [](DirectoryRecord const& record) {
+                     return HasNewline(record.Path);
+                   });
+  }
+  if (!writable) {
+    cmSystemTools::RemoveFile(stateFile);
+    return true;
+  }
+
+  cmGeneratedFileStream fout(stateFile);
+  if (!fout) {
+    cmSystemTools::Error("Unable to open verification state file for save. " +
+                         stateFile);
+    cmSystemTools::ReportLastSystemError("");
+    return false;
+  }
+  fout << StateFileSignature << "\n"
+       << "stamp " << stampFile << "\n";
+  for (auto const& i : cache) {
+    CacheEntryKey const& k = i.first;
+    CacheEntryValue const& v = i.second;
+    if (!v.Initialized) {
+      continue;
+    }
+    fout << "glob " << k.Recurse << ' ' << k.ListDirectories << ' '
+         << k.FollowSymlinks << "\n"
+         << "relative " << k.Relative << "\n"
+         << "expression " << k.Expression << "\n";
+    for (std::string const& file : v.Files) {
+      fout << "file " << file << "\n";
+    }
+    for (DirectoryRecord const& record : v.Directories) {
+      if (record.Exists) {
+        fout << "dir " << record.MTime << ' ' << record.Inode << ' '
+             << record.Path << "\n";
+      } else {
+        fout << "missing " << record.Path << "\n";
+      }
+    }
+  }
+  return fout.Close();
+}
+
+bool cmGlobVerificationManager::IsUnchanged(const DirectoryRecord& record)
+{
+  if (record.MTime == RacyMTime) {
+    return false;
+  }
+  cmFileTime mtime;
+  cmSystemTools::Stat_t st;
+  if (!mtime.Load(record.Path) || cmSystemTools::Stat(record.Path, &st) != 0) {
+    return !record.Exists;
+  }
+  return record.Exists && record.MTime == mtime.GetNS() &&
+    record.Inode == static_cast<unsigned long long>(st.st_ino);
+}
+
+bool cmGlobVerificationManager::VerifyGlobs(const std::string& stateFile)
+{
+  cmsys::ifstream fin(stateFile.c_str());
+  if (!fin) {
+    return false;
+  }
+  std::string line;
+  if (!cmSystemTools::GetLineFromStream(fin, line) ||
+      line != StateFileSignature) {
+    return false;
+  }
+
+  std::string stampFile;
+  CacheEntryMap cache;
+  CacheEntryValue* value = nullptr;
+  while (cmSystemTools::GetLineFromStream(fin, line)) {
+    std::string::size_type const pos = line.find(' ');
+    cm::string_view const tag = cm::string_view(line).substr(0, pos);
+    std::string const rest =
+      pos == std::string::npos ? std::string() : line.substr(pos + 1);
+    if (tag == "stamp") {
+      stampFile = rest;
+    } else if (tag == "glob") {
+      // The relative directory and expression follow on their own lines.
+      std::string relative;
+      std::string expression;
+      if (rest.size() != 5 ||
+          !cmSystemTools::GetLineFromStream(fin, relative) ||
+          !cmHasLiteralPrefix(relative, "relative ") ||
+          !cmSystemTools::GetLineFromStream(fin, expression) ||
+          !cmHasLiteralPrefix(expression, "expression ")) {
+        return false;
+      }
+      CacheEntryKey key(rest[0] == '1', rest[2] == '1', rest[4] == '1',
+                        relative.substr(9), expression.substr(11));
+      value = &cache[key];
+      value->Initialized = true;
+    } else if (!value) {
+      return false;
+    } else if (tag == "file") {
+      value->Files.push_back(rest);
+    } else if (tag == "missing") {
+      DirectoryRecord record;
+      record.Path = rest;
+      value->Directories.push_back(std::move(record));
+    } else if (tag == "dir") {
+      std::istringstream in(rest);
+      DirectoryRecord record;
+      record.Exists = true;
+      if (!(in >> record.MTime >> record.Inode) || in.get() != ' ' ||
+          !std::getline(in, record.Path)) {
+        return false;
+      }
+      value->Directories.push_back(std::move(record));
+    } else {
+      return false;
+    }
+  }
+  fin.close();
+  if (stampFile.empty()) {
+    return false;
+  }
+
+  bool changed = false;
+  for (auto& i : cache) {
+    CacheEntryKey const& k = i.first;
+    CacheEntryValue& v = i.second;
+
+    // Re-glob only if one of the directories listed has changed.
+    if (std::all_of(v.Directories.begin(), v.Directories.end(),
+                    IsUnchanged)) {
+      continue;
+    }
+
+    // Record the directories before globbing so that any change made
+    // in between is seen next time.
+    DirectoryRecords records = k.RecordDirectories();
+    bool error = false;
+    std::vector<std::string> files = k.FindFiles(error);
+    if (error) {
+      // Let the script report the error.
+      return false;
+    }
+    if (files != v.Files) {
+      std::cerr << "-- GLOB mismatch!" << std::endl;
+      cmSystemTools::Touch(stampFile, false);
+      return true;
+    }
+    v.Directories = std::move(records);
+    changed = true;
+  }
+
+  // Save the new directory times so they are not re-globbed next time.
+  if (changed) {
+    SaveVerificationState(stateFile, stampFile, cache);
+  }
+  return true;
+}
@@ -17,13 +17,24 @@
  * \brief Class for expressing build-time dependencies on glob expressions.
  *
  * Generates a CMake script which verifies glob outputs during prebuild.
+ * Alongside the script it saves the directories each glob listed, so that
+ * the build can check them natively and re-run only the globs whose
+ * directories have changed.
  *
  */
 class cmGlobVerificationManager
 {
+public:
+  //! Verify the globs saved in the given state file at build time.
+  //! Touches the stamp file recorded in the state if any glob result
+  //! changed.  Returns false if the state file cannot be used, in which
+  //! case the verification script must be run instead.
+  static bool VerifyGlobs(const std::string& stateFile);
+
 protected:
   //! Save verification script for given makefile.
   //! Saves to output <path>/<CMakeFilesDirectory>/VerifyGlobs.cmake
+  //! and the directory state to VerifyGlobs.state next to it.
   bool SaveVerificationScript(const std::string& path);
 
   //! Add an entry into the glob cache
@@ -40,11 +51,25 @@ protected:
   //! Check targets should be written in generated build system.
   bool DoWriteVerifyTarget() const;
 
-  //! Get the paths to the generated script and stamp files
+  //! Get the paths to the generated script, state and stamp files
   std::string const& GetVerifyScript() const { return this->VerifyScript; }
+  std::string const& GetVerifyState() const { return this->VerifyState; }
   std::string const& GetVerifyStamp() const { return this->VerifyStamp; }
 
 private:
+  // The modification time and inode of a directory listed by a glob.
+  // Adding, removing or renaming an entry updates the time, and
+  // replacing the directory itself changes the inode.
+  struct DirectoryRecord
+  {
+    std::string Path;
+    bool Exists = false;
+    long long MTime = 0;
+    unsigned long long Inode = 0;
+  };
+  using DirectoryRecords = std::vector<DirectoryRecord>;
+  static bool IsUnchanged(const DirectoryRecord& record);
+
   struct CacheEntryKey
   {
     const bool Recurse;
@@ -63,18 +88,28 @@ private:
     }
     bool operator<(const CacheEntryKey& r) const;
     void PrintGlobCommand(std::ostream& out, const std::string& cmdVar);
+    DirectoryRecords RecordDirectories() const;
+    std::vector<std::string> FindFiles(bool& error) const;
   };
 
   struct CacheEntryValue
   {
     bool Initialized = false;
     std::vector<std::string> Files;
+    DirectoryRecords Directories;
     std::vector<std::pair<std::string, cmListFileBacktrace>> Backtraces;
   };
 
   using CacheEntryMap = std::map<CacheEntryKey, CacheEntryValue>;
+
+  //! Save the glob state read by VerifyGlobs.
+  static bool SaveVerificationState(const std::string& stateFile,
+                                    const std::string& stampFile,
+                                    const CacheEntryMap& cache);
+
   CacheEntryMap Cache;
   std::string VerifyScript;
+  std::string VerifyState;
   std::string VerifyStamp;
 
   // Only cmState should be able to add cache values.
@@ -18,6 +18,7 @@
 
 #include "cmsys/Directory.hxx"
 #include "cmsys/FStream.hxx"
+#include "cmsys/String.h"
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #  include <windows.h>
@@ -48,16 +49,21 @@
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmStateTypes.h"
+#include "cmStringAlgorithms.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
 
 #if !defined(CMAKE_BOOTSTRAP)
+#  include <thread>
+
 #  include <cm3p/json/value.h>
 #  include <cm3p/json/writer.h>
 
 #  include "cmCryptoHash.h"
+#  include "cmMakefileProfilingData.h"
 #  include "cmQtAutoGenGlobalInitializer.h"
+#  include "cmWorkerPool.h"
 #endif
 
 #if defined(_MSC_VER) && _MSC_VER >= 1800
@@ -109,6 +115,8 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
 
   this->RecursionDepth = 0;
 
+  cmGeneratorExpression::RetainParsedExpressions();
+
   cm->GetState()->SetIsGeneratorMultiConfig(false);
   cm->GetState()->SetMinGWMake(false);
   cm->GetState()->SetMSYSShell(false);
@@ -121,6 +129,7 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
 cmGlobalGenerator::~cmGlobalGenerator()
 {
   this->ClearGeneratorMembers();
+  cmGeneratorExpression::ReleaseParsedExpressions();
 }
 
 #if !defined(CMAKE_BOOTSTRAP)
@@ -1392,6 +1401,11 @@ bool cmGlobalGenerator::UnsupportedVariableIsDefined(const std::string& name,
 
 bool cmGlobalGenerator::Compute()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cmMakefileProfilingData::Scope profilingScope(
+    this->CMakeInstance, "generate", "Compute");
+#endif
+
   // Make sure unsupported variables are not used.
   if (this->UnsupportedVariableIsDefined("CMAKE_DEFAULT_BUILD_TYPE",
                                          this->SupportsDefaultBuildType())) {
@@ -1410,6 +1424,9 @@ bool cmGlobalGenerator::Compute()
   // Start with an empty vector:
   this->FilesReplacedDuringGenerate.clear();
 
+  // Results remembered by compiled expressions do not outlive a generate.
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
+
   // clear targets to issue warning CMP0042 for
   this->CMP0042WarnTargets.clear();
   // clear targets to issue warning CMP0068 for
@@ -1428,13 +1445,25 @@ bool cmGlobalGenerator::Compute()
   this->FillProjectMap();
 
   // Add automatically generated sources (e.g. unity build).
-  if (!this->AddAutomaticSources()) {
-    return false;
+  {
+#if !defined(CMAKE_BOOTSTRAP)
+    cmMakefileProfilingData::Scope stepScope(
+      this->CMakeInstance, "generate", "AddAutomaticSources");
+#endif
+    if (!this->AddAutomaticSources()) {
+      return false;
+    }
   }
 
   // Iterate through all targets and set up AUTOMOC, AUTOUIC and AUTORCC
-  if (!this->QtAutoGen()) {
-    return false;
+  {
+#if !defined(CMAKE_BOOTSTRAP)
+    cmMakefileProfilingData::Scope stepScope(
+      this->CMakeInstance, "generate", "QtAutoGen");
+#endif
+    if (!this->QtAutoGen()) {
+      return false;
+    }
   }
 
   // Add generator specific helper commands
@@ -1467,8 +1496,14 @@ bool cmGlobalGenerator::Compute()
 
   // Trace the dependencies, after that no custom commands should be added
   // because their dependencies might not be handled correctly
-  for (const auto& localGen : this->LocalGenerators) {
-    localGen->TraceDependencies();
+  {
+#if !defined(CMAKE_BOOTSTRAP)
+    cmMakefileProfilingData::Scope stepScope(
+      this->CMakeInstance, "generate", "TraceDependencies");
+#endif
+    for (const auto& localGen : this->LocalGenerators) {
+      localGen->TraceDependencies();
+    }
   }
 
   // Make sure that all (non-imported) targets have source files added!
@@ -1484,8 +1519,14 @@ bool cmGlobalGenerator::Compute()
   }
 
   // Compute the inter-target dependencies.
-  if (!this->ComputeTargetDepends()) {
-    return false;
+  {
+#if !defined(CMAKE_BOOTSTRAP)
+    cmMakefileProfilingData::Scope stepScope(
+      this->CMakeInstance, "generate", "ComputeTargetDepends");
+#endif
+    if (!this->ComputeTargetDepends()) {
+      return false;
+    }
   }
 
   if (this->CheckTargetsForType()) {
@@ -1503,8 +1544,35 @@ bool cmGlobalGenerator::Compute()
   return true;
 }
 
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+// Number of threads that commit generated files, or 0 to commit them
+// synchronously.
+unsigned int GetGenerateParallelLevel()
+{
+  std::string level;
+  if (!cmSystemTools::GetEnv("CMAKE_GENERATE_PARALLEL_LEVEL", level)) {
+    return 0;
+  }
+  if (level.empty()) {
+    return std::thread::hardware_concurrency();
+  }
+  unsigned long n;
+  if (!cmStrToULong(level, &n)) {
+    return 0;
+  }
+  return static_cast<unsigned int>(n);
+}
+}
+#endif
+
 void cmGlobalGenerator::Generate()
 {
+#if !defined(CMAKE_BOOTSTRAP)
+  cmMakefileProfilingData::Scope profilingScope(
+    this->CMakeInstance, "generate", "Generate");
+#endif
+
   // Create a map from local generator to the complete set of targets
   // it builds by default.
   this->InitializeProgressMarks();
@@ -1513,9 +1581,25 @@ void cmGlobalGenerator::Generate()
 
   this->CMakeInstance->UpdateProgress("Generating", 0.1f);
 
+#if !defined(CMAKE_BOOTSTRAP)
+  // Let worker threads compare and move generated files into place while
+  // the next directory is computed.
+  std::unique_ptr<cmGeneratedFileStreamDeferredCommit> deferredCommit;
+  unsigned int const parallelLevel = GetGenerateParallelLevel();
+  if (parallelLevel > 1 && this->SupportsDeferredFileCommit()) {
+    deferredCommit =
+      cm::make_unique<cmGeneratedFileStreamDeferredCommit>(parallelLevel);
+  }
+#endif
+
   // Generate project files
   for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i) {
     this->SetCurrentMakefile(this->LocalGenerators[i]->GetMakefile());
+#if !defined(CMAKE_BOOTSTRAP)
+    cmMakefileProfilingData::Scope directoryScope(
+      this->CMakeInstance, "directory",
+      this->LocalGenerators[i]->GetCurrentBinaryDirectory());
+#endif
     this->LocalGenerators[i]->Generate();
     if (!this->LocalGenerators[i]->GetMakefile()->IsOn(
           "CMAKE_SKIP_INSTALL_RULES")) {
@@ -1529,6 +1613,9 @@ void cmGlobalGenerator::Generate()
           static_cast<float>(this->LocalGenerators.size()));
   }
   this->SetCurrentMakefile(nullptr);
+#if !defined(CMAKE_BOOTSTRAP)
+  deferredCommit.reset();
+#endif
 
   if (!this->GenerateCPackPropertiesFile()) {
     this->GetCMakeInstance()->IssueMessage(
@@ -1862,6 +1949,129 @@ int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
                                   const std::string& projectName,
                                   const std::string& target, bool fast,
                                   std::string& output, cmMakefile* mf)
+{
+  this->UpdateTryCompileProgress();
+
+  std::vector<std::string> newTarget = {};
+  if (!target.empty()) {
+    newTarget = { target };
+  }
+  std::string config =
+    mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  return this->Build(jobs, srcdir, bindir, projectName, newTarget, output, "",
+                     config, false, fast, false, this->TryCompileTimeout);
+}
+
+#if !defined(CMAKE_BOOTSTRAP)
+namespace {
+class TryCompileBuildJob : public cmWorkerPool::JobT
+{
+public:
+  TryCompileBuildJob(std::vector<std::string> command, std::string dir,
+                     cmWorkerPool::ProcessResultT& result)
+    : Command(std::move(command))
+    , Directory(std::move(dir))
+    , Result(result)
+  {
+  }
+
+private:
+  void Process() override
+  {
+    this->RunProcess(this->Result, this->Command, this->Directory);
+  }
+
+  std::vector<std::string> Command;
+  std::string Directory;
+  cmWorkerPool::ProcessResultT& Result;
+};
+
+class TryCompileBuildEndJob : public cmWorkerPool::JobFenceT
+{
+  void Process() override { this->Pool()->Abort(); }
+};
+}
+#endif
+
+std::vector<int> cmGlobalGenerator::TryCompileTargets(
+  int jobs, const std::string& bindir, const std::string& projectName,
+  std::vector<std::string> const& targetNames,
+  std::vector<std::string>& outputs, cmMakefile* mf)
+{
+  std::vector<int> results(targetNames.size(), 1);
+  outputs.assign(targetNames.size(), std::string());
+
+#if !defined(CMAKE_BOOTSTRAP)
+  std::string config =
+    mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
+  if (config.empty()) {
+    config = this->GetDefaultBuildConfig();
+  }
+
+  // Each target needs a single build command so that it can be run
+  // without a shell.
+  std::vector<GeneratedMakeCommand> commands;
+  if (jobs > 1 && targetNames.size() > 1 &&
+      this->SupportsConcurrentTargetBuilds()) {
+    for (std::string const& targetName : targetNames) {
+      std::vector<GeneratedMakeCommand> command = this->GenerateBuildCommand(
+        "", projectName, bindir, { targetName }, config, true,
+        cmake::NO_BUILD_PARALLEL_LEVEL, false);
+      if (command.size() != 1) {
+        commands.clear();
+        break;
+      }
+      commands.push_back(std::move(command.front()));
+    }
+  }
+
+  if (!commands.empty()) {
+    std::vector<cmWorkerPool::ProcessResultT> processResults(
+      commands.size());
+    cmWorkerPool pool;
+    pool.SetThreadCount(static_cast<unsigned int>(
+      std::min<std::size_t>(static_cast<std::size_t>(jobs), commands.size())));
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+      this->UpdateTryCompileProgress();
+      pool.EmplaceJob<TryCompileBuildJob>(commands[i].PrimaryCommand, bindir,
+                                          processResults[i]);
+    }
+    pool.EmplaceJob<TryCompileBuildEndJob>();
+    pool.Process();
+
+    // Report each build the way Build() does.
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+      cmWorkerPool::ProcessResultT const& result = processResults[i];
+      std::string& output = outputs[i];
+      output = cmStrCat("Change Dir: ", bindir,
+                        "\n\nRun Build Command(s):", commands[i].Printable(),
+                        " && ", result.StdOut);
+      if (!result.ErrorMessage.empty()) {
+        output += cmStrCat(result.ErrorMessage, '\n');
+      }
+      output += '\n';
+      results[i] = result.error() ? 1 : 0;
+      if (results[i] == 0 &&
+          this->CMakeInstance->GetState()->UseWatcomWMake() &&
+          output.find("W1008: cannot open") != std::string::npos) {
+        results[i] = 1;
+      }
+    }
+    return results;
+  }
+#else
+  static_cast<void>(jobs);
+#endif
+
+  for (std::size_t i = 0; i < targetNames.size(); ++i) {
+    results[i] =
+      this->TryCompile(cmake::NO_BUILD_PARALLEL_LEVEL, bindir, bindir,
+                       projectName, targetNames[i], true, outputs[i], mf);
+  }
+  return results;
+}
+
+void cmGlobalGenerator::UpdateTryCompileProgress()
 {
   // if this is not set, then this is a first time configure
   // and there is a good chance that the try compile stuff will
@@ -1880,15 +2090,6 @@ int cmGlobalGenerator::TryCompile(int jobs, const std::string& srcdir,
     this->CMakeInstance->UpdateProgress("Configuring",
                                         this->FirstTimeProgress);
   }
-
-  std::vector<std::string> newTarget = {};
-  if (!target.empty()) {
-    newTarget = { target };
-  }
-  std::string config =
-    mf->GetSafeDefinition("CMAKE_TRY_COMPILE_CONFIGURATION");
-  return this->Build(jobs, srcdir, bindir, projectName, newTarget, output, "",
-                     config, false, fast, false, this->TryCompileTimeout);
 }
 
 std::vector<cmGlobalGenerator::GeneratedMakeCommand>
@@ -3190,6 +3391,21 @@ cmGlobalGenerator::GetFilenameTargetDepends(cmSourceFile* sf) const
   return this->FilenameTargetDepends[sf];
 }
 
+std::size_t cmGlobalGenerator::GetConfigIndex(std::string const& config) const
+{
+  // There are only a handful of configurations, so a linear scan beats
+  // hashing the name.  Configuration names are case-insensitive.
+  std::size_t const n = this->ConfigIndexNames.size();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (cmsysString_strcasecmp(this->ConfigIndexNames[i].c_str(),
+                               config.c_str()) == 0) {
+      return i;
+    }
+  }
+  this->ConfigIndexNames.push_back(config);
+  return n;
+}
+
 const std::string& cmGlobalGenerator::GetRealPath(const std::string& dir)
 {
   auto i = this->RealPaths.lower_bound(dir);
@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -212,6 +213,16 @@ public:
                  const std::string& targetName, bool fast, std::string& output,
                  cmMakefile* mf);
 
+  /**
+   * Build each of several targets of one try_compile project with its
+   * own run of the native build tool.  Up to 'jobs' of these run at a
+   * time if the generator supports concurrent target builds.
+   */
+  std::vector<int> TryCompileTargets(
+    int jobs, const std::string& bindir, const std::string& projectName,
+    std::vector<std::string> const& targetNames,
+    std::vector<std::string>& outputs, cmMakefile* mf);
+
   /**
    * Build a file given the following information. This is a more direct call
    * that is used by both CTest and TryCompile. If target name is NULL or
@@ -450,6 +461,15 @@ public:
 
   virtual bool SupportsCustomCommandDepfile() const { return false; }
 
+  /** Return whether files written by the local generators may be moved
+      into place in the background.  This requires that nothing checks
+      whether cmGeneratedFileStream::Close() replaced the file.  */
+  virtual bool SupportsDeferredFileCommit() const { return false; }
+
+  /** Return whether separate runs of the native build tool may build
+      different targets of one build tree at the same time.  */
+  virtual bool SupportsConcurrentTargetBuilds() const { return false; }
+
   std::string GetSharedLibFlagsForLanguage(std::string const& lang) const;
 
   /** Generate an <output>.rule file path for a given command output.  */
@@ -485,6 +505,10 @@ public:
   const std::set<const cmGeneratorTarget*>& GetFilenameTargetDepends(
     cmSourceFile* sf) const;
 
+  /** Get the dense index of a configuration name, assigning the next one
+      the first time the name is seen.  Used to index cmPerConfig.  */
+  std::size_t GetConfigIndex(std::string const& config) const;
+
 #if !defined(CMAKE_BOOTSTRAP)
   cmFileLockPool& GetFileLockPool() { return FileLockPool; }
 #endif
@@ -631,6 +655,10 @@ private:
     char Data[32];
   };
   std::map<std::string, RuleHash> RuleHashes;
+
+  // Advance the guessed progress of a first configure for a try_compile.
+  void UpdateTryCompileProgress();
+
   void CheckRuleHashes();
   void CheckRuleHashes(std::string const& pfile, std::string const& home);
   void WriteRuleHashes(std::string const& pfile);
@@ -700,6 +728,9 @@ private:
   mutable std::map<cmSourceFile*, std::set<cmGeneratorTarget const*>>
     FilenameTargetDepends;
 
+  // Configuration names in the order GetConfigIndex assigned them.
+  mutable std::vector<std::string> ConfigIndexNames;
+
   std::map<std::string, std::string> RealPaths;
 
 #if !defined(CMAKE_BOOTSTRAP)
@@ -417,6 +417,14 @@ void cmGlobalNinjaGenerator::WriteInclude(std::ostream& os,
   os << "include " << filename << "\n";
 }
 
+void cmGlobalNinjaGenerator::WriteSubninja(std::ostream& os,
+                                           const std::string& filename,
+                                           const std::string& comment)
+{
+  cmGlobalNinjaGenerator::WriteComment(os, comment);
+  os << "subninja " << filename << "\n";
+}
+
 void cmGlobalNinjaGenerator::WriteDefault(std::ostream& os,
                                           const cmNinjaDeps& targets,
                                           const std::string& comment)
@@ -498,6 +506,9 @@ void cmGlobalNinjaGenerator::Generate()
   }
 
   this->InitOutputPathPrefix();
+  this->ShardDirectories =
+    this->LocalGenerators[0]->GetMakefile()->IsOn(
+      "CMAKE_NINJA_SHARD_BY_DIRECTORY");
   this->TargetAll = this->NinjaOutputPath("all");
   this->CMakeCacheFile = this->NinjaOutputPath("CMakeCache.txt");
 
@@ -880,6 +891,50 @@ bool cmGlobalNinjaGenerator::OpenFileStream(
   return true;
 }
 
+bool cmGlobalNinjaGenerator::OpenDirectoryShard(
+  std::unique_ptr<cmGeneratedFileStream>& stream, cmLocalGenerator const* lg,
+  const std::string& name, std::ostream& parent)
+{
+  std::string const path =
+    cmStrCat(lg->GetCurrentBinaryDirectory(), "/CMakeFiles/", name);
+  stream = cm::make_unique<cmGeneratedFileStream>(path, false,
+                                                  this->GetMakefileEncoding());
+  if (!(*stream)) {
+    stream.reset();
+    return false;
+  }
+  // Leave the shards of unchanged directories untouched.
+  stream->SetCopyIfDifferent(true);
+  this->WriteDisclaimer(*stream);
+
+  cmGlobalNinjaGenerator::WriteSubninja(
+    parent, this->EncodePath(this->ConvertToNinjaPath(path)));
+  return true;
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryShard(
+  std::unique_ptr<cmGeneratedFileStream>& stream)
+{
+  // Do not replace a shard with one that is known to be incomplete.
+  if (cmSystemTools::GetErrorOccuredFlag()) {
+    stream->setstate(std::ios::failbit);
+  }
+  stream.reset();
+}
+
+bool cmGlobalNinjaGenerator::OpenDirectoryShards(cmLocalGenerator const* lg)
+{
+  return this->OpenDirectoryShard(this->DirectoryShardStream, lg,
+                                  "directory.ninja", *this->BuildFileStream);
+}
+
+void cmGlobalNinjaGenerator::CloseDirectoryShards()
+{
+  if (this->DirectoryShardStream) {
+    this->CloseDirectoryShard(this->DirectoryShardStream);
+  }
+}
+
 cm::optional<std::set<std::string>> cmGlobalNinjaGenerator::ListSubsetWithAll(
   const std::set<std::string>& all, const std::set<std::string>& defaults,
   const std::vector<std::string>& items)
@@ -1601,7 +1656,10 @@ void cmGlobalNinjaGenerator::WriteTargetRebuildManifest(std::ostream& os)
     {
       cmNinjaRule rule("VERIFY_GLOBS");
       rule.Command =
-        cmStrCat(CMakeCmd(), " -P ",
+        cmStrCat(CMakeCmd(), " -E cmake_verify_globs ",
+                 lg->ConvertToOutputFormat(cm->GetGlobVerifyState(),
+                                           cmOutputConverter::SHELL),
+                 ' ',
                  lg->ConvertToOutputFormat(cm->GetGlobVerifyScript(),
                                            cmOutputConverter::SHELL));
       rule.Description = "Re-checking globbed directories...";
@@ -2545,6 +2603,40 @@ void cmGlobalNinjaMultiGenerator::CloseBuildFileStreams()
   }
 }
 
+bool cmGlobalNinjaMultiGenerator::OpenDirectoryShards(
+  cmLocalGenerator const* lg)
+{
+  if (!this->OpenDirectoryShard(
+        this->DirectoryShardCommonStream, lg,
+        cmStrCat("directory-common", NINJA_FILE_EXTENSION),
+        *this->CommonFileStream)) {
+    return false;
+  }
+  for (auto const& config : this->Makefiles[0]->GetGeneratorConfigs()) {
+    if (!this->OpenDirectoryShard(
+          this->DirectoryShardImplStreams[config], lg,
+          cmStrCat("directory-impl-", config, NINJA_FILE_EXTENSION),
+          *this->ImplFileStreams[config])) {
+      this->CloseDirectoryShards();
+      return false;
+    }
+  }
+  return true;
+}
+
+void cmGlobalNinjaMultiGenerator::CloseDirectoryShards()
+{
+  if (this->DirectoryShardCommonStream) {
+    this->CloseDirectoryShard(this->DirectoryShardCommonStream);
+  }
+  for (auto& shard : this->DirectoryShardImplStreams) {
+    if (shard.second) {
+      this->CloseDirectoryShard(shard.second);
+    }
+  }
+  this->DirectoryShardImplStreams.clear();
+}
+
 void cmGlobalNinjaMultiGenerator::AppendNinjaFileArgument(
   GeneratedMakeCommand& command, const std::string& config) const
 {
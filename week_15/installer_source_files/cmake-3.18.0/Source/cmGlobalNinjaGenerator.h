@@ -144,6 +144,13 @@ public:
   static void WriteInclude(std::ostream& os, const std::string& filename,
                            const std::string& comment = "");
 
+  /**
+   * Write a subninja statement including @a filename with an optional
+   * @a comment to the @a os stream.
+   */
+  static void WriteSubninja(std::ostream& os, const std::string& filename,
+                            const std::string& comment = "");
+
   /**
    * Write a default target statement specifying @a targets as
    * the default targets.
@@ -212,10 +219,14 @@ public:
   const char* GetCleanTargetName() const override { return "clean"; }
 
   bool SupportsCustomCommandDepfile() const override { return true; }
+  bool SupportsDeferredFileCommit() const override { return true; }
 
   virtual cmGeneratedFileStream* GetImplFileStream(
     const std::string& /*config*/) const
   {
+    if (this->DirectoryShardStream) {
+      return this->DirectoryShardStream.get();
+    }
     return this->BuildFileStream.get();
   }
 
@@ -232,6 +243,9 @@ public:
 
   virtual cmGeneratedFileStream* GetCommonFileStream() const
   {
+    if (this->DirectoryShardStream) {
+      return this->DirectoryShardStream.get();
+    }
     return this->BuildFileStream.get();
   }
 
@@ -240,6 +254,19 @@ public:
     return this->RulesFileStream.get();
   }
 
+  /// @return whether the build statements of each directory are written
+  /// to files of their own, see CMAKE_NINJA_SHARD_BY_DIRECTORY.
+  bool ShardByDirectory() const { return this->ShardDirectories; }
+
+  /**
+   * Open the shards holding the build statements of directory @a lg and
+   * reference them from the build files with 'subninja'.  Until
+   * CloseDirectoryShards() is called, GetImplFileStream() and
+   * GetCommonFileStream() return the shards.
+   */
+  virtual bool OpenDirectoryShards(cmLocalGenerator const* lg);
+  virtual void CloseDirectoryShards();
+
   std::string const& ConvertToNinjaPath(const std::string& path) const;
 
   struct MapToNinjaPathImpl
@@ -305,6 +332,15 @@ public:
     this->AssumedSourceDependencies.erase(output);
   }
 
+  /// Called for the outputs of build statements that are kept from a
+  /// previous run instead of being passed to WriteBuild again.
+  void SeenBuildOutput(const std::string& output)
+  {
+    if (this->ComputingUnknownDependencies) {
+      this->CombinedBuildOutputs.insert(output);
+    }
+  }
+
   void AddAssumedSourceDependencies(const std::string& source,
                                     const cmNinjaDeps& deps)
   {
@@ -431,6 +467,11 @@ protected:
   bool OpenFileStream(std::unique_ptr<cmGeneratedFileStream>& stream,
                       const std::string& name);
 
+  bool OpenDirectoryShard(std::unique_ptr<cmGeneratedFileStream>& stream,
+                          cmLocalGenerator const* lg, const std::string& name,
+                          std::ostream& parent);
+  void CloseDirectoryShard(std::unique_ptr<cmGeneratedFileStream>& stream);
+
   static cm::optional<std::set<std::string>> ListSubsetWithAll(
     const std::set<std::string>& all, const std::set<std::string>& defaults,
     const std::vector<std::string>& items);
@@ -485,6 +526,10 @@ private:
   /// edge of the compilation DAG).
   std::unique_ptr<cmGeneratedFileStream> RulesFileStream;
   std::unique_ptr<cmGeneratedFileStream> CompileCommandsStream;
+  /// The file containing the build statements of the directory being
+  /// generated, if they are sharded.
+  std::unique_ptr<cmGeneratedFileStream> DirectoryShardStream;
+  bool ShardDirectories = false;
 
   /// The set of rules added to the generated build system.
   std::unordered_set<std::string> Rules;
@@ -610,6 +655,9 @@ public:
   cmGeneratedFileStream* GetImplFileStream(
     const std::string& config) const override
   {
+    if (!this->DirectoryShardImplStreams.empty()) {
+      return this->DirectoryShardImplStreams.at(config).get();
+    }
     return this->ImplFileStreams.at(config).get();
   }
 
@@ -626,9 +674,15 @@ public:
 
   cmGeneratedFileStream* GetCommonFileStream() const override
   {
+    if (this->DirectoryShardCommonStream) {
+      return this->DirectoryShardCommonStream.get();
+    }
     return this->CommonFileStream.get();
   }
 
+  bool OpenDirectoryShards(cmLocalGenerator const* lg) override;
+  void CloseDirectoryShards() override;
+
   void AppendNinjaFileArgument(GeneratedMakeCommand& command,
                                const std::string& config) const override;
 
@@ -663,6 +717,9 @@ private:
     ConfigFileStreams;
   std::unique_ptr<cmGeneratedFileStream> CommonFileStream;
   std::unique_ptr<cmGeneratedFileStream> DefaultFileStream;
+  std::map<std::string, std::unique_ptr<cmGeneratedFileStream>>
+    DirectoryShardImplStreams;
+  std::unique_ptr<cmGeneratedFileStream> DirectoryShardCommonStream;
 };
 
 #endif // ! cmGlobalNinjaGenerator_h
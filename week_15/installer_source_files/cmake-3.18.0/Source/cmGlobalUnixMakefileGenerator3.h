@@ -168,6 +168,10 @@ public:
 
   bool IsIPOSupported() const override { return true; }
 
+  bool SupportsDeferredFileCommit() const override { return true; }
+
+  bool SupportsConcurrentTargetBuilds() const override { return true; }
+
   void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const override;
 
   std::string IncludeDirective;
@@ -152,11 +152,12 @@ bool cmGlobalVisualStudio8Generator::AddCheckTarget()
       cm::append(listFiles, gen->GetMakefile()->GetListFiles());
     }
 
-    // Add a custom prebuild target to run the VerifyGlobs script.
+    // Add a custom prebuild target to verify the globbed directories.
     cmake* cm = this->GetCMakeInstance();
     if (cm->DoWriteGlobVerifyTarget()) {
       cmCustomCommandLines verifyCommandLines = cmMakeSingleCommandLine(
-        { cmSystemTools::GetCMakeCommand(), "-P", cm->GetGlobVerifyScript() });
+        { cmSystemTools::GetCMakeCommand(), "-E", "cmake_verify_globs",
+          cm->GetGlobVerifyState(), cm->GetGlobVerifyScript() });
       std::vector<std::string> byproducts;
       byproducts.push_back(cm->GetGlobVerifyStamp());
 
@@ -626,7 +626,9 @@ void cmGlobalXCodeGenerator::CreateReRunCMakeFile(
     makefileStream << "\t"
                    << this->ConvertToRelativeForMake(
                         cmSystemTools::GetCMakeCommand())
-                   << " -P "
+                   << " -E cmake_verify_globs "
+                   << this->ConvertToRelativeForMake(cm->GetGlobVerifyState())
+                   << " "
                    << this->ConvertToRelativeForMake(cm->GetGlobVerifyScript())
                    << "\n\n";
   }
@@ -125,7 +125,8 @@ bool cmIfFunctionBlocker::Replay(std::vector<cmListFileFunction> functions,
                                                 mf.GetBacktrace(func));
 
         bool isTrue =
-          conditionEvaluator.IsTrue(expandedArguments, errorString, messType);
+          conditionEvaluator.IsTrue(expandedArguments, errorString, messType,
+                                    func.Arguments);
 
         if (!errorString.empty()) {
           std::string err =
@@ -182,7 +183,7 @@ bool cmIfCommand(std::vector<cmListFileArgument> const& args,
     makefile, makefile.GetExecutionContext(), makefile.GetBacktrace());
 
   bool isTrue =
-    conditionEvaluator.IsTrue(expandedArguments, errorString, status);
+    conditionEvaluator.IsTrue(expandedArguments, errorString, status, args);
 
   if (!errorString.empty()) {
     std::string err =
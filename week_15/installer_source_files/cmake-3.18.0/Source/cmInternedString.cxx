@@ -0,0 +1,126 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmInternedString.h"
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+
+struct cmInternedString::Table
+{
+  std::mutex Mutex;
+  // Keys view the values of the entries, which never move.
+  std::unordered_map<cm::string_view, std::unique_ptr<Entry>> Entries;
+};
+
+cmInternedString::Table& cmInternedString::GetTable()
+{
+  // The table is intentionally leaked so that handles held by static
+  // objects stay valid during exit.
+  static Table* table = new Table;
+  return *table;
+}
+
+cmInternedString::Entry const* cmInternedString::GetEmpty()
+{
+  static Entry const empty = { std::string(),
+                               std::hash<cm::string_view>{}(
+                                 cm::string_view()) };
+  return &empty;
+}
+
+cmInternedString::cmInternedString()
+  : Ref(GetEmpty())
+{
+}
+
+cmInternedString::cmInternedString(cm::string_view str)
+  : Ref(Intern(str))
+{
+}
+
+cmInternedString::cmInternedString(std::string const& str)
+  : Ref(Intern(str))
+{
+}
+
+cmInternedString::cmInternedString(const char* str)
+  : Ref(Intern(str ? cm::string_view(str) : cm::string_view()))
+{
+}
+
+cmInternedString::Entry const* cmInternedString::Intern(cm::string_view str)
+{
+  if (str.empty()) {
+    return GetEmpty();
+  }
+  Table& table = GetTable();
+  std::lock_guard<std::mutex> lock(table.Mutex);
+  auto it = table.Entries.find(str);
+  if (it != table.Entries.end()) {
+    return it->second.get();
+  }
+  std::unique_ptr<Entry> entry(
+    new Entry{ std::string(str), std::hash<cm::string_view>{}(str) });
+  Entry const* ref = entry.get();
+  table.Entries.emplace(cm::string_view(entry->Value), std::move(entry));
+  return ref;
+}
+
+bool cmInternedString::Find(cm::string_view str, cmInternedString& result)
+{
+  if (str.empty()) {
+    result = cmInternedString();
+    return true;
+  }
+  Table& table = GetTable();
+  std::lock_guard<std::mutex> lock(table.Mutex);
+  auto it = table.Entries.find(str);
+  if (it == table.Entries.end()) {
+    return false;
+  }
+  result = cmInternedString(it->second.get());
+  return true;
+}
+
+bool operator<(cmInternedString const& l, cmInternedString const& r)
+{
+  return l != r && l.str() < r.str();
+}
+
+bool operator==(cmInternedString const& l, std::string const& r)
+{
+  return l.str() == r;
+}
+
+bool operator==(std::string const& l, cmInternedString const& r)
+{
+  return l == r.str();
+}
+
+bool operator==(cmInternedString const& l, const char* r)
+{
+  return l.str() == r;
+}
+
+bool operator!=(cmInternedString const& l, std::string const& r)
+{
+  return !(l == r);
+}
+
+bool operator!=(std::string const& l, cmInternedString const& r)
+{
+  return !(l == r);
+}
+
+bool operator!=(cmInternedString const& l, const char* r)
+{
+  return !(l == r);
+}
+
+std::ostream& operator<<(std::ostream& os, cmInternedString const& s)
+{
+  return os << s.str();
+}
@@ -0,0 +1,104 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmInternedString_h
+#define cmInternedString_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+#include <cm/string_view>
+
+/** \class cmInternedString
+ * \brief Handle to a string stored once for the whole process.
+ *
+ * Equal strings share a single immutable entry that lives until the
+ * process exits, so a handle is the size of a pointer and equality is
+ * a pointer comparison.  The hash of the string is computed once when
+ * it is interned.  Constructing a handle looks the string up in a global
+ * table, so use handles for names and paths that are stored many times
+ * and copy handles rather than re-interning their strings.
+ */
+class cmInternedString
+{
+  struct Entry
+  {
+    std::string Value;
+    std::size_t Hash;
+  };
+
+public:
+  /** Construct a handle to the empty string.  */
+  cmInternedString();
+
+  explicit cmInternedString(cm::string_view str);
+  cmInternedString(std::string const& str);
+  cmInternedString(const char* str);
+
+  /** Find the handle of a string without interning it.  Returns false
+      if the string has never been interned.  */
+  static bool Find(cm::string_view str, cmInternedString& result);
+
+  std::string const& str() const { return this->Ref->Value; }
+  operator std::string const&() const { return this->Ref->Value; }
+  cm::string_view view() const { return this->Ref->Value; }
+  const char* c_str() const { return this->Ref->Value.c_str(); }
+  bool empty() const { return this->Ref->Value.empty(); }
+  std::size_t size() const { return this->Ref->Value.size(); }
+
+  /** Hash of the string contents.  */
+  std::size_t hash() const { return this->Ref->Hash; }
+
+  friend bool operator==(cmInternedString l, cmInternedString r)
+  {
+    return l.Ref == r.Ref;
+  }
+  friend bool operator!=(cmInternedString l, cmInternedString r)
+  {
+    return l.Ref != r.Ref;
+  }
+
+private:
+  explicit cmInternedString(Entry const* ref)
+    : Ref(ref)
+  {
+  }
+
+  struct Table;
+  static Table& GetTable();
+  static Entry const* GetEmpty();
+  static Entry const* Intern(cm::string_view str);
+
+  Entry const* Ref;
+};
+
+bool operator<(cmInternedString const& l, cmInternedString const& r);
+
+bool operator==(cmInternedString const& l, std::string const& r);
+bool operator==(std::string const& l, cmInternedString const& r);
+bool operator==(cmInternedString const& l, const char* r);
+bool operator!=(cmInternedString const& l, std::string const& r);
+bool operator!=(std::string const& l, cmInternedString const& r);
+bool operator!=(cmInternedString const& l, const char* r);
+
+std::ostream& operator<<(std::ostream& os, cmInternedString const& s);
+
+namespace std {
+
+template <>
+struct hash<cmInternedString>
+{
+  using argument_type = cmInternedString;
+  using result_type = size_t;
+
+  result_type operator()(argument_type const& s) const noexcept
+  {
+    return s.hash();
+  }
+};
+}
+
+#endif
@@ -103,6 +103,23 @@ bool GetList(std::vector<std::string>& list, const std::string& var,
   return true;
 }
 
+// Get the elements of a list variable.  A list held by the makefile as
+// elements is used directly and never has empty elements.  Any other
+// value is expanded into `storage`.
+std::vector<std::string> const* GetListElements(
+  std::vector<std::string>& storage, const std::string& var,
+  const cmMakefile& makefile)
+{
+  if (std::vector<std::string> const* list =
+        makefile.GetListDefinition(var)) {
+    return list;
+  }
+  if (!GetList(storage, var, makefile)) {
+    return nullptr;
+  }
+  return &storage;
+}
+
 bool HandleLengthCommand(std::vector<std::string> const& args,
                          cmExecutionStatus& status)
 {
@@ -114,11 +131,10 @@ bool HandleLengthCommand(std::vector<std::string> const& args,
   const std::string& listName = args[1];
   const std::string& variableName = args.back();
   std::vector<std::string> varArgsExpanded;
-  // do not check the return value here
-  // if the list var is not found varArgsExpanded will have size 0
-  // and we will return 0
-  GetList(varArgsExpanded, listName, status.GetMakefile());
-  size_t length = varArgsExpanded.size();
+  // if the list var is not found we will return 0
+  std::vector<std::string> const* list =
+    GetListElements(varArgsExpanded, listName, status.GetMakefile());
+  size_t length = list ? list->size() : 0;
   char buffer[1024];
   sprintf(buffer, "%d", static_cast<int>(length));
 
@@ -138,12 +154,14 @@ bool HandleGetCommand(std::vector<std::string> const& args,
   const std::string& variableName = args.back();
   // expand the variable
   std::vector<std::string> varArgsExpanded;
-  if (!GetList(varArgsExpanded, listName, status.GetMakefile())) {
+  std::vector<std::string> const* list =
+    GetListElements(varArgsExpanded, listName, status.GetMakefile());
+  if (!list) {
     status.GetMakefile().AddDefinition(variableName, "NOTFOUND");
     return true;
   }
   // FIXME: Add policy to make non-existing lists an error like empty lists.
-  if (varArgsExpanded.empty()) {
+  if (list->empty()) {
     status.SetError("GET given empty list");
     return false;
   }
@@ -151,7 +169,7 @@ bool HandleGetCommand(std::vector<std::string> const& args,
   std::string value;
   size_t cc;
   const char* sep = "";
-  size_t nitem = varArgsExpanded.size();
+  size_t nitem = list->size();
   for (cc = 2; cc < args.size() - 1; cc++) {
     int item = atoi(args[cc].c_str());
     value += sep;
@@ -164,7 +182,7 @@ bool HandleGetCommand(std::vector<std::string> const& args,
                                ", ", nitem - 1, ")"));
       return false;
     }
-    value += varArgsExpanded[item];
+    value += (*list)[item];
   }
 
   status.GetMakefile().AddDefinition(variableName, value);
@@ -183,6 +201,11 @@ bool HandleAppendCommand(std::vector<std::string> const& args,
 
   cmMakefile& makefile = status.GetMakefile();
   std::string const& listName = args[1];
+  // append to the list elements in place if possible
+  if (makefile.AppendListDefinition(listName, args.begin() + 2, args.end())) {
+    return true;
+  }
+
   // expand the variable
   std::string listString;
   GetListString(listString, listName, makefile);
@@ -233,6 +256,32 @@ bool HandlePopBackCommand(std::vector<std::string> const& args,
   auto ai = args.cbegin();
   ++ai; // Skip subcommand name
   std::string const& listName = *ai++;
+
+  // Remove the elements in place if possible.
+  std::vector<std::string> const* list = makefile.GetListDefinition(listName);
+  if (list && !list->empty()) {
+    std::size_t const count = ai == args.cend()
+      ? 1
+      : std::min(list->size(), static_cast<std::size_t>(args.cend() - ai));
+    std::vector<std::string> popped(list->rbegin(), list->rbegin() + count);
+    if (makefile.PopBackListDefinition(listName, count)) {
+      auto vi = popped.cbegin();
+      for (; ai != args.cend(); ++ai) {
+        // The list itself keeps its remaining elements.
+        if (*ai == listName) {
+          if (vi != popped.cend()) {
+            ++vi;
+          }
+        } else if (vi != popped.cend()) {
+          makefile.AddDefinition(*ai, *vi++);
+        } else {
+          makefile.RemoveDefinition(*ai);
+        }
+      }
+      return true;
+    }
+  }
+
   std::vector<std::string> varArgsExpanded;
   if (!GetList(varArgsExpanded, listName, makefile)) {
     // Can't get the list definition... undefine any vars given after.
@@ -333,16 +382,17 @@ bool HandleFindCommand(std::vector<std::string> const& args,
   const std::string& variableName = args.back();
   // expand the variable
   std::vector<std::string> varArgsExpanded;
-  if (!GetList(varArgsExpanded, listName, status.GetMakefile())) {
+  std::vector<std::string> const* list =
+    GetListElements(varArgsExpanded, listName, status.GetMakefile());
+  if (!list) {
     status.GetMakefile().AddDefinition(variableName, "-1");
     return true;
   }
 
-  auto it = std::find(varArgsExpanded.begin(), varArgsExpanded.end(), args[2]);
-  if (it != varArgsExpanded.end()) {
+  auto it = std::find(list->begin(), list->end(), args[2]);
+  if (it != list->end()) {
     status.GetMakefile().AddDefinition(
-      variableName,
-      std::to_string(std::distance(varArgsExpanded.begin(), it)));
+      variableName, std::to_string(std::distance(list->begin(), it)));
     return true;
   }
 
@@ -20,6 +20,8 @@ cmCommandContext::cmCommandName& cmCommandContext::cmCommandName::operator=(
 {
   this->Original = name;
   this->Lower = cmSystemTools::LowerCase(name);
+  this->Resolved.reset();
+  this->ResolvedGeneration = 0;
   return *this;
 }
 
@@ -44,6 +46,7 @@ struct cmListFileParser
   const char* FileName;
   cmListFileLexer* Lexer;
   cmListFileFunction Function;
+  bool Diagnosed = false;
   enum
   {
     SeparationOkay,
@@ -166,7 +169,7 @@ bool cmListFileParser::Parse()
 }
 
 bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
-                           cmListFileBacktrace const& lfbt)
+                           cmListFileBacktrace const& lfbt, bool* diagnosed)
 {
   if (!cmSystemTools::FileExists(filename) ||
       cmSystemTools::FileIsDirectory(filename)) {
@@ -178,6 +181,9 @@ bool cmListFile::ParseFile(const char* filename, cmMessenger* messenger,
   {
     cmListFileParser parser(this, lfbt, messenger);
     parseError = !parser.ParseFile(filename);
+    if (diagnosed) {
+      *diagnosed = parser.Diagnosed;
+    }
   }
 
   return !parseError;
@@ -319,6 +325,7 @@ bool cmListFileParser::AddArgument(cmListFileLexer_Token* token,
     return false;
   }
   this->Messenger->IssueMessage(MessageType::AUTHOR_WARNING, m.str(), lfbt);
+  this->Diagnosed = true;
   return true;
 }
 
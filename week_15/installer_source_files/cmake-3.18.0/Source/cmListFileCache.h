@@ -6,12 +6,14 @@
 #include "cmConfigure.h" // IWYU pragma: keep
 
 #include <cstddef>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "cmInternedString.h"
 #include "cmStateSnapshot.h"
 
 /** \class cmListFileCache
@@ -21,14 +23,27 @@
  * cmake list files.
  */
 
+class cmCompiledCondition;
+class cmExecutionStatus;
 class cmMessenger;
+struct cmListFileArgument;
+struct cmListFileArgumentTokens;
 
 struct cmCommandContext
 {
+  using Command = std::function<bool(std::vector<cmListFileArgument> const&,
+                                     cmExecutionStatus&)>;
+
   struct cmCommandName
   {
-    std::string Lower;
-    std::string Original;
+    cmInternedString Lower;
+    cmInternedString Original;
+    // Command resolved from the name by cmMakefile::ExecuteCommand and
+    // the cmState command generation it was resolved in.  Zero is never
+    // a valid generation.  Each copy of the name caches its own
+    // resolution; only the interned strings are shared.
+    mutable std::shared_ptr<Command const> Resolved;
+    mutable std::size_t ResolvedGeneration = 0;
     cmCommandName() = default;
     cmCommandName(std::string const& name) { *this = name; }
     cmCommandName& operator=(std::string const& name);
@@ -42,6 +57,20 @@ struct cmCommandContext
   }
 };
 
+// Data derived from the value of a cmListFileArgument.  It is allocated
+// with the argument and shared by all of its copies, so the copies that
+// function blockers record and replay fill in the original's cache.
+struct cmListFileArgumentCache
+{
+  // Tokenized form of the value, filled in by cmMakefile when the
+  // argument is first expanded.
+  std::shared_ptr<cmListFileArgumentTokens const> Tokens;
+
+  // Condition compiled by cmConditionEvaluator when this is the first
+  // argument of an if(), elseif() or while() command.
+  std::shared_ptr<cmCompiledCondition const> Condition;
+};
+
 struct cmListFileArgument
 {
   enum Delimiter
@@ -65,17 +94,22 @@ struct cmListFileArgument
   std::string Value;
   Delimiter Delim = Unquoted;
   long Line = 0;
+
+  // Shared by copies of the argument.  The Value of an argument must not
+  // change once it has been copied.
+  std::shared_ptr<cmListFileArgumentCache> Cache =
+    std::make_shared<cmListFileArgumentCache>();
 };
 
 class cmListFileContext
 {
 public:
-  std::string Name;
-  std::string FilePath;
+  cmInternedString Name;
+  cmInternedString FilePath;
   long Line = 0;
 
-  static cmListFileContext FromCommandContext(cmCommandContext const& lfcc,
-                                              std::string const& fileName)
+  static cmListFileContext FromCommandContext(
+    cmCommandContext const& lfcc, cmInternedString const& fileName)
   {
     cmListFileContext lfc;
     lfc.FilePath = fileName;
@@ -181,8 +215,11 @@ std::vector<BT<std::string>> ExpandListWithBacktrace(
 
 struct cmListFile
 {
+  /** Parse the given file.  If diagnosed is given, it is set to
+      whether any message was issued while parsing.  */
   bool ParseFile(const char* path, cmMessenger* messenger,
-                 cmListFileBacktrace const& lfbt);
+                 cmListFileBacktrace const& lfbt,
+                 bool* diagnosed = nullptr);
 
   bool ParseString(const char* str, const char* virtual_filename,
                    cmMessenger* messenger, cmListFileBacktrace const& lfbt);
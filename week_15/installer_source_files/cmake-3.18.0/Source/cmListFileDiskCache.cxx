@@ -0,0 +1,310 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmListFileDiskCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmCryptoHash.h"
+#include "cmListFileCache.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmVersion.h"
+
+namespace {
+
+// Bump whenever the encoding below changes.
+const char* const cmListFileDiskCacheFormat = "cmListFileDiskCache 1";
+
+void WriteVarint(std::string& out, std::uint64_t value)
+{
+  while (value >= 0x80) {
+    out += static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  out += static_cast<char>(value);
+}
+
+void WriteString(std::string& out, std::string const& value)
+{
+  WriteVarint(out, value.size());
+  out += value;
+}
+
+class Reader
+{
+public:
+  Reader(std::string const& data)
+    : Cur(data.data())
+    , End(data.data() + data.size())
+  {
+  }
+
+  bool AtEnd() const { return this->Cur == this->End; }
+
+  bool ReadVarint(std::uint64_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+      if (this->Cur == this->End) {
+        return false;
+      }
+      auto byte = static_cast<unsigned char>(*this->Cur++);
+      value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadLong(long& value)
+  {
+    std::uint64_t v;
+    if (!this->ReadVarint(v)) {
+      return false;
+    }
+    value = static_cast<long>(v);
+    return true;
+  }
+
+  bool ReadString(std::string& value)
+  {
+    std::uint64_t size;
+    if (!this->ReadVarint(size) ||
+        size > static_cast<std::uint64_t>(this->End - this->Cur)) {
+      return false;
+    }
+    value.assign(this->Cur, static_cast<std::size_t>(size));
+    this->Cur += size;
+    return true;
+  }
+
+private:
+  const char* Cur;
+  const char* End;
+};
+
+bool ReadWholeFile(std::string const& path, std::string& content)
+{
+  cmsys::ifstream fin(path.c_str(), std::ios::in | std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(fin),
+                 std::istreambuf_iterator<char>());
+  return !fin.bad();
+}
+
+std::string ContentKey(std::string const& content)
+{
+  cmCryptoHash hasher(cmCryptoHash::AlgoSHA1);
+  std::vector<unsigned char> hash = hasher.ByteHashString(content);
+  std::string key(hash.begin(), hash.end());
+  WriteVarint(key, content.size());
+  return key;
+}
+
+std::string CacheHeader()
+{
+  return cmStrCat(cmListFileDiskCacheFormat, ' ',
+                  cmVersion::GetCMakeVersion());
+}
+}
+
+cmListFileDiskCache::cmListFileDiskCache(std::string file)
+  : File(std::move(file))
+{
+}
+
+cmListFileDiskCache::~cmListFileDiskCache() = default;
+
+void cmListFileDiskCache::Load()
+{
+  this->Entries.clear();
+  this->Modified = false;
+
+  std::string data;
+  if (!ReadWholeFile(this->File, data)) {
+    return;
+  }
+
+  Reader reader(data);
+  std::string header;
+  std::uint64_t count;
+  if (!reader.ReadString(header) || header != CacheHeader() ||
+      !reader.ReadVarint(count)) {
+    return;
+  }
+
+  std::unordered_map<std::string, Entry> entries;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::string key;
+    Entry entry;
+    if (!reader.ReadString(key) || !reader.ReadString(entry.Data)) {
+      return;
+    }
+    entries.emplace(std::move(key), std::move(entry));
+  }
+  if (!reader.AtEnd()) {
+    return;
+  }
+  this->Entries = std::move(entries);
+}
+
+void cmListFileDiskCache::Save()
+{
+  // Drop entries for content no longer read by the project.
+  for (auto it = this->Entries.begin(); it != this->Entries.end();) {
+    if (it->second.Used) {
+      ++it;
+    } else {
+      it = this->Entries.erase(it);
+      this->Modified = true;
+    }
+  }
+  if (!this->Modified) {
+    return;
+  }
+
+  // Write entries in a stable order so identical caches compare equal.
+  std::vector<std::pair<std::string const, Entry>*> sorted;
+  sorted.reserve(this->Entries.size());
+  for (auto& entry : this->Entries) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](std::pair<std::string const, Entry> const* l,
+               std::pair<std::string const, Entry> const* r) {
+              return l->first < r->first;
+            });
+
+  std::string data;
+  WriteString(data, CacheHeader());
+  WriteVarint(data, sorted.size());
+  for (auto const* entry : sorted) {
+    WriteString(data, entry->first);
+    WriteString(data, entry->second.Data);
+  }
+
+  // Write to a temporary file and move it into place so that an
+  // interrupted configure never leaves a truncated cache behind.
+  cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(this->File));
+  std::string const tmpFile = cmStrCat(this->File, ".tmp");
+  {
+    cmsys::ofstream fout(tmpFile.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!fout) {
+      return;
+    }
+    fout.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!fout) {
+      fout.close();
+      cmSystemTools::RemoveFile(tmpFile);
+      return;
+    }
+  }
+  if (cmSystemTools::RenameFile(tmpFile, this->File)) {
+    this->Modified = false;
+  } else {
+    cmSystemTools::RemoveFile(tmpFile);
+  }
+}
+
+bool cmListFileDiskCache::ParseFile(cmListFile& listFile, const char* path,
+                                    cmMessenger* messenger,
+                                    cmListFileBacktrace const& lfbt)
+{
+  if (!cmSystemTools::FileExists(path) ||
+      cmSystemTools::FileIsDirectory(path)) {
+    return false;
+  }
+
+  std::string content;
+  if (!ReadWholeFile(path, content)) {
+    // Let the parser report the error.
+    return listFile.ParseFile(path, messenger, lfbt);
+  }
+
+  std::string key = ContentKey(content);
+  auto it = this->Entries.find(key);
+  if (it != this->Entries.end() && Decode(it->second.Data, listFile)) {
+    it->second.Used = true;
+    return true;
+  }
+
+  bool diagnosed = false;
+  if (!listFile.ParseFile(path, messenger, lfbt, &diagnosed)) {
+    return false;
+  }
+
+  // Files that produced a warning are not stored so that the
+  // warning is issued again by the next run.
+  if (!diagnosed) {
+    Entry& entry = this->Entries[std::move(key)];
+    entry.Data = Encode(listFile);
+    entry.Used = true;
+    this->Modified = true;
+  }
+  return true;
+}
+
+std::string cmListFileDiskCache::Encode(cmListFile const& listFile)
+{
+  std::string data;
+  WriteVarint(data, listFile.Functions.size());
+  for (cmListFileFunction const& func : listFile.Functions) {
+    WriteString(data, func.Name.Original);
+    WriteVarint(data, static_cast<std::uint64_t>(func.Line));
+    WriteVarint(data, func.Arguments.size());
+    for (cmListFileArgument const& arg : func.Arguments) {
+      WriteString(data, arg.Value);
+      WriteVarint(data, static_cast<std::uint64_t>(arg.Delim));
+      WriteVarint(data, static_cast<std::uint64_t>(arg.Line));
+    }
+  }
+  return data;
+}
+
+bool cmListFileDiskCache::Decode(std::string const& data, cmListFile& listFile)
+{
+  Reader reader(data);
+  std::uint64_t functionCount;
+  if (!reader.ReadVarint(functionCount)) {
+    return false;
+  }
+
+  std::vector<cmListFileFunction> functions;
+  for (std::uint64_t i = 0; i < functionCount; ++i) {
+    cmListFileFunction func;
+    std::string name;
+    std::uint64_t argumentCount;
+    if (!reader.ReadString(name) || !reader.ReadLong(func.Line) ||
+        !reader.ReadVarint(argumentCount)) {
+      return false;
+    }
+    func.Name = name;
+    for (std::uint64_t j = 0; j < argumentCount; ++j) {
+      cmListFileArgument arg;
+      std::uint64_t delim;
+      if (!reader.ReadString(arg.Value) || !reader.ReadVarint(delim) ||
+          delim > cmListFileArgument::Bracket || !reader.ReadLong(arg.Line)) {
+        return false;
+      }
+      arg.Delim = static_cast<cmListFileArgument::Delimiter>(delim);
+      func.Arguments.push_back(std::move(arg));
+    }
+    functions.push_back(std::move(func));
+  }
+  if (!reader.AtEnd()) {
+    return false;
+  }
+
+  listFile.Functions = std::move(functions);
+  return true;
+}
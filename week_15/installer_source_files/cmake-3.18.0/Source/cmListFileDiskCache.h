@@ -0,0 +1,60 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmListFileDiskCache_h
+#define cmListFileDiskCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <unordered_map>
+
+class cmListFileBacktrace;
+class cmMessenger;
+struct cmListFile;
+
+/** \class cmListFileDiskCache
+ * \brief Persists parsed list files across configure runs.
+ *
+ * Entries are keyed by a hash of the list file content and hold the
+ * parsed functions, arguments, delimiters and line numbers.  Only files
+ * that parse without any diagnostic are stored, so a cache hit produces
+ * exactly the same messages and backtraces as the lexer would.
+ */
+class cmListFileDiskCache
+{
+public:
+  cmListFileDiskCache(std::string file);
+  ~cmListFileDiskCache();
+
+  cmListFileDiskCache(const cmListFileDiskCache&) = delete;
+  cmListFileDiskCache& operator=(const cmListFileDiskCache&) = delete;
+
+  /** Read previously stored entries.  A missing, truncated or
+      mismatching cache file is silently treated as empty.  */
+  void Load();
+
+  /** Write the entries used by this run back to disk, dropping any
+      stale ones.  Nothing is written if the cache is unchanged.  */
+  void Save();
+
+  /** Parse the given file, using the stored result if the content
+      has been parsed before.  Behaves like cmListFile::ParseFile.  */
+  bool ParseFile(cmListFile& listFile, const char* path,
+                 cmMessenger* messenger, cmListFileBacktrace const& lfbt);
+
+private:
+  struct Entry
+  {
+    std::string Data;
+    bool Used = false;
+  };
+
+  static std::string Encode(cmListFile const& listFile);
+  static bool Decode(std::string const& data, cmListFile& listFile);
+
+  std::string File;
+  std::unordered_map<std::string, Entry> Entries;
+  bool Modified = false;
+};
+
+#endif
@@ -10,6 +10,7 @@
 #include "cmGeneratorTarget.h"
 #include "cmGhsMultiTargetGenerator.h"
 #include "cmGlobalGenerator.h"
+#include "cmMakefileProfilingData.h"
 #include "cmSourceFile.h"
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
@@ -46,6 +47,8 @@ void cmLocalGhsMultiGenerator::GenerateTargetsDepthFirst(
   // we are handling it now.
   *it = nullptr;
 
+  cmMakefileProfilingData::Scope profilingScope(this->GetCMakeInstance(),
+                                                "target", target->GetName());
   cmGhsMultiTargetGenerator tg(target);
   tg.Generate();
 }
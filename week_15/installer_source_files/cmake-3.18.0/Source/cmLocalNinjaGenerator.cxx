@@ -22,6 +22,7 @@
 #include "cmGlobalNinjaGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
+#include "cmMakefileProfilingData.h"
 #include "cmNinjaTargetGenerator.h"
 #include "cmProperty.h"
 #include "cmRulePlaceholderExpander.h"
@@ -63,15 +64,10 @@ void cmLocalNinjaGenerator::Generate()
     this->HomeRelativeOutputPath.clear();
   }
 
-  if (this->GetGlobalGenerator()->IsMultiConfig()) {
-    for (auto const& config : this->GetConfigNames()) {
-      this->WriteProcessedMakefile(this->GetImplFileStream(config));
-    }
+  bool const shard = this->GetGlobalNinjaGenerator()->ShardByDirectory();
+  if (!shard) {
+    this->WriteProcessedMakefiles();
   }
-  this->WriteProcessedMakefile(this->GetCommonFileStream());
-#ifdef NINJA_GEN_VERBOSE_FILES
-  this->WriteProcessedMakefile(this->GetRulesFileStream());
-#endif
 
   // We do that only once for the top CMakeLists.txt file.
   if (this->IsRootMakefile()) {
@@ -89,12 +85,22 @@ void cmLocalNinjaGenerator::Generate()
     }
   }
 
+  // The statements of this directory go to its own files from here on.
+  if (shard) {
+    if (!this->GetGlobalNinjaGenerator()->OpenDirectoryShards(this)) {
+      return;
+    }
+    this->WriteProcessedMakefiles();
+  }
+
   for (const auto& target : this->GetGeneratorTargets()) {
     if (target->GetType() == cmStateEnums::INTERFACE_LIBRARY) {
       continue;
     }
     auto tg = cmNinjaTargetGenerator::New(target.get());
     if (tg) {
+      cmMakefileProfilingData::Scope profilingScope(
+        this->GetCMakeInstance(), "target", target->GetName());
       if (target->Target->IsPerConfig()) {
         for (auto const& config : this->GetConfigNames()) {
           tg->Generate(config);
@@ -146,6 +152,10 @@ void cmLocalNinjaGenerator::Generate()
     this->WriteCustomCommandBuildStatements(config);
     this->AdditionalCleanFiles(config);
   }
+
+  if (shard) {
+    this->GetGlobalNinjaGenerator()->CloseDirectoryShards();
+  }
 }
 
 // TODO: Picked up from cmLocalUnixMakefileGenerator3.  Refactor it.
@@ -338,6 +348,19 @@ void cmLocalNinjaGenerator::WriteNinjaFilesInclusionCommon(std::ostream& os)
   os << "\n";
 }
 
+void cmLocalNinjaGenerator::WriteProcessedMakefiles()
+{
+  if (this->GetGlobalGenerator()->IsMultiConfig()) {
+    for (auto const& config : this->GetConfigNames()) {
+      this->WriteProcessedMakefile(this->GetImplFileStream(config));
+    }
+  }
+  this->WriteProcessedMakefile(this->GetCommonFileStream());
+#ifdef NINJA_GEN_VERBOSE_FILES
+  this->WriteProcessedMakefile(this->GetRulesFileStream());
+#endif
+}
+
 void cmLocalNinjaGenerator::WriteProcessedMakefile(std::ostream& os)
 {
   cmGlobalNinjaGenerator::WriteDivider(os);
@@ -382,6 +405,28 @@ void cmLocalNinjaGenerator::AppendCustomCommandDeps(
   }
 }
 
+std::string const& cmLocalNinjaGenerator::GetToolchainFingerprint(
+  std::string const& lang)
+{
+  auto i = this->ToolchainFingerprints.find(lang);
+  if (i == this->ToolchainFingerprints.end()) {
+    std::string const prefix = cmStrCat("CMAKE_", lang, '_');
+    cmCryptoHash hash(cmCryptoHash::AlgoSHA256);
+    hash.Initialize();
+    // GetDefinitions() returns a sorted list, so the hash is stable.
+    for (std::string const& name : this->Makefile->GetDefinitions()) {
+      if (cmHasPrefix(name, prefix)) {
+        hash.Append(name);
+        hash.Append("=", 1);
+        hash.Append(this->Makefile->GetSafeDefinition(name));
+        hash.Append("\n", 1);
+      }
+    }
+    i = this->ToolchainFingerprints.emplace(lang, hash.FinalizeHex()).first;
+  }
+  return i->second;
+}
+
 std::string cmLocalNinjaGenerator::WriteCommandScript(
   std::vector<std::string> const& cmdLines, std::string const& customStep,
   cmGeneratorTarget const* target) const
@@ -79,6 +79,10 @@ public:
                                cmNinjaDeps& ninjaDeps,
                                const std::string& config);
 
+  /// @returns a hash of the CMAKE_<LANG>_* variables visible in this
+  /// directory, which describe the toolchain used for @a lang.
+  std::string const& GetToolchainFingerprint(std::string const& lang);
+
 protected:
   std::string ConvertToIncludeReference(
     std::string const& path,
@@ -97,6 +101,7 @@ private:
                                        const std::string& config);
   void WriteNinjaFilesInclusionConfig(std::ostream& os);
   void WriteNinjaFilesInclusionCommon(std::ostream& os);
+  void WriteProcessedMakefiles();
   void WriteProcessedMakefile(std::ostream& os);
   void WritePools(std::ostream& os);
 
@@ -120,6 +125,7 @@ private:
     std::map<cmCustomCommand const*, std::set<cmGeneratorTarget*>>;
   CustomCommandTargetMap CustomCommandTargets;
   std::vector<cmCustomCommand const*> CustomCommands;
+  std::map<std::string, std::string> ToolchainFingerprints;
 };
 
 #endif // ! cmLocalNinjaGenerator_h
@@ -47,6 +47,9 @@
 #ifndef CMAKE_BOOTSTRAP
 #  include "cmDependsFortran.h"
 #  include "cmDependsJava.h"
+#  include "cmGccDepfileReader.h"
+#  include "cmGccDepfileReaderTypes.h"
+#  include "cmMakefileProfilingData.h"
 #endif
 
 // Helper function used below.
@@ -107,6 +110,10 @@ void cmLocalUnixMakefileGenerator3::Generate()
     std::unique_ptr<cmMakefileTargetGenerator> tg(
       cmMakefileTargetGenerator::New(target.get()));
     if (tg) {
+#ifndef CMAKE_BOOTSTRAP
+      cmMakefileProfilingData::Scope profilingScope(
+        this->GetCMakeInstance(), "target", target->GetName());
+#endif
       tg->WriteRuleFiles();
       gg->RecordTargetProgress(tg.get());
     }
@@ -756,10 +763,13 @@ void cmLocalUnixMakefileGenerator3::WriteSpecialTargetsBottom(
     std::vector<std::string> commands;
     cmake* cm = this->GlobalGenerator->GetCMakeInstance();
     if (cm->DoWriteGlobVerifyTarget()) {
-      std::string rescanRule =
-        cmStrCat("$(CMAKE_COMMAND) -P ",
-                 this->ConvertToOutputFormat(cm->GetGlobVerifyScript(),
-                                             cmOutputConverter::SHELL));
+      std::string rescanRule = cmStrCat(
+        "$(CMAKE_COMMAND) -E cmake_verify_globs ",
+        this->ConvertToOutputFormat(cm->GetGlobVerifyState(),
+                                    cmOutputConverter::SHELL),
+        ' ',
+        this->ConvertToOutputFormat(cm->GetGlobVerifyScript(),
+                                    cmOutputConverter::SHELL));
       commands.push_back(rescanRule);
     }
     std::string cmakefileName = "CMakeFiles/Makefile.cmake";
@@ -1294,6 +1304,12 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
   std::string const internalDependFile = targetDir + "/depend.internal";
   std::string const dependFile = targetDir + "/depend.make";
 
+  // Merge the dependencies written by the compiler.  These are
+  // independent of the scanned dependencies below.
+  if (!this->UpdateCompilerDependencies(targetDir, tgtInfo, verbose)) {
+    return false;
+  }
+
   // If the target DependInfo.cmake file has changed since the last
   // time dependencies were scanned then force rescanning.  This may
   // happen when a new source file is added and CMake regenerates the
@@ -1374,6 +1390,110 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(
   return true;
 }
 
+bool cmLocalUnixMakefileGenerator3::UpdateCompilerDependencies(
+  std::string const& targetDir, std::string const& tgtInfo, bool verbose)
+{
+#ifndef CMAKE_BOOTSTRAP
+  std::vector<std::string> const depFiles = cmExpandedList(
+    this->Makefile->GetSafeDefinition("CMAKE_DEPENDS_DEPENDENCY_FILES"));
+  std::string const compilerDependFile =
+    cmStrCat(targetDir, "/compiler_depend.make");
+  cmFileTimeCache* ftc =
+    this->GlobalGenerator->GetCMakeInstance()->GetFileTimeCache();
+
+  // The merged file is up to date unless the target information or one
+  // of the dependency files written by the compiler is newer.
+  bool needMerge = false;
+  {
+    int result;
+    if (!ftc->Compare(compilerDependFile, tgtInfo, &result) || result < 0) {
+      needMerge = true;
+    }
+  }
+  for (std::size_t i = 1; !needMerge && i < depFiles.size(); i += 2) {
+    int result;
+    if (cmSystemTools::FileExists(depFiles[i]) &&
+        (!ftc->Compare(compilerDependFile, depFiles[i], &result) ||
+         result < 0)) {
+      if (verbose) {
+        cmSystemTools::Stdout(cmStrCat("Dependee \"", depFiles[i],
+                                       "\" is newer than depender \"",
+                                       compilerDependFile, "\".\n"));
+      }
+      needMerge = true;
+    }
+  }
+  if (!needMerge) {
+    return true;
+  }
+
+  // Paths in the dependency files are relative to the directory in
+  // which the compiler ran.
+  std::string const& currentBinDir = this->GetCurrentBinaryDirectory();
+  std::string const& binDir = this->GetBinaryDirectory();
+  std::set<std::string> allDepends;
+  std::map<std::string, std::set<std::string>> objectDepends;
+  for (std::size_t i = 0; i + 1 < depFiles.size(); i += 2) {
+    std::string const& obj = depFiles[i];
+    std::string const& depFile = depFiles[i + 1];
+    if (!cmSystemTools::FileExists(depFile)) {
+      // The object has not been compiled yet.
+      continue;
+    }
+    std::set<std::string>& depends = objectDepends[obj];
+    for (cmGccStyleDependency const& dep :
+         cmReadGccDepfile(depFile.c_str())) {
+      for (std::string const& path : dep.paths) {
+        std::string const fullPath =
+          cmSystemTools::CollapseFullPath(path, currentBinDir);
+        depends.insert(fullPath);
+        allDepends.insert(fullPath);
+      }
+    }
+  }
+
+  // This should be copy-if-different because the make tool may try to
+  // reload it needlessly otherwise.
+  cmGeneratedFileStream ruleFileStream(
+    compilerDependFile, false, this->GlobalGenerator->GetMakefileEncoding());
+  ruleFileStream.SetCopyIfDifferent(true);
+  if (!ruleFileStream) {
+    return false;
+  }
+  this->WriteDisclaimer(ruleFileStream);
+  ruleFileStream << "# Dependencies generated by the compiler.\n\n";
+
+  for (auto const& od : objectDepends) {
+    std::string const obj =
+      this->ConvertToMakefilePath(this->MaybeConvertToRelativePath(
+        binDir, od.first));
+    for (std::string const& dep : od.second) {
+      ruleFileStream << obj << ": "
+                     << this->ConvertToMakefilePath(
+                          this->MaybeConvertToRelativePath(binDir, dep))
+                     << "\n";
+    }
+    ruleFileStream << "\n";
+  }
+
+  // Empty rules for each dependency keep the build working after a
+  // header has been removed.
+  if (!allDepends.empty()) {
+    ruleFileStream << "\n";
+    for (std::string const& dep : allDepends) {
+      ruleFileStream << this->ConvertToMakefilePath(
+                          this->MaybeConvertToRelativePath(binDir, dep))
+                     << ":\n";
+    }
+  }
+#else
+  static_cast<void>(targetDir);
+  static_cast<void>(tgtInfo);
+  static_cast<void>(verbose);
+#endif
+  return true;
+}
+
 bool cmLocalUnixMakefileGenerator3::ScanDependencies(
   std::string const& targetDir, std::string const& dependFile,
   std::string const& internalDependFile, cmDepends::DependencyMap& validDeps)
@@ -1672,10 +1792,13 @@ void cmLocalUnixMakefileGenerator3::WriteLocalAllRules(
     commands.clear();
     cmake* cm = this->GlobalGenerator->GetCMakeInstance();
     if (cm->DoWriteGlobVerifyTarget()) {
-      std::string rescanRule =
-        cmStrCat("$(CMAKE_COMMAND) -P ",
-                 this->ConvertToOutputFormat(cm->GetGlobVerifyScript(),
-                                             cmOutputConverter::SHELL));
+      std::string rescanRule = cmStrCat(
+        "$(CMAKE_COMMAND) -E cmake_verify_globs ",
+        this->ConvertToOutputFormat(cm->GetGlobVerifyState(),
+                                    cmOutputConverter::SHELL),
+        ' ',
+        this->ConvertToOutputFormat(cm->GetGlobVerifyScript(),
+                                    cmOutputConverter::SHELL));
       commands.push_back(rescanRule);
     }
     std::string cmakefileName = "CMakeFiles/Makefile.cmake";
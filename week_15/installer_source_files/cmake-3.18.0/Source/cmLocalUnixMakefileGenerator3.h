@@ -243,6 +243,8 @@ protected:
                         std::string const& dependFile,
                         std::string const& internalDependFile,
                         cmDepends::DependencyMap& validDeps);
+  bool UpdateCompilerDependencies(std::string const& targetDir,
+                                  std::string const& tgtInfo, bool verbose);
   void CheckMultipleOutputs(bool verbose);
 
 private:
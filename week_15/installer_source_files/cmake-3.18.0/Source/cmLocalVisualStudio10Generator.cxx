@@ -10,6 +10,7 @@
 #include "cmGeneratorTarget.h"
 #include "cmGlobalVisualStudio10Generator.h"
 #include "cmMakefile.h"
+#include "cmMakefileProfilingData.h"
 #include "cmVisualStudio10TargetGenerator.h"
 #include "cmXMLParser.h"
 #include "cmake.h"
@@ -90,6 +91,8 @@ void cmLocalVisualStudio10Generator::GenerateTargetsDepthFirst(
     auto visited = GetSourcesVisited(dependee);
     GetSourcesVisited(target).insert(visited.begin(), visited.end());
   }
+  cmMakefileProfilingData::Scope profilingScope(
+    this->GetCMakeInstance(), "target", target->GetName());
   if (static_cast<cmGlobalVisualStudioGenerator*>(this->GlobalGenerator)
         ->TargetIsFortranOnly(target)) {
     this->CreateSingleVCProj(target->GetName(), target);
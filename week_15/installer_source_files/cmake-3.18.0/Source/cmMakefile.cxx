@@ -57,12 +57,16 @@
 #include "cmTargetLinkLibraryType.h"
 #include "cmTest.h"
 #include "cmTestGenerator.h" // IWYU pragma: keep
+#include "cmTryCompileBatch.h"
 #include "cmVersion.h"
 #include "cmWorkingDirectory.h"
 #include "cmake.h"
 
 #ifndef CMAKE_BOOTSTRAP
+#  include "cmBinaryTraceWriter.h"
+#  include "cmListFileDiskCache.h"
 #  include "cmMakefileProfilingData.h"
+#  include "cmMakefileProfilingSampler.h"
 #  include "cmVariableWatch.h"
 #endif
 
@@ -313,11 +317,34 @@ void cmMakefile::PrintCommandTrace(const cmListFileFunction& lff) const
     }
   }
 
-  std::ostringstream msg;
-  std::vector<std::string> args;
   std::string temp;
   bool expand = this->GetCMakeInstance()->GetTraceExpand();
 
+#ifndef CMAKE_BOOTSTRAP
+  // Hand the arguments straight to the binary writer.
+  if (cmBinaryTraceWriter* writer =
+        this->GetCMakeInstance()->GetBinaryTraceWriter()) {
+    writer->BeginCommand(full_path, lff.Line, lff.Name.Original,
+                         cmSystemTools::GetTime(),
+                         this->ExecutionStatusStack.size(),
+                         lff.Arguments.size());
+    for (cmListFileArgument const& arg : lff.Arguments) {
+      if (expand) {
+        temp = arg.Value;
+        this->ExpandVariablesInString(temp);
+        writer->AddArgument(temp);
+      } else {
+        writer->AddArgument(arg.Value);
+      }
+    }
+    writer->EndCommand();
+    return;
+  }
+#endif
+
+  std::ostringstream msg;
+  std::vector<std::string> args;
+
   args.reserve(lff.Arguments.size());
   for (cmListFileArgument const& arg : lff.Arguments) {
     if (expand) {
@@ -337,7 +364,7 @@ void cmMakefile::PrintCommandTrace(const cmListFileFunction& lff) const
       builder["indentation"] = "";
       val["file"] = full_path;
       val["line"] = static_cast<Json::Value::Int64>(lff.Line);
-      val["cmd"] = lff.Name.Original;
+      val["cmd"] = lff.Name.Original.str();
       val["args"] = Json::Value(Json::arrayValue);
       for (std::string const& arg : args) {
         val["args"].append(arg);
@@ -358,6 +385,9 @@ void cmMakefile::PrintCommandTrace(const cmListFileFunction& lff) const
       }
       msg << ")";
       break;
+    case cmake::TraceFormat::TRACE_BINARY_V1:
+      // Written above when the binary writer is available.
+      break;
     case cmake::TraceFormat::TRACE_UNDEFINED:
       msg << "INTERNAL ERROR: Trace format is TRACE_UNDEFINED";
       break;
@@ -385,9 +415,13 @@ public:
     ++this->Makefile->RecursionDepth;
     this->Makefile->ExecutionStatusStack.push_back(&status);
 #if !defined(CMAKE_BOOTSTRAP)
-    if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
-      this->Makefile->GetCMakeInstance()->GetProfilingOutput().StartEntry(lff,
-                                                                          lfc);
+    cmake* cm = this->Makefile->GetCMakeInstance();
+    if (cm->IsProfilingEnabled()) {
+      cm->GetProfilingOutput().StartEntry(
+        lff, lfc, cm->GetState()->IsScriptedCommand(lff.Name.Lower));
+    }
+    if (cmMakefileProfilingSampler* sampler = cm->GetProfilingSampler()) {
+      sampler->Poll(this->Makefile->Backtrace);
     }
 #endif
   }
@@ -395,8 +429,12 @@ public:
   ~cmMakefileCall()
   {
 #if !defined(CMAKE_BOOTSTRAP)
-    if (this->Makefile->GetCMakeInstance()->IsProfilingEnabled()) {
-      this->Makefile->GetCMakeInstance()->GetProfilingOutput().StopEntry();
+    cmake* cm = this->Makefile->GetCMakeInstance();
+    if (cm->IsProfilingEnabled()) {
+      cm->GetProfilingOutput().StopEntry();
+    }
+    if (cmMakefileProfilingSampler* sampler = cm->GetProfilingSampler()) {
+      sampler->Poll(this->Makefile->Backtrace);
     }
 #endif
     this->Makefile->ExecutionStatusStack.pop_back();
@@ -453,9 +491,15 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     return false;
   }
 
-  // Lookup the command prototype.
-  if (cmState::Command command =
-        this->GetState()->GetCommandByExactName(lff.Name.Lower)) {
+  // Lookup the command prototype.  The result is cached on the function
+  // name until a command is added, replaced or removed.
+  cmState* state = this->GetState();
+  if (lff.Name.ResolvedGeneration != state->GetCommandGeneration()) {
+    lff.Name.Resolved = state->ResolveCommand(lff.Name.Lower);
+    lff.Name.ResolvedGeneration = state->GetCommandGeneration();
+  }
+  // Hold a reference in case the command redefines itself.
+  if (std::shared_ptr<cmState::Command const> command = lff.Name.Resolved) {
     // Decide whether to invoke the command.
     if (!cmSystemTools::GetFatalErrorOccured()) {
       // if trace is enabled, print out invoke information
@@ -463,7 +507,7 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
         this->PrintCommandTrace(lff);
       }
       // Try invoking the command.
-      bool invokeSucceeded = command(lff.Arguments, status);
+      bool invokeSucceeded = (*command)(lff.Arguments, status);
       bool hadNestedError = status.GetNestedError();
       if (!invokeSucceeded || hadNestedError) {
         if (!hadNestedError) {
@@ -481,7 +525,7 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
   } else {
     if (!cmSystemTools::GetFatalErrorOccured()) {
       std::string error =
-        cmStrCat("Unknown CMake command \"", lff.Name.Original, "\".");
+        cmStrCat("Unknown CMake command \"", lff.Name.Original.str(), "\".");
       this->IssueMessage(MessageType::FATAL_ERROR, error);
       result = false;
       cmSystemTools::SetFatalErrorOccured();
@@ -632,8 +676,7 @@ bool cmMakefile::ReadDependentFile(const std::string& filename,
   IncludeScope incScope(this, filenametoread, noPolicyScope);
 
   cmListFile listFile;
-  if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  if (!this->ParseListFile(listFile, filenametoread)) {
     return false;
   }
 
@@ -686,8 +729,7 @@ bool cmMakefile::ReadListFile(const std::string& filename)
   ListFileScope scope(this, filenametoread);
 
   cmListFile listFile;
-  if (!listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  if (!this->ParseListFile(listFile, filenametoread)) {
     return false;
   }
 
@@ -719,6 +761,20 @@ bool cmMakefile::ReadListFileAsString(const std::string& content,
   return true;
 }
 
+bool cmMakefile::ParseListFile(cmListFile& listFile,
+                               std::string const& filenametoread)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmListFileDiskCache* cache =
+        this->GetCMakeInstance()->GetListFileDiskCache()) {
+    return cache->ParseFile(listFile, filenametoread.c_str(),
+                            this->GetMessenger(), this->Backtrace);
+  }
+#endif
+  return listFile.ParseFile(filenametoread.c_str(), this->GetMessenger(),
+                            this->Backtrace);
+}
+
 void cmMakefile::ReadListFile(cmListFile const& listFile,
                               std::string const& filenametoread)
 {
@@ -1613,8 +1669,7 @@ void cmMakefile::Configure()
   this->AddDefinition("CMAKE_PARENT_LIST_FILE", currentStart);
 
   cmListFile listFile;
-  if (!listFile.ParseFile(currentStart.c_str(), this->GetMessenger(),
-                          this->Backtrace)) {
+  if (!this->ParseListFile(listFile, currentStart)) {
     return;
   }
   if (this->IsRootMakefile()) {
@@ -1695,6 +1750,13 @@ void cmMakefile::Configure()
   }
 
   this->ReadListFile(listFile, currentStart);
+  if (this->TryCompileBatch) {
+    this->GetCMakeInstance()->IssueMessage(
+      MessageType::FATAL_ERROR,
+      "try_compile_batch(BEGIN) has no matching try_compile_batch(END).",
+      this->TryCompileBatch->Backtrace);
+    this->TryCompileBatch.reset();
+  }
   if (cmSystemTools::GetFatalErrorOccured()) {
     scope.Quiet();
   }
@@ -2763,6 +2825,55 @@ bool cmMakefile::GetDefExpandList(const std::string& name,
   return true;
 }
 
+const std::vector<std::string>* cmMakefile::GetListDefinition(
+  const std::string& name) const
+{
+#ifndef CMAKE_BOOTSTRAP
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv && vv->IsWatched(name)) {
+    return nullptr;
+  }
+#endif
+  return this->StateSnapshot.GetListDefinition(name);
+}
+
+bool cmMakefile::AppendListDefinition(
+  const std::string& name, std::vector<std::string>::const_iterator first,
+  std::vector<std::string>::const_iterator last)
+{
+  // Unused variable warnings and watches need the generic path.
+  if (this->WarnUnused) {
+    return false;
+  }
+#ifndef CMAKE_BOOTSTRAP
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv && vv->IsWatched(name)) {
+    return false;
+  }
+#endif
+  // A cache entry is read when no normal variable is set.
+  if (!this->StateSnapshot.GetListDefinition(name) &&
+      this->GetState()->GetInitializedCacheValue(name)) {
+    return false;
+  }
+  return this->StateSnapshot.AppendListDefinition(name, first, last);
+}
+
+bool cmMakefile::PopBackListDefinition(const std::string& name,
+                                       std::size_t count)
+{
+  if (this->WarnUnused) {
+    return false;
+  }
+#ifndef CMAKE_BOOTSTRAP
+  cmVariableWatch* vv = this->GetVariableWatch();
+  if (vv && vv->IsWatched(name)) {
+    return false;
+  }
+#endif
+  return this->StateSnapshot.PopBackListDefinition(name, count);
+}
+
 std::vector<std::string> cmMakefile::GetDefinitions() const
 {
   std::vector<std::string> res = this->StateSnapshot.ClosureKeys();
@@ -3003,6 +3114,142 @@ struct t_lookup
   size_t loc = 0;
 };
 
+// The literal text and variable references of an argument, so that it
+// can be expanded again without scanning it.  Only arguments that the
+// CMP0053 NEW rules expand without error and without nested references
+// are tokenized.  Others are Dynamic and expanded from their text.
+struct cmListFileArgumentTokens
+{
+  enum TokensKind
+  {
+    Verbatim,
+    Tokenized,
+    Dynamic
+  };
+
+  struct Token
+  {
+    std::string Text;
+    bool Reference;
+    t_domain Domain;
+    long LineOffset;
+  };
+
+  cmListFileArgumentTokens(TokensKind kind)
+    : Kind(kind)
+  {
+  }
+
+  TokensKind Kind;
+  std::vector<Token> Tokens;
+};
+
+namespace {
+bool IsVariableNameChar(char c)
+{
+  return c != '\0' &&
+    (isalnum(static_cast<unsigned char>(c)) || strchr("_/.+-", c));
+}
+
+std::shared_ptr<cmListFileArgumentTokens const> TokenizeArgument(
+  std::string const& value)
+{
+  using Tokens = cmListFileArgumentTokens;
+  static std::shared_ptr<Tokens const> const verbatim =
+    std::make_shared<Tokens const>(Tokens::Verbatim);
+  static std::shared_ptr<Tokens const> const dynamic =
+    std::make_shared<Tokens const>(Tokens::Dynamic);
+
+  const char* in = value.c_str();
+  if (strlen(in) != value.size()) {
+    return dynamic;
+  }
+  // Most arguments have nothing to expand.  The C library scans for the
+  // special characters many bytes at a time.
+  if (in[strcspn(in, "$\\")] == '\0') {
+    return verbatim;
+  }
+
+  auto tokens = std::make_shared<Tokens>(Tokens::Tokenized);
+  std::string literal;
+  long lineOffset = 0;
+  auto flushLiteral = [&]() {
+    if (!literal.empty()) {
+      tokens->Tokens.push_back({ std::move(literal), false, NORMAL, 0 });
+      literal.clear();
+    }
+  };
+  while (*in) {
+    size_t const n = strcspn(in, "$\\\n");
+    literal.append(in, n);
+    in += n;
+    char const c = *in;
+    if (c == '\n') {
+      literal += c;
+      ++lineOffset;
+      ++in;
+    } else if (c == '\\') {
+      char const next = in[1];
+      if (next == 't') {
+        literal += '\t';
+      } else if (next == 'n') {
+        literal += '\n';
+      } else if (next == 'r') {
+        literal += '\r';
+      } else if (next == ';') {
+        // Handled in ExpandListArgument; pass the backslash literally.
+        literal += "\\;";
+      } else if (next == '\0' || isalnum(static_cast<unsigned char>(next))) {
+        // Invalid escape; let the expansion report it.
+        return dynamic;
+      } else {
+        literal += next;
+      }
+      in += 2;
+    } else if (c == '$') {
+      const char* next = in + 1;
+      const char* start = nullptr;
+      t_domain domain = NORMAL;
+      if (*next == '{') {
+        start = in + 2;
+      } else if (cmHasLiteralPrefix(next, "ENV{")) {
+        start = in + 5;
+        domain = ENVIRONMENT;
+      } else if (cmHasLiteralPrefix(next, "CACHE{")) {
+        start = in + 7;
+        domain = CACHE;
+      } else {
+        const char* end = next;
+        while (IsVariableNameChar(*end)) {
+          ++end;
+        }
+        if (end != next && *end == '{') {
+          // Unsupported $name{} syntax; let the expansion report it.
+          return dynamic;
+        }
+        literal += c;
+        ++in;
+        continue;
+      }
+      const char* end = start;
+      while (IsVariableNameChar(*end)) {
+        ++end;
+      }
+      if (*end != '}') {
+        // Nested, unterminated or invalid reference.
+        return dynamic;
+      }
+      flushLiteral();
+      tokens->Tokens.push_back(
+        { std::string(start, end), true, domain, lineOffset });
+      in = end + 1;
+    }
+  }
+  flushLiteral();
+  return tokens;
+}
+}
+
 bool cmMakefile::IsProjectFile(const char* filename) const
 {
   return cmSystemTools::IsSubDirectory(filename, this->GetHomeDirectory()) ||
@@ -3399,6 +3646,7 @@ bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
   if (!filename) {
     filename = efp.c_str();
   }
+  bool const useTokens = this->CanExpandArgumentTokens();
   std::string value;
   outArgs.reserve(inArgs.size());
   for (cmListFileArgument const& i : inArgs) {
@@ -3408,9 +3656,7 @@ bool cmMakefile::ExpandArguments(std::vector<cmListFileArgument> const& inArgs,
       continue;
     }
     // Expand the variables in the argument.
-    value = i.Value;
-    this->ExpandVariablesInString(value, false, false, false, filename, i.Line,
-                                  false, false);
+    this->ExpandArgument(i, filename, useTokens, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3431,6 +3677,7 @@ bool cmMakefile::ExpandArguments(
   if (!filename) {
     filename = efp.c_str();
   }
+  bool const useTokens = this->CanExpandArgumentTokens();
   std::string value;
   outArgs.reserve(inArgs.size());
   for (cmListFileArgument const& i : inArgs) {
@@ -3440,9 +3687,7 @@ bool cmMakefile::ExpandArguments(
       continue;
     }
     // Expand the variables in the argument.
-    value = i.Value;
-    this->ExpandVariablesInString(value, false, false, false, filename, i.Line,
-                                  false, false);
+    this->ExpandArgument(i, filename, useTokens, value);
 
     // If the argument is quoted, it should be one argument.
     // Otherwise, it may be a list of arguments.
@@ -3458,6 +3703,87 @@ bool cmMakefile::ExpandArguments(
   return !cmSystemTools::GetFatalErrorOccured();
 }
 
+bool cmMakefile::CanExpandArgumentTokens() const
+{
+  // The tokens follow the CMP0053 NEW rules.  The WARN case needs the
+  // OLD result and the comparison of both.
+  switch (this->GetPolicyStatus(cmPolicies::CMP0053)) {
+    case cmPolicies::WARN:
+    case cmPolicies::OLD:
+      return false;
+    case cmPolicies::REQUIRED_IF_USED:
+    case cmPolicies::REQUIRED_ALWAYS:
+    case cmPolicies::NEW:
+      break;
+  }
+  return true;
+}
+
+void cmMakefile::ExpandArgument(cmListFileArgument const& arg,
+                                const char* filename, bool useTokens,
+                                std::string& value) const
+{
+  if (useTokens) {
+    std::shared_ptr<cmListFileArgumentTokens const>& tokens =
+      arg.Cache->Tokens;
+    if (!tokens) {
+      tokens = TokenizeArgument(arg.Value);
+    }
+    switch (tokens->Kind) {
+      case cmListFileArgumentTokens::Verbatim:
+        value = arg.Value;
+        return;
+      case cmListFileArgumentTokens::Tokenized:
+        this->ExpandArgumentTokens(*tokens, filename, arg.Line, value);
+        return;
+      case cmListFileArgumentTokens::Dynamic:
+        break;
+    }
+  }
+  value = arg.Value;
+  this->ExpandVariablesInString(value, false, false, false, filename, arg.Line,
+                                false, false);
+}
+
+void cmMakefile::ExpandArgumentTokens(cmListFileArgumentTokens const& tokens,
+                                      const char* filename, long line,
+                                      std::string& value) const
+{
+  // This matches ExpandVariablesInStringNew for the tokenized arguments.
+  static const std::string lineVar = "CMAKE_CURRENT_LIST_LINE";
+  value.clear();
+  std::string svalue;
+  for (cmListFileArgumentTokens::Token const& token : tokens.Tokens) {
+    if (!token.Reference) {
+      value += token.Text;
+      continue;
+    }
+    cmProp def = nullptr;
+    switch (token.Domain) {
+      case NORMAL:
+        if (filename && token.Text == lineVar) {
+          value += std::to_string(line + token.LineOffset);
+          continue;
+        }
+        def = this->GetDef(token.Text);
+        break;
+      case ENVIRONMENT:
+        if (cmSystemTools::GetEnv(token.Text, svalue)) {
+          def = &svalue;
+        }
+        break;
+      case CACHE:
+        def = this->GetState()->GetCacheEntryValue(token.Text);
+        break;
+    }
+    if (def) {
+      value += *def;
+    } else if (!this->SuppressSideEffects) {
+      this->MaybeWarnUninitialized(token.Text, filename);
+    }
+  }
+}
+
 void cmMakefile::AddFunctionBlocker(std::unique_ptr<cmFunctionBlocker> fb)
 {
   if (!this->ExecutionStatusStack.empty()) {
@@ -3663,6 +3989,39 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                            std::string& output)
 {
   this->IsSourceFileTryCompile = fast;
+  int ret = this->GenerateTryCompileProject(srcdir, bindir, cmakeArgs);
+  if (ret == 0) {
+    // finally call the generator to actually build the resulting project
+    ret = this->GetGlobalGenerator()->TryCompile(
+      jobs, srcdir, bindir, projectName, targetName, fast, output, this);
+  }
+
+  this->IsSourceFileTryCompile = false;
+  return ret;
+}
+
+std::vector<int> cmMakefile::TryCompileTargets(
+  const std::string& srcdir, const std::string& bindir,
+  const std::string& projectName, std::vector<std::string> const& targetNames,
+  int jobs, std::vector<std::string>& outputs)
+{
+  std::vector<int> results(targetNames.size(), 1);
+  outputs.assign(targetNames.size(), std::string());
+
+  this->IsSourceFileTryCompile = true;
+  if (this->GenerateTryCompileProject(srcdir, bindir, nullptr) == 0) {
+    results = this->GetGlobalGenerator()->TryCompileTargets(
+      jobs, bindir, projectName, targetNames, outputs, this);
+  }
+
+  this->IsSourceFileTryCompile = false;
+  return results;
+}
+
+int cmMakefile::GenerateTryCompileProject(
+  const std::string& srcdir, const std::string& bindir,
+  const std::vector<std::string>* cmakeArgs)
+{
   // does the binary directory exist ? If not create it...
   if (!cmSystemTools::FileIsDirectory(bindir)) {
     cmSystemTools::MakeDirectory(bindir);
@@ -3676,7 +4035,6 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                        "Failed to set working directory to " + bindir + " : " +
                          std::strerror(workdir.GetLastResult()));
     cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
@@ -3692,7 +4050,6 @@ int cmMakefile::TryCompile(const std::string& srcdir,
                          this->GetGlobalGenerator()->GetName() +
                          "' could not be created.");
     cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
   gg->RecursionDepth = this->RecursionDepth;
@@ -3764,7 +4121,6 @@ int cmMakefile::TryCompile(const std::string& srcdir,
     this->IssueMessage(MessageType::FATAL_ERROR,
                        "Failed to configure test project build system.");
     cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
@@ -3772,16 +4128,10 @@ int cmMakefile::TryCompile(const std::string& srcdir,
     this->IssueMessage(MessageType::FATAL_ERROR,
                        "Failed to generate test project build system.");
     cmSystemTools::SetFatalErrorOccured();
-    this->IsSourceFileTryCompile = false;
     return 1;
   }
 
-  // finally call the generator to actually build the resulting project
-  int ret = this->GetGlobalGenerator()->TryCompile(
-    jobs, srcdir, bindir, projectName, targetName, fast, output, this);
-
-  this->IsSourceFileTryCompile = false;
-  return ret;
+  return 0;
 }
 
 bool cmMakefile::GetIsSourceFileTryCompile() const
@@ -3789,6 +4139,21 @@ bool cmMakefile::GetIsSourceFileTryCompile() const
   return this->IsSourceFileTryCompile;
 }
 
+cmTryCompileBatch* cmMakefile::GetTryCompileBatch() const
+{
+  return this->TryCompileBatch.get();
+}
+
+void cmMakefile::SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch)
+{
+  this->TryCompileBatch = std::move(batch);
+}
+
+std::unique_ptr<cmTryCompileBatch> cmMakefile::ReleaseTryCompileBatch()
+{
+  return std::move(this->TryCompileBatch);
+}
+
 cmake* cmMakefile::GetCMakeInstance() const
 {
   return this->GlobalGenerator->GetCMakeInstance();
@@ -4488,10 +4853,15 @@ void cmMakefile::ClearMatches()
 }
 
 void cmMakefile::StoreMatches(cmsys::RegularExpression& re)
+{
+  this->StoreMatches(re.regMatch());
+}
+
+void cmMakefile::StoreMatches(cmsys::RegularExpressionMatch const& match)
 {
   char highest = 0;
   for (int i = 0; i < 10; i++) {
-    std::string const& m = re.match(i);
+    std::string const& m = match.match(i);
     if (!m.empty()) {
       std::string const& var = matchVariables[i];
       this->AddDefinition(var, m);
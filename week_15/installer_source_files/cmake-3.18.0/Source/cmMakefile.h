@@ -56,6 +56,7 @@ class cmSourceFile;
 class cmState;
 class cmTest;
 class cmTestGenerator;
+struct cmTryCompileBatch;
 class cmVariableWatch;
 class cmake;
 
@@ -150,6 +151,26 @@ public:
 
   bool GetIsSourceFileTryCompile() const;
 
+  /**
+   * Like TryCompile, but build several targets of the same project.
+   * The project is configured once and each target is then built on
+   * its own, concurrently where the generator supports it, to collect
+   * the result and output of each.
+   */
+  std::vector<int> TryCompileTargets(
+    const std::string& srcdir, const std::string& bindir,
+    const std::string& projectName,
+    std::vector<std::string> const& targetNames, int jobs,
+    std::vector<std::string>& outputs);
+
+  /**
+   * The try_compile checks queued in this directory since
+   * try_compile_batch(BEGIN), or null if no batch is open.
+   */
+  cmTryCompileBatch* GetTryCompileBatch() const;
+  void SetTryCompileBatch(std::unique_ptr<cmTryCompileBatch> batch);
+  std::unique_ptr<cmTryCompileBatch> ReleaseTryCompileBatch();
+
   /**
    * Help enforce global target name uniqueness.
    */
@@ -515,6 +536,20 @@ public:
   bool IsDefinitionSet(const std::string&) const;
   bool GetDefExpandList(const std::string& name, std::vector<std::string>& out,
                         bool emptyArgs = false) const;
+
+  /**
+   * Access a variable as a list of elements without splitting or joining
+   * its string value.  These return nullptr or false when the variable
+   * is not a normal variable whose elements join back into its value,
+   * or when it is watched, and callers must then fall back to the
+   * string value.
+   */
+  const std::vector<std::string>* GetListDefinition(
+    const std::string& name) const;
+  bool AppendListDefinition(const std::string& name,
+                            std::vector<std::string>::const_iterator first,
+                            std::vector<std::string>::const_iterator last);
+  bool PopBackListDefinition(const std::string& name, std::size_t count);
   /**
    * Get the list of all variables in the current space. If argument
    * cacheonly is specified and is greater than 0, then only cache
@@ -946,6 +981,7 @@ public:
 
   void ClearMatches();
   void StoreMatches(cmsys::RegularExpression& re);
+  void StoreMatches(cmsys::RegularExpressionMatch const& match);
 
   cmStateSnapshot GetStateSnapshot() const;
 
@@ -1050,6 +1086,8 @@ private:
   void ReadListFile(cmListFile const& listFile,
                     const std::string& filenametoread);
 
+  bool ParseListFile(cmListFile& listFile, const std::string& filenametoread);
+
   bool ParseDefineFlag(std::string const& definition, bool remove);
 
   bool EnforceUniqueDir(const std::string& srcPath,
@@ -1116,8 +1154,21 @@ private:
                                          bool atOnly, const char* filename,
                                          long line, bool replaceAt) const;
 
+  // Expand one non-bracket argument, using its tokens if allowed.
+  bool CanExpandArgumentTokens() const;
+  void ExpandArgument(cmListFileArgument const& arg, const char* filename,
+                      bool useTokens, std::string& value) const;
+  void ExpandArgumentTokens(cmListFileArgumentTokens const& tokens,
+                            const char* filename, long line,
+                            std::string& value) const;
+
   bool ValidateCustomCommand(const cmCustomCommandLines& commandLines) const;
 
+  // Configure and generate a try_compile project.  Returns 0 on success.
+  int GenerateTryCompileProject(const std::string& srcdir,
+                                const std::string& bindir,
+                                const std::vector<std::string>* cmakeArgs);
+
   void CreateGeneratedOutputs(const std::vector<std::string>& outputs);
   void CreateGeneratedByproducts(const std::vector<std::string>& byproducts);
 
@@ -1204,6 +1255,7 @@ private:
   bool CheckCMP0000;
   std::set<std::string> WarnedCMP0074;
   bool IsSourceFileTryCompile;
+  std::unique_ptr<cmTryCompileBatch> TryCompileBatch;
   mutable bool SuppressSideEffects;
 };
 
@@ -2,8 +2,10 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #include "cmMakefileProfilingData.h"
 
+#include <algorithm>
 #include <chrono>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <cm3p/json/value.h>
@@ -15,9 +17,19 @@
 #include "cmListFileCache.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
+
+namespace {
+Json::Value::UInt64 ToMicroseconds(std::chrono::steady_clock::duration d)
+{
+  return static_cast<Json::Value::UInt64>(
+    std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+}
 
 cmMakefileProfilingData::cmMakefileProfilingData(
-  const std::string& profileStream)
+  const std::string& profileStream, Format format)
+  : OutputFormat(format)
 {
   std::ios::openmode omode = std::ios::out | std::ios::trunc;
   this->ProfileStream.open(profileStream.c_str(), omode);
@@ -28,14 +40,32 @@ cmMakefileProfilingData::cmMakefileProfilingData(
     throw std::runtime_error(std::string("Unable to open: ") + profileStream);
   }
 
-  this->ProfileStream << "[";
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->ProfileStream << "[";
+  }
 };
 
 cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 {
   if (this->ProfileStream.good()) {
     try {
-      this->ProfileStream << "]";
+      switch (this->OutputFormat) {
+        case Format::GoogleTrace:
+          this->ProfileStream << "]";
+          break;
+        case Format::Aggregate:
+        case Format::Folded:
+          // Close entries left open by a fatal error.
+          while (!this->Stack.empty()) {
+            this->StopEntry();
+          }
+          if (this->OutputFormat == Format::Aggregate) {
+            this->WriteAggregate();
+          } else {
+            this->WriteFolded();
+          }
+          break;
+      }
       this->ProfileStream.close();
     } catch (...) {
       cmSystemTools::Error("Error writing profiling output!");
@@ -44,7 +74,179 @@ cmMakefileProfilingData::~cmMakefileProfilingData() noexcept
 }
 
 void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
-                                         cmListFileContext const& lfc)
+                                         cmListFileContext const& lfc,
+                                         bool scripted)
+{
+  if (this->OutputFormat == Format::GoogleTrace) {
+    Json::Value argsValue;
+    if (!lff.Arguments.empty()) {
+      std::string args;
+      for (const auto& a : lff.Arguments) {
+        args += (args.empty() ? "" : " ") + a.Value;
+      }
+      argsValue["functionArgs"] = args;
+    }
+    argsValue["location"] =
+      lfc.FilePath.str() + ":" + std::to_string(lfc.Line);
+    this->StartTraceEntry("cmake", lff.Name.Lower, &argsValue);
+    return;
+  }
+
+  Frame frame;
+  frame.Command = lff.Name.Lower;
+  frame.File = lfc.FilePath;
+  frame.Scripted = scripted;
+  std::string label;
+  if (this->OutputFormat == Format::Folded) {
+    label = cmStrCat(frame.Command, " (", lfc.FilePath.str(), ':', lfc.Line,
+                     ')');
+  }
+
+  StartStats(this->CommandStats[frame.Command]);
+  StartStats(this->FileStats[frame.File]);
+  if (frame.Scripted) {
+    StartStats(this->FunctionStats[frame.Command]);
+  }
+  this->StartFrame(std::move(frame), std::move(label));
+}
+
+void cmMakefileProfilingData::StartEntry(const std::string& category,
+                                         const std::string& name)
+{
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->StartTraceEntry(category, name, nullptr);
+    return;
+  }
+
+  Frame frame;
+  frame.Command = name;
+  frame.Category = category;
+  std::string label;
+  if (this->OutputFormat == Format::Folded) {
+    label = cmStrCat(category, ": ", name);
+  }
+
+  StartStats(this->CategoryStats[category][name]);
+  this->StartFrame(std::move(frame), std::move(label));
+}
+
+void cmMakefileProfilingData::StartFrame(Frame frame, std::string label)
+{
+  if (this->OutputFormat == Format::Folded) {
+    // Frames are separated by ';' in the folded format.
+    std::replace(label.begin(), label.end(), ';', ',');
+    frame.Stack = this->Stack.empty()
+      ? std::move(label)
+      : cmStrCat(this->Stack.back().Stack, ';', label);
+  }
+  frame.Start = Clock::now();
+  this->Stack.push_back(std::move(frame));
+}
+
+void cmMakefileProfilingData::StopEntry()
+{
+  if (this->OutputFormat == Format::GoogleTrace) {
+    this->StopTraceEntry();
+    return;
+  }
+  if (this->Stack.empty()) {
+    return;
+  }
+
+  Clock::duration const total = Clock::now() - this->Stack.back().Start;
+  Frame frame = std::move(this->Stack.back());
+  this->Stack.pop_back();
+  Clock::duration const self = total - frame.ChildTime;
+
+  if (!frame.Category.empty()) {
+    StopStats(this->CategoryStats[frame.Category][frame.Command], self,
+              total);
+  } else {
+    StopStats(this->CommandStats[frame.Command], self, total);
+    StopStats(this->FileStats[frame.File], self, total);
+  }
+  if (frame.Scripted) {
+    StopStats(this->FunctionStats[frame.Command],
+              total - frame.ScriptedChildTime, total);
+  }
+  if (this->OutputFormat == Format::Folded) {
+    this->FoldedStacks[frame.Stack] += self;
+  }
+
+  // Time in a function or macro belongs to the innermost one.  Other
+  // commands pass the time spent in nested functions up to their caller.
+  if (!this->Stack.empty()) {
+    Frame& parent = this->Stack.back();
+    parent.ChildTime += total;
+    parent.ScriptedChildTime +=
+      frame.Scripted ? total : frame.ScriptedChildTime;
+  }
+}
+
+void cmMakefileProfilingData::StartStats(Stats& stats)
+{
+  ++stats.Calls;
+  ++stats.Active;
+}
+
+void cmMakefileProfilingData::StopStats(Stats& stats, Clock::duration self,
+                                        Clock::duration total)
+{
+  stats.SelfTime += self;
+  if (--stats.Active == 0) {
+    stats.TotalTime += total;
+  }
+}
+
+void cmMakefileProfilingData::WriteAggregate()
+{
+  auto writeStats = [](StatsMap const& statsMap, const char* key) {
+    // Report the most expensive entries first.
+    std::vector<StatsMap::const_iterator> entries;
+    entries.reserve(statsMap.size());
+    for (auto it = statsMap.begin(); it != statsMap.end(); ++it) {
+      entries.push_back(it);
+    }
+    std::stable_sort(
+      entries.begin(), entries.end(),
+      [](StatsMap::const_iterator l, StatsMap::const_iterator r) {
+        return l->second.SelfTime > r->second.SelfTime;
+      });
+
+    Json::Value list = Json::arrayValue;
+    for (StatsMap::const_iterator const& entry : entries) {
+      Json::Value v = Json::objectValue;
+      v[key] = entry->first;
+      v["calls"] = Json::Value::UInt64(entry->second.Calls);
+      v["selfTime"] = ToMicroseconds(entry->second.SelfTime);
+      v["totalTime"] = ToMicroseconds(entry->second.TotalTime);
+      list.append(std::move(v));
+    }
+    return list;
+  };
+
+  Json::Value root = Json::objectValue;
+  root["commands"] = writeStats(this->CommandStats, "name");
+  root["functions"] = writeStats(this->FunctionStats, "name");
+  root["files"] = writeStats(this->FileStats, "file");
+  for (auto const& category : this->CategoryStats) {
+    root[category.first] = writeStats(category.second, "name");
+  }
+  this->JsonWriter->write(root, &this->ProfileStream);
+  this->ProfileStream << "\n";
+}
+
+void cmMakefileProfilingData::WriteFolded()
+{
+  for (auto const& folded : this->FoldedStacks) {
+    this->ProfileStream << folded.first << ' '
+                        << ToMicroseconds(folded.second) << '\n';
+  }
+}
+
+void cmMakefileProfilingData::StartTraceEntry(const std::string& category,
+                                              const std::string& name,
+                                              Json::Value const* args)
 {
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
@@ -58,24 +260,17 @@ void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
     cmsys::SystemInformation info;
     Json::Value v;
     v["ph"] = "B";
-    v["name"] = lff.Name.Lower;
-    v["cat"] = "cmake";
+    v["name"] = name;
+    v["cat"] = category;
     v["ts"] = Json::Value::UInt64(
       std::chrono::duration_cast<std::chrono::microseconds>(
         std::chrono::steady_clock::now().time_since_epoch())
         .count());
     v["pid"] = static_cast<int>(info.GetProcessId());
     v["tid"] = 0;
-    Json::Value argsValue;
-    if (!lff.Arguments.empty()) {
-      std::string args;
-      for (const auto& a : lff.Arguments) {
-        args += (args.empty() ? "" : " ") + a.Value;
-      }
-      argsValue["functionArgs"] = args;
+    if (args) {
+      v["args"] = *args;
     }
-    argsValue["location"] = lfc.FilePath + ":" + std::to_string(lfc.Line);
-    v["args"] = argsValue;
 
     this->JsonWriter->write(v, &this->ProfileStream);
   } catch (std::ios_base::failure& fail) {
@@ -86,7 +281,7 @@ void cmMakefileProfilingData::StartEntry(const cmListFileFunction& lff,
   }
 }
 
-void cmMakefileProfilingData::StopEntry()
+void cmMakefileProfilingData::StopTraceEntry()
 {
   /* Do not try again if we previously failed to write to output. */
   if (!this->ProfileStream.good()) {
@@ -112,3 +307,19 @@ void cmMakefileProfilingData::StopEntry()
     cmSystemTools::Error("Error writing profiling output!");
   }
 }
+
+cmMakefileProfilingData::Scope::Scope(cmake* cm, const std::string& category,
+                                      const std::string& name)
+{
+  if (cm && cm->IsProfilingEnabled()) {
+    this->Data = &cm->GetProfilingOutput();
+    this->Data->StartEntry(category, name);
+  }
+}
+
+cmMakefileProfilingData::Scope::~Scope()
+{
+  if (this->Data) {
+    this->Data->StopEntry();
+  }
+}
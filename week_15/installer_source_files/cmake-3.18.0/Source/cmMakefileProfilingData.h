@@ -2,28 +2,109 @@
    file Copyright.txt or https://cmake.org/licensing for details.  */
 #ifndef cmMakefileProfilingData_h
 #define cmMakefileProfilingData_h
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "cmsys/FStream.hxx"
 
 namespace Json {
 class StreamWriter;
+class Value;
 }
 
 class cmListFileContext;
+class cmake;
 struct cmListFileFunction;
 
 class cmMakefileProfilingData
 {
 public:
-  cmMakefileProfilingData(const std::string&);
+  enum class Format
+  {
+    // One trace event per command, streamed as the commands run.
+    GoogleTrace,
+    // Per-command, per-function and per-file times, written at exit.
+    Aggregate,
+    // Self time per call stack for flame graph tools, written at exit.
+    Folded
+  };
+
+  cmMakefileProfilingData(const std::string&,
+                          Format format = Format::GoogleTrace);
   ~cmMakefileProfilingData() noexcept;
-  void StartEntry(const cmListFileFunction& lff, cmListFileContext const& lfc);
+  void StartEntry(const cmListFileFunction& lff, cmListFileContext const& lfc,
+                  bool scripted = false);
+  // Start an entry for work done outside of a CMake command, such as a
+  // generate step.  The category groups entries of the same kind.
+  void StartEntry(const std::string& category, const std::string& name);
   void StopEntry();
 
+  // Profile the lifetime of this object as an entry when profiling is
+  // enabled on the given cmake instance.
+  class Scope
+  {
+  public:
+    Scope(cmake* cm, const std::string& category, const std::string& name);
+    ~Scope();
+
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+
+  private:
+    cmMakefileProfilingData* Data = nullptr;
+  };
+
 private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Frame
+  {
+    std::string Command;
+    std::string File;
+    // Empty for CMake commands.
+    std::string Category;
+    std::string Stack;
+    bool Scripted = false;
+    Clock::time_point Start;
+    Clock::duration ChildTime = Clock::duration::zero();
+    Clock::duration ScriptedChildTime = Clock::duration::zero();
+  };
+
+  struct Stats
+  {
+    unsigned long long Calls = 0;
+    Clock::duration SelfTime = Clock::duration::zero();
+    Clock::duration TotalTime = Clock::duration::zero();
+    // Number of entries for the same key on the stack.  Only the
+    // outermost one adds to the total time so recursion is not counted
+    // twice.
+    unsigned int Active = 0;
+  };
+  using StatsMap = std::map<std::string, Stats>;
+
+  void StartTraceEntry(const std::string& category, const std::string& name,
+                       Json::Value const* args);
+  void StartFrame(Frame frame, std::string label);
+  void StopTraceEntry();
+  void WriteAggregate();
+  void WriteFolded();
+
+  static void StartStats(Stats& stats);
+  static void StopStats(Stats& stats, Clock::duration self,
+                        Clock::duration total);
+
+  Format OutputFormat;
   cmsys::ofstream ProfileStream;
   std::unique_ptr<Json::StreamWriter> JsonWriter;
+
+  std::vector<Frame> Stack;
+  StatsMap CommandStats;
+  StatsMap FunctionStats;
+  StatsMap FileStats;
+  std::map<std::string, StatsMap> CategoryStats;
+  std::map<std::string, Clock::duration> FoldedStacks;
 };
 #endif
@@ -0,0 +1,92 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmMakefileProfilingSampler.h"
+
+#include <cctype>
+#include <stdexcept>
+
+#include "cmListFileCache.h"
+#include "cmSystemTools.h"
+
+cmMakefileProfilingSampler::cmMakefileProfilingSampler(
+  const std::string& path, std::chrono::microseconds interval)
+  : Interval(interval)
+  , PendingTicks(0)
+  , Stop(false)
+{
+  this->ProfileStream.open(path.c_str(), std::ios::out | std::ios::trunc);
+  if (!this->ProfileStream.good()) {
+    throw std::runtime_error(std::string("Unable to open: ") + path);
+  }
+  this->Timer = std::thread(&cmMakefileProfilingSampler::TimerLoop, this);
+}
+
+cmMakefileProfilingSampler::~cmMakefileProfilingSampler() noexcept
+{
+  this->Stop.store(true, std::memory_order_relaxed);
+  this->Timer.join();
+
+  if (this->ProfileStream.good()) {
+    try {
+      for (auto const& sample : this->Samples) {
+        this->ProfileStream << sample.first << ' ' << sample.second << '\n';
+      }
+      this->ProfileStream.close();
+    } catch (...) {
+      cmSystemTools::Error("Error writing profiling output!");
+    }
+  }
+}
+
+void cmMakefileProfilingSampler::TimerLoop()
+{
+  while (!this->Stop.load(std::memory_order_relaxed)) {
+    std::this_thread::sleep_for(this->Interval);
+    this->PendingTicks.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void cmMakefileProfilingSampler::Record(cmListFileBacktrace const& backtrace)
+{
+  unsigned int const ticks =
+    this->PendingTicks.exchange(0, std::memory_order_relaxed);
+
+  // The backtrace lists the innermost call first.  File scopes have no
+  // command name and are left out like they are in error messages.
+  this->Frames.clear();
+  for (cmListFileBacktrace bt = backtrace; !bt.Empty(); bt = bt.Pop()) {
+    cmListFileContext const& lfc = bt.Top();
+    if (!lfc.Name.empty()) {
+      this->Frames.push_back(&lfc);
+    }
+  }
+  if (this->Frames.empty()) {
+    return;
+  }
+
+  // Use the frame labels of the folded profiling format.
+  this->Stack.clear();
+  for (auto it = this->Frames.rbegin(); it != this->Frames.rend(); ++it) {
+    cmListFileContext const& lfc = **it;
+    if (!this->Stack.empty()) {
+      this->Stack += ';';
+    }
+    std::string::size_type const start = this->Stack.size();
+    for (char c : lfc.Name.str()) {
+      this->Stack +=
+        static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    this->Stack += " (";
+    this->Stack += lfc.FilePath;
+    this->Stack += ':';
+    this->Stack += std::to_string(lfc.Line);
+    this->Stack += ')';
+    // Frames are separated by ';' in the folded format.
+    for (std::string::size_type i = start; i < this->Stack.size(); ++i) {
+      if (this->Stack[i] == ';') {
+        this->Stack[i] = ',';
+      }
+    }
+  }
+  this->Samples[this->Stack] += ticks;
+}
@@ -0,0 +1,66 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmMakefileProfilingSampler_h
+#define cmMakefileProfilingSampler_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cmsys/FStream.hxx"
+
+class cmListFileBacktrace;
+class cmListFileContext;
+
+/** \class cmMakefileProfilingSampler
+ * \brief Statistical profiler for the CMake language interpreter.
+ *
+ * A timer thread counts sampling ticks.  The interpreter polls the count
+ * at each command boundary and charges the pending ticks to its current
+ * call stack, so the stack is only ever read by the thread that owns it.
+ * A command that runs for several ticks is charged all of them when it
+ * finishes.  The histogram is written in the folded format read by flame
+ * graph tools when the sampler is destroyed.
+ */
+class cmMakefileProfilingSampler
+{
+public:
+  cmMakefileProfilingSampler(const std::string& path,
+                             std::chrono::microseconds interval);
+  ~cmMakefileProfilingSampler() noexcept;
+
+  cmMakefileProfilingSampler(cmMakefileProfilingSampler const&) = delete;
+  cmMakefileProfilingSampler& operator=(cmMakefileProfilingSampler const&) =
+    delete;
+
+  /** Record pending samples against the given call stack.  Cheap when no
+      tick has elapsed since the last call.  */
+  void Poll(cmListFileBacktrace const& backtrace)
+  {
+    if (this->PendingTicks.load(std::memory_order_relaxed) != 0) {
+      this->Record(backtrace);
+    }
+  }
+
+private:
+  void Record(cmListFileBacktrace const& backtrace);
+  void TimerLoop();
+
+  std::chrono::microseconds Interval;
+  std::atomic<unsigned int> PendingTicks;
+  std::atomic<bool> Stop;
+  std::thread Timer;
+
+  cmsys::ofstream ProfileStream;
+  // Scratch space reused by every sample.
+  std::vector<cmListFileContext const*> Frames;
+  std::string Stack;
+  std::map<std::string, unsigned long long> Samples;
+};
+
+#endif
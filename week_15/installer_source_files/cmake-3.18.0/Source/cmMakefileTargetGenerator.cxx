@@ -316,6 +316,30 @@ void cmMakefileTargetGenerator::WriteCommonCodeRules()
                   << "# This may be replaced when dependencies are built.\n";
   }
 
+  if (this->Makefile->IsOn("CMAKE_DEPENDS_USE_COMPILER")) {
+    // Include the dependencies collected from the compiler.
+    std::string compilerDependFileNameFull =
+      cmStrCat(this->TargetBuildDirectoryFull, "/compiler_depend.make");
+    *this->BuildFileStream
+      << "# Include any dependencies generated by the compiler for this "
+         "target.\n"
+      << this->GlobalGenerator->IncludeDirective << " " << root
+      << cmSystemTools::ConvertToOutputPath(
+           this->LocalGenerator->MaybeConvertToRelativePath(
+             this->LocalGenerator->GetBinaryDirectory(),
+             compilerDependFileNameFull))
+      << "\n\n";
+
+    if (!cmSystemTools::FileExists(compilerDependFileNameFull)) {
+      cmGeneratedFileStream depFileStream(
+        compilerDependFileNameFull, false,
+        this->GlobalGenerator->GetMakefileEncoding());
+      depFileStream << "# Empty compiler generated dependencies file for "
+                    << this->GeneratorTarget->GetName() << ".\n"
+                    << "# This may be replaced when dependencies are built.\n";
+    }
+  }
+
   // Open the flags file.  This should be copy-if-different because the
   // rules may depend on this file itself.
   this->FlagFileNameFull =
@@ -477,8 +501,11 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
   objFullPath = cmSystemTools::CollapseFullPath(objFullPath);
   std::string srcFullPath =
     cmSystemTools::CollapseFullPath(source.GetFullPath());
-  this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
-                                           objFullPath, srcFullPath);
+  bool const compilerGenerateDeps = this->UseCompilerDependencies(lang);
+  if (!compilerGenerateDeps) {
+    this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
+                                             objFullPath, srcFullPath);
+  }
 
   this->LocalGenerator->AppendRuleDepend(depends,
                                          this->FlagFileNameFull.c_str());
@@ -520,8 +547,10 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
         depends.push_back(
           this->GeneratorTarget->GetPchFile(config, lang, arch));
       }
-      this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
-                                               objFullPath, pchHeader);
+      if (!compilerGenerateDeps) {
+        this->LocalGenerator->AddImplicitDepends(this->GeneratorTarget, lang,
+                                                 objFullPath, pchHeader);
+      }
     }
   }
 
@@ -709,6 +738,23 @@ void cmMakefileTargetGenerator::WriteObjectRuleFiles(
       this->LocalGenerator->GetCurrentBinaryDirectory(), objectFileDir),
     cmOutputConverter::SHELL);
   vars.ObjectFileDir = objectFileDir.c_str();
+
+  // Have the compiler write the dependencies next to the object file.
+  if (compilerGenerateDeps) {
+    std::string const depFile = cmStrCat(obj, ".d");
+    std::string depFlags = this->Makefile->GetSafeDefinition(
+      cmStrCat("CMAKE_DEPFILE_FLAGS_", lang));
+    cmSystemTools::ReplaceString(
+      depFlags, "<DEPFILE>",
+      this->LocalGenerator->ConvertToOutputFormat(depFile,
+                                                  cmOutputConverter::SHELL));
+    cmSystemTools::ReplaceString(depFlags, "<OBJECT>", shellObj);
+    this->LocalGenerator->AppendFlags(flags, depFlags);
+    this->CompilerDependencyFiles[objFullPath] =
+      this->LocalGenerator->ConvertToFullPath(depFile);
+    this->CleanFiles.insert(depFile);
+  }
+
   vars.Flags = flags.c_str();
 
   std::string definesString = cmStrCat("$(", lang, "_DEFINES)");
@@ -1101,6 +1147,20 @@ bool cmMakefileTargetGenerator::WriteMakeRule(
   return symbolic;
 }
 
+bool cmMakefileTargetGenerator::UseCompilerDependencies(
+  std::string const& lang) const
+{
+  // Fortran still needs the module dependencies found by scanning.
+  if (lang != "C" && lang != "CXX" && lang != "OBJC" && lang != "OBJCXX") {
+    return false;
+  }
+  return this->Makefile->IsOn("CMAKE_DEPENDS_USE_COMPILER") &&
+    this->Makefile->GetSafeDefinition(
+      cmStrCat("CMAKE_", lang, "_DEPFILE_FORMAT")) == "gcc" &&
+    !this->Makefile->GetSafeDefinition(cmStrCat("CMAKE_DEPFILE_FLAGS_", lang))
+       .empty();
+}
+
 void cmMakefileTargetGenerator::WriteTargetDependRules()
 {
   // must write the targets depend info file
@@ -1134,6 +1194,20 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     *this->InfoFileStream << "  )\n\n";
   }
 
+  // Store the dependency files written by the compiler.
+  if (!this->CompilerDependencyFiles.empty()) {
+    *this->InfoFileStream
+      << "\n"
+      << "# Dependency files written by the compiler for each object.\n"
+      << "set(CMAKE_DEPENDS_DEPENDENCY_FILES\n";
+    for (auto const& df : this->CompilerDependencyFiles) {
+      *this->InfoFileStream
+        << "  " << cmOutputConverter::EscapeForCMake(df.first) << " "
+        << cmOutputConverter::EscapeForCMake(df.second) << "\n";
+    }
+    *this->InfoFileStream << "  )\n";
+  }
+
   // Store list of targets linked directly or transitively.
   {
     /* clang-format off */
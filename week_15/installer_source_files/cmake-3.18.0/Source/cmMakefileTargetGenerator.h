@@ -105,6 +105,9 @@ protected:
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
 
+  // whether the compiler writes the dependencies of the language's objects
+  bool UseCompilerDependencies(std::string const& lang) const;
+
   // write the build rule for a custom command
   void GenerateCustomRuleFile(cmCustomCommandGenerator const& ccg);
 
@@ -231,6 +234,9 @@ protected:
 
   using MultipleOutputPairsType = std::map<std::string, std::string>;
   MultipleOutputPairsType MultipleOutputPairs;
+
+  // Dependency files written by the compiler, keyed by object file.
+  std::map<std::string, std::string> CompilerDependencyFiles;
   bool WriteMakeRule(std::ostream& os, const char* comment,
                      const std::vector<std::string>& outputs,
                      const std::vector<std::string>& depends,
@@ -132,6 +132,8 @@ void displayMessage(MessageType t, std::ostringstream& msg)
 void cmMessenger::IssueMessage(MessageType t, const std::string& text,
                                const cmListFileBacktrace& backtrace) const
 {
+  ++this->IssuedMessageCount;
+
   bool force = false;
   if (!force) {
     // override the message type, if needed, for warnings and errors
@@ -48,6 +48,12 @@ public:
     return this->DeprecatedWarningsAsErrors;
   }
 
+  /** Number of messages issued so far, whether displayed or not.  */
+  unsigned int GetIssuedMessageCount() const
+  {
+    return this->IssuedMessageCount;
+  }
+
 private:
   bool IsMessageTypeVisible(MessageType t) const;
   MessageType ConvertMessageType(MessageType t) const;
@@ -56,6 +62,7 @@ private:
   bool SuppressDeprecatedWarnings = false;
   bool DevWarningsAsErrors = false;
   bool DeprecatedWarningsAsErrors = false;
+  mutable unsigned int IssuedMessageCount = 0;
 };
 
 #endif
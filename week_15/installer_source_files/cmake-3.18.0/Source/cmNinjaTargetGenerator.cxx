@@ -12,12 +12,16 @@
 #include <utility>
 
 #include <cm/memory>
+#include <cm/string_view>
 #include <cmext/algorithm>
 
 #include <cm3p/json/value.h>
 #include <cm3p/json/writer.h>
 
+#include "cmsys/FStream.hxx"
+
 #include "cmComputeLinkInformation.h"
+#include "cmCryptoHash.h"
 #include "cmCustomCommandGenerator.h"
 #include "cmGeneratedFileStream.h"
 #include "cmGeneratorExpression.h"
@@ -37,6 +41,7 @@
 #include "cmStateTypes.h"
 #include "cmStringAlgorithms.h"
 #include "cmSystemTools.h"
+#include "cmVersion.h"
 #include "cmake.h"
 
 std::unique_ptr<cmNinjaTargetGenerator> cmNinjaTargetGenerator::New(
@@ -994,8 +999,25 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatements(
   {
     std::vector<cmSourceFile const*> objectSources;
     this->GeneratorTarget->GetObjectSources(objectSources, config);
-    for (cmSourceFile const* sf : objectSources) {
-      this->WriteObjectBuildStatement(sf, config, fileConfig, firstForConfig);
+    if (firstForConfig) {
+      this->Configs[config].ObjectShardFingerprint =
+        this->ComputeObjectShardFingerprint(objectSources, config);
+      if (!this->Configs[config].ObjectShardFingerprint.empty()) {
+        this->WriteObjectShard(objectSources, config,
+                               this->Configs[config].ObjectShardFingerprint);
+      }
+    }
+    if (!this->Configs[config].ObjectShardFingerprint.empty()) {
+      // The shard does not depend on the file it is included from.
+      cmGlobalNinjaGenerator::WriteInclude(
+        this->GetImplFileStream(fileConfig),
+        this->GetGlobalGenerator()->EncodePath(
+          this->ConvertToNinjaPath(this->GetObjectShardPath(config))));
+    } else {
+      for (cmSourceFile const* sf : objectSources) {
+        this->WriteObjectBuildStatement(this->GetImplFileStream(fileConfig),
+                                        sf, config, firstForConfig);
+      }
     }
   }
 
@@ -1129,8 +1151,8 @@ cmNinjaBuild GetPreprocessOrScanBuild(
 }
 
 void cmNinjaTargetGenerator::WriteObjectBuildStatement(
-  cmSourceFile const* source, const std::string& config,
-  const std::string& fileConfig, bool firstForConfig)
+  std::ostream& os, cmSourceFile const* source, const std::string& config,
+  bool firstForConfig)
 {
   std::string const language = source->GetLanguage();
   std::string const sourceFileName =
@@ -1328,8 +1350,8 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
     this->addPoolNinjaVariable("JOB_POOL_COMPILE", this->GetGeneratorTarget(),
                                ppBuild.Variables);
 
-    this->GetGlobalGenerator()->WriteBuild(this->GetImplFileStream(fileConfig),
-                                           ppBuild, commandLineLengthLimit);
+    this->GetGlobalGenerator()->WriteBuild(os, ppBuild,
+                                           commandLineLengthLimit);
   }
   if (needDyndep) {
     std::string const dyndep = this->GetDyndepFilePath(language, config);
@@ -1362,8 +1384,8 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
   if (language == "Swift") {
     this->EmitSwiftDependencyInfo(source, config);
   } else {
-    this->GetGlobalGenerator()->WriteBuild(this->GetImplFileStream(fileConfig),
-                                           objBuild, commandLineLengthLimit);
+    this->GetGlobalGenerator()->WriteBuild(os, objBuild,
+                                           commandLineLengthLimit);
   }
 
   if (cmProp objectOutputs = source->GetProperty("OBJECT_OUTPUTS")) {
@@ -1377,8 +1399,178 @@ void cmNinjaTargetGenerator::WriteObjectBuildStatement(
       std::transform(build.Outputs.begin(), build.Outputs.end(),
                      build.Outputs.begin(), MapToNinjaPath());
       build.ExplicitDeps = objBuild.Outputs;
-      this->GetGlobalGenerator()->WriteBuild(
-        this->GetImplFileStream(fileConfig), build);
+      this->GetGlobalGenerator()->WriteBuild(os, build);
+    }
+  }
+}
+
+std::string cmNinjaTargetGenerator::GetObjectShardPath(
+  const std::string& config) const
+{
+  return cmStrCat(this->GeneratorTarget->GetSupportDirectory(),
+                  this->GetGlobalGenerator()->ConfigDirectory(config),
+                  "/objects.ninja");
+}
+
+std::string cmNinjaTargetGenerator::ComputeObjectShardFingerprint(
+  std::vector<cmSourceFile const*> const& objectSources,
+  const std::string& config)
+{
+  if (objectSources.empty() ||
+      this->Makefile->IsOn("CMAKE_EXPORT_COMPILE_COMMANDS")) {
+    return std::string();
+  }
+
+  cmCryptoHash hash(cmCryptoHash::AlgoSHA256);
+  hash.Initialize();
+  auto append = [&hash](cm::string_view value) {
+    hash.Append(value);
+    hash.Append("\0", 1);
+  };
+
+  append(cmVersion::GetCMakeVersion());
+  append(this->GetGlobalGenerator()->GetName());
+  append(config);
+  append(this->ConvertToNinjaPath(
+    cmStrCat(this->GeneratorTarget->GetSupportDirectory(),
+             this->GetGlobalGenerator()->ConfigDirectory(config))));
+  append(this->OrderDependsTargetForTarget(config));
+  append(this->ForceResponseFile() ? "1" : "0");
+  append(this->Makefile->GetSafeDefinition("CMAKE_PCH_EXTENSION"));
+  for (const char* pool :
+       { "JOB_POOL_COMPILE", "JOB_POOL_PRECOMPILE_HEADER" }) {
+    cmProp value = this->GeneratorTarget->GetProperty(pool);
+    append(value ? *value : std::string());
+  }
+  {
+    cmNinjaVars pdbVars;
+    this->SetMsvcTargetPdbVariable(pdbVars, config);
+    for (auto const& var : pdbVars) {
+      append(var.first);
+      append(var.second);
+    }
+  }
+
+  std::vector<std::string> architectures;
+  this->GeneratorTarget->GetAppleArchs(config, architectures);
+  if (architectures.empty()) {
+    architectures.emplace_back();
+  }
+
+  // Everything computed once per language, most of which is cached anyway.
+  std::set<std::string> languages;
+  for (cmSourceFile const* source : objectSources) {
+    std::string const& language = source->GetLanguage();
+    if (!languages.insert(language).second) {
+      continue;
+    }
+    // Fortran and Swift sources leave information behind that later
+    // statements of the target depend on.
+    if (language.empty() || language == "Fortran" || language == "Swift" ||
+        this->NeedExplicitPreprocessing(language) ||
+        this->NeedDyndep(language)) {
+      return std::string();
+    }
+    for (std::string const& arch : architectures) {
+      if (!this->GeneratorTarget->GetPchSource(config, language, arch)
+             .empty()) {
+        return std::string();
+      }
+    }
+    append(language);
+    append(this->GetLocalGenerator()->GetToolchainFingerprint(language));
+    append(this->LanguageCompilerRule(language, config));
+    append(this->NeedDepTypeMSVC(language) ? "1" : "0");
+    append(this->GetFlags(language, config));
+    append(this->GetDefines(language, config));
+    append(this->GetIncludes(language, config));
+  }
+
+  for (cmSourceFile const* source : objectSources) {
+    // Generated sources may be given assumed dependencies, which depend on
+    // the custom commands seen so far.
+    if (source->GetIsGenerated()) {
+      return std::string();
+    }
+    append(source->GetFullPath());
+    append(source->GetLanguage());
+    append(this->GetSourceFilePath(source));
+    append(this->GetObjectFilePath(source, config));
+    // cmSourceFile keeps these three out of its property map.
+    if (!source->GetIncludeDirectories().empty()) {
+      return std::string();
+    }
+    for (auto const& entries :
+         { std::make_pair("COMPILE_OPTIONS", &source->GetCompileOptions()),
+           std::make_pair("COMPILE_DEFINITIONS",
+                          &source->GetCompileDefinitions()) }) {
+      append(entries.first);
+      for (BT<std::string> const& entry : *entries.second) {
+        // Generator expressions may refer to anything.
+        if (cmGeneratorExpression::Find(entry.Value) != std::string::npos) {
+          return std::string();
+        }
+        append(entry.Value);
+      }
+    }
+    for (auto const& prop : source->GetProperties().GetList()) {
+      if (cmGeneratorExpression::Find(prop.second) != std::string::npos) {
+        return std::string();
+      }
+      append(prop.first);
+      append(prop.second);
+    }
+  }
+
+  return hash.FinalizeHex();
+}
+
+void cmNinjaTargetGenerator::WriteObjectShard(
+  std::vector<cmSourceFile const*> const& objectSources,
+  const std::string& config, std::string const& fingerprint)
+{
+  std::string const shardPath = this->GetObjectShardPath(config);
+  std::string const header = cmStrCat("# Fingerprint: ", fingerprint);
+
+  std::string firstLine;
+  {
+    cmsys::ifstream fin(shardPath.c_str());
+    if (fin) {
+      cmSystemTools::GetLineFromStream(fin, firstLine);
+    }
+  }
+
+  if (firstLine != header) {
+    cmGeneratedFileStream shard(shardPath);
+    shard.SetCopyIfDifferent(true);
+    shard << header << "\n"
+          << "# Object build statements for "
+          << cmState::GetTargetTypeName(this->GeneratorTarget->GetType())
+          << " target " << this->GetTargetName() << "\n\n";
+    for (cmSourceFile const* sf : objectSources) {
+      this->WriteObjectBuildStatement(shard, sf, config, true);
+    }
+    return;
+  }
+
+  // The shard on disk is up to date.  Only record what writing its build
+  // statements would have recorded.
+  const char* pchExtension =
+    this->GetMakefile()->GetDefinition("CMAKE_PCH_EXTENSION");
+  for (cmSourceFile const* sf : objectSources) {
+    std::string const objectFileName =
+      this->ConvertToNinjaPath(this->GetObjectFilePath(sf, config));
+    if (!cmSystemTools::StringEndsWith(objectFileName, pchExtension)) {
+      this->Configs[config].Objects.push_back(objectFileName);
+    }
+    this->GetGlobalGenerator()->SeenBuildOutput(objectFileName);
+    this->EnsureParentDirectoryExists(objectFileName);
+
+    if (cmProp objectOutputs = sf->GetProperty("OBJECT_OUTPUTS")) {
+      for (std::string const& output : cmExpandedList(*objectOutputs)) {
+        this->GetGlobalGenerator()->SeenBuildOutput(
+          this->ConvertToNinjaPath(output));
+      }
     }
   }
 }
@@ -5,6 +5,7 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <set>
@@ -149,10 +150,31 @@ protected:
   void WriteObjectBuildStatements(const std::string& config,
                                   const std::string& fileConfig,
                                   bool firstForConfig);
-  void WriteObjectBuildStatement(cmSourceFile const* source,
+  void WriteObjectBuildStatement(std::ostream& os, cmSourceFile const* source,
                                  const std::string& config,
-                                 const std::string& fileConfig,
                                  bool firstForConfig);
+
+  /// @return the file holding the object build statements for @a config
+  /// when they are kept in a shard of their own.
+  std::string GetObjectShardPath(const std::string& config) const;
+
+  /**
+   * Compute a hash of everything the object build statements for
+   * @a config are generated from.
+   * @return an empty string if the statements depend on something the
+   *         hash does not cover, in which case they are always written
+   *         inline.
+   */
+  std::string ComputeObjectShardFingerprint(
+    std::vector<cmSourceFile const*> const& objectSources,
+    const std::string& config);
+
+  /// Write the object shard for @a config unless the existing one was
+  /// generated from the same @a fingerprint.
+  void WriteObjectShard(std::vector<cmSourceFile const*> const& objectSources,
+                        const std::string& config,
+                        std::string const& fingerprint);
+
   void WriteTargetDependInfo(std::string const& lang,
                              const std::string& config);
 
@@ -215,6 +237,8 @@ private:
     std::vector<cmCustomCommand const*> CustomCommands;
     cmNinjaDeps ExtraFiles;
     std::unique_ptr<MacOSXContentGeneratorType> MacOSXContentGenerator;
+    /// Fingerprint of the object shard, empty if it is not sharded.
+    std::string ObjectShardFingerprint;
   };
 
   std::map<std::string, ByConfig> Configs;
@@ -0,0 +1,68 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmPerConfig_h
+#define cmPerConfig_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <cm/memory>
+
+/** \class cmPerConfig
+ * \brief Storage for one value per build configuration.
+ *
+ * Values are indexed by the dense configuration index handed out by
+ * cmGlobalGenerator::GetConfigIndex.  Each value is allocated on its own
+ * so that references to it stay valid when more configurations are added.
+ */
+template <typename T>
+class cmPerConfig
+{
+public:
+  /** Get the value for a configuration, or null if there is none yet.  */
+  T* Find(std::size_t config) const
+  {
+    return config < this->Values.size() ? this->Values[config].get()
+                                         : nullptr;
+  }
+
+  /** Get the value for a configuration, default-constructing it if
+      there is none yet.  The second member is true if it was created.  */
+  std::pair<T*, bool> Emplace(std::size_t config)
+  {
+    if (config >= this->Values.size()) {
+      this->Values.resize(config + 1);
+    }
+    std::unique_ptr<T>& value = this->Values[config];
+    if (value) {
+      return { value.get(), false };
+    }
+    value = cm::make_unique<T>();
+    return { value.get(), true };
+  }
+
+  T& operator[](std::size_t config) { return *this->Emplace(config).first; }
+
+  /** Get the value of the configuration with the lowest index, or null
+      if there is none.  */
+  T* First() const
+  {
+    for (std::unique_ptr<T> const& value : this->Values) {
+      if (value) {
+        return value.get();
+      }
+    }
+    return nullptr;
+  }
+
+  void Clear() { this->Values.clear(); }
+
+private:
+  std::vector<std::unique_ptr<T>> Values;
+};
+
+#endif
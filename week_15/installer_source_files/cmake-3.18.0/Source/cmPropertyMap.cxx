@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <utility>
 
+#include "cmInternedString.h"
+
 void cmPropertyMap::Clear()
 {
   Map_.clear();
@@ -13,11 +15,11 @@ void cmPropertyMap::Clear()
 void cmPropertyMap::SetProperty(const std::string& name, const char* value)
 {
   if (!value) {
-    Map_.erase(name);
+    this->RemoveProperty(name);
     return;
   }
 
-  Map_[name] = value;
+  this->GetOrCreateValue(name) = value;
 }
 
 void cmPropertyMap::AppendProperty(const std::string& name,
@@ -29,7 +31,7 @@ void cmPropertyMap::AppendProperty(const std::string& name,
   }
 
   {
-    std::string& pVal = Map_[name];
+    std::string& pVal = this->GetOrCreateValue(name);
     if (!pVal.empty() && !asString) {
       pVal += ';';
     }
@@ -56,7 +58,7 @@ std::vector<std::string> cmPropertyMap::GetKeys() const
   std::vector<std::string> keyList;
   keyList.reserve(Map_.size());
   for (auto const& item : Map_) {
-    keyList.push_back(item.first);
+    keyList.emplace_back(item.first);
   }
   std::sort(keyList.begin(), keyList.end());
   return keyList;
@@ -68,7 +70,7 @@ std::vector<std::pair<std::string, std::string>> cmPropertyMap::GetList() const
   std::vector<StringPair> kvList;
   kvList.reserve(Map_.size());
   for (auto const& item : Map_) {
-    kvList.emplace_back(item.first, item.second);
+    kvList.emplace_back(std::string(item.first), item.second);
   }
   std::sort(kvList.begin(), kvList.end(),
             [](StringPair const& a, StringPair const& b) {
@@ -76,3 +78,13 @@ std::vector<std::pair<std::string, std::string>> cmPropertyMap::GetList() const
             });
   return kvList;
 }
+
+std::string& cmPropertyMap::GetOrCreateValue(const std::string& name)
+{
+  auto it = Map_.find(name);
+  if (it == Map_.end()) {
+    // The interned name outlives the map.
+    it = Map_.emplace(cmInternedString(name).view(), std::string()).first;
+  }
+  return it->second;
+}
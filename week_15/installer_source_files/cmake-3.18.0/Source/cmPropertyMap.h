@@ -10,10 +10,17 @@
 #include <utility>
 #include <vector>
 
+#include <cm/string_view>
+
 #include "cmProperty.h"
 
 /** \class cmPropertyMap
  * \brief String property map.
+ *
+ * Property names are interned when they are set since the same names are
+ * set on many targets, source files and directories.  The keys view the
+ * interned names, so looking a property up does not touch the intern
+ * table.
  */
 class cmPropertyMap
 {
@@ -47,7 +54,9 @@ public:
   std::vector<std::pair<std::string, std::string>> GetList() const;
 
 private:
-  std::unordered_map<std::string, std::string> Map_;
+  std::string& GetOrCreateValue(const std::string& name);
+
+  std::unordered_map<cm::string_view, std::string> Map_;
 };
 
 #endif
@@ -0,0 +1,43 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmRegularExpressionCache.h"
+
+cmRegularExpressionCache::cmRegularExpressionCache(std::size_t capacity)
+  : Capacity(capacity)
+{
+}
+
+cmRegularExpressionCache::~cmRegularExpressionCache() = default;
+
+std::shared_ptr<cmsys::RegularExpression const> cmRegularExpressionCache::Get(
+  std::string const& pattern)
+{
+  auto it = this->Index.find(pattern);
+  if (it != this->Index.end()) {
+    this->Entries.splice(this->Entries.begin(), this->Entries, it->second);
+    return it->second->second;
+  }
+
+  std::shared_ptr<cmsys::RegularExpression const> regex = Compile(pattern);
+  if (!regex || this->Capacity == 0) {
+    return regex;
+  }
+  if (this->Entries.size() >= this->Capacity) {
+    this->Index.erase(this->Entries.back().first);
+    this->Entries.pop_back();
+  }
+  this->Entries.emplace_front(pattern, regex);
+  this->Index.emplace(pattern, this->Entries.begin());
+  return regex;
+}
+
+std::shared_ptr<cmsys::RegularExpression const>
+cmRegularExpressionCache::Compile(std::string const& pattern)
+{
+  auto regex = std::make_shared<cmsys::RegularExpression>();
+  if (!regex->compile(pattern)) {
+    return nullptr;
+  }
+  regex->set_engine(cmsys::RegularExpression::Linear);
+  return regex;
+}
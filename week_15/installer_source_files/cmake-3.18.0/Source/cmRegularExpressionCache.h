@@ -0,0 +1,58 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmRegularExpressionCache_h
+#define cmRegularExpressionCache_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "cmsys/RegularExpression.hxx"
+
+/** \class cmRegularExpressionCache
+ * \brief Keeps the most recently used compiled regular expressions.
+ *
+ * The expressions use the linear time matching engine.  Match with
+ * find(const char*, RegularExpressionMatch&) because they are shared.
+ */
+class cmRegularExpressionCache
+{
+public:
+  explicit cmRegularExpressionCache(std::size_t capacity = 256);
+  ~cmRegularExpressionCache();
+
+  cmRegularExpressionCache(const cmRegularExpressionCache&) = delete;
+  cmRegularExpressionCache& operator=(const cmRegularExpressionCache&) =
+    delete;
+
+  /**
+   * @brief Compiles the pattern or returns it from the cache.
+   * @return nullptr if the pattern does not compile
+   */
+  std::shared_ptr<cmsys::RegularExpression const> Get(
+    std::string const& pattern);
+
+  /**
+   * @brief Compiles a pattern for the linear time matching engine
+   * without caching it.
+   * @return nullptr if the pattern does not compile
+   */
+  static std::shared_ptr<cmsys::RegularExpression const> Compile(
+    std::string const& pattern);
+
+private:
+  using Entry =
+    std::pair<std::string, std::shared_ptr<cmsys::RegularExpression const>>;
+
+  std::size_t Capacity;
+  // Most recently used first.
+  std::list<Entry> Entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> Index;
+};
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "cmInternedString.h"
 #include "cmSourceFileLocationKind.h"
 
 class cmMakefile;
@@ -93,7 +94,8 @@ private:
   cmMakefile const* const Makefile = nullptr;
   bool AmbiguousDirectory = true;
   bool AmbiguousExtension = true;
-  std::string Directory;
+  // Many sources share a directory, so it is interned.
+  cmInternedString Directory;
   std::string Name;
 
   bool MatchesAmbiguousExtension(cmSourceFileLocation const& loc) const;
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <utility>
@@ -30,6 +31,7 @@ cmState::cmState()
 {
   this->CacheManager = cm::make_unique<cmCacheManager>();
   this->GlobVerificationManager = cm::make_unique<cmGlobVerificationManager>();
+  this->BumpCommandGeneration();
 }
 
 cmState::~cmState() = default;
@@ -219,6 +221,11 @@ std::string const& cmState::GetGlobVerifyScript() const
   return this->GlobVerificationManager->GetVerifyScript();
 }
 
+std::string const& cmState::GetGlobVerifyState() const
+{
+  return this->GlobVerificationManager->GetVerifyState();
+}
+
 std::string const& cmState::GetGlobVerifyStamp() const
 {
   return this->GlobVerificationManager->GetVerifyStamp();
@@ -296,14 +303,11 @@ cmStateSnapshot cmState::Reset()
   assert(pos->PolicyRoot.IsValid());
 
   {
-    std::string srcDir =
-      *cmDefinitions::Get("CMAKE_SOURCE_DIR", pos->Vars, pos->Root);
-    std::string binDir =
-      *cmDefinitions::Get("CMAKE_BINARY_DIR", pos->Vars, pos->Root);
+    std::string srcDir = *pos->Vars->Get("CMAKE_SOURCE_DIR");
+    std::string binDir = *pos->Vars->Get("CMAKE_BINARY_DIR");
     this->VarTree.Clear();
     pos->Vars = this->VarTree.Push(this->VarTree.Root());
     pos->Parent = this->VarTree.Root();
-    pos->Root = this->VarTree.Root();
 
     pos->Vars->Set("CMAKE_SOURCE_DIR", srcDir);
     pos->Vars->Set("CMAKE_BINARY_DIR", binDir);
@@ -408,7 +412,9 @@ void cmState::AddBuiltinCommand(std::string const& name, Command command)
 {
   assert(name == cmSystemTools::LowerCase(name));
   assert(this->BuiltinCommands.find(name) == this->BuiltinCommands.end());
-  this->BuiltinCommands.emplace(name, std::move(command));
+  this->BuiltinCommands.emplace(
+    name, std::make_shared<Command const>(std::move(command)));
+  this->BumpCommandGeneration();
 }
 
 static bool InvokeBuiltinCommand(cmState::BuiltinCommand command,
@@ -484,11 +490,18 @@ void cmState::AddScriptedCommand(std::string const& name, Command command)
   std::string sName = cmSystemTools::LowerCase(name);
 
   // if the command already exists, give a new name to the old command.
-  if (Command oldCmd = this->GetCommandByExactName(sName)) {
-    this->ScriptedCommands["_" + sName] = oldCmd;
+  if (std::shared_ptr<Command const> oldCmd = this->ResolveCommand(sName)) {
+    this->ScriptedCommands["_" + sName] = std::move(oldCmd);
   }
 
-  this->ScriptedCommands[sName] = std::move(command);
+  this->ScriptedCommands[sName] =
+    std::make_shared<Command const>(std::move(command));
+  this->BumpCommandGeneration();
+}
+
+bool cmState::IsScriptedCommand(std::string const& name) const
+{
+  return this->ScriptedCommands.find(name) != this->ScriptedCommands.end();
 }
 
 cmState::Command cmState::GetCommand(std::string const& name) const
@@ -497,6 +510,15 @@ cmState::Command cmState::GetCommand(std::string const& name) const
 }
 
 cmState::Command cmState::GetCommandByExactName(std::string const& name) const
+{
+  if (std::shared_ptr<Command const> command = this->ResolveCommand(name)) {
+    return *command;
+  }
+  return nullptr;
+}
+
+std::shared_ptr<cmState::Command const> cmState::ResolveCommand(
+  std::string const& name) const
 {
   auto pos = this->ScriptedCommands.find(name);
   if (pos != this->ScriptedCommands.end()) {
@@ -509,6 +531,14 @@ cmState::Command cmState::GetCommandByExactName(std::string const& name) const
   return nullptr;
 }
 
+void cmState::BumpCommandGeneration()
+{
+  // Take generations from a counter shared by all states so that a
+  // command resolved by one state is never taken as current by another.
+  static std::atomic<std::size_t> nextGeneration(1);
+  this->CommandGeneration = nextGeneration++;
+}
+
 std::vector<std::string> cmState::GetCommandNames() const
 {
   std::vector<std::string> commandNames;
@@ -530,11 +560,13 @@ void cmState::RemoveBuiltinCommand(std::string const& name)
 {
   assert(name == cmSystemTools::LowerCase(name));
   this->BuiltinCommands.erase(name);
+  this->BumpCommandGeneration();
 }
 
 void cmState::RemoveUserDefinedCommands()
 {
   this->ScriptedCommands.clear();
+  this->BumpCommandGeneration();
 }
 
 void cmState::SetGlobalProperty(const std::string& prop, const char* value)
@@ -799,7 +831,6 @@ cmStateSnapshot cmState::CreateBaseSnapshot()
   pos->Vars = this->VarTree.Push(this->VarTree.Root());
   assert(pos->Vars.IsValid());
   pos->Parent = this->VarTree.Root();
-  pos->Root = this->VarTree.Root();
   return { this, pos };
 }
 
@@ -826,7 +857,6 @@ cmStateSnapshot cmState::CreateBuildsystemDirectorySnapshot(
 
   cmLinkedTree<cmDefinitions>::iterator origin = originSnapshot.Position->Vars;
   pos->Parent = origin;
-  pos->Root = origin;
   pos->Vars = this->VarTree.Push(origin);
 
   cmStateSnapshot snapshot = cmStateSnapshot(this, pos);
@@ -852,7 +882,7 @@ cmStateSnapshot cmState::CreateFunctionCallSnapshot(
   assert(originSnapshot.Position->Vars.IsValid());
   cmLinkedTree<cmDefinitions>::iterator origin = originSnapshot.Position->Vars;
   pos->Parent = origin;
-  pos->Vars = this->VarTree.Push(origin);
+  pos->Vars = this->VarTree.Push(origin, origin->MakeChild());
   return { this, pos };
 }
 
@@ -899,7 +929,7 @@ cmStateSnapshot cmState::CreateVariableScopeSnapshot(
 
   cmLinkedTree<cmDefinitions>::iterator origin = originSnapshot.Position->Vars;
   pos->Parent = origin;
-  pos->Vars = this->VarTree.Push(origin);
+  pos->Vars = this->VarTree.Push(origin, origin->MakeChild());
   assert(pos->Vars.IsValid());
   return { this, pos };
 }
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "cmDefinitions.h"
+#include "cmInternedString.h"
 #include "cmLinkedTree.h"
 #include "cmListFileCache.h"
 #include "cmPolicies.h"
@@ -151,6 +152,12 @@ public:
   Command GetCommand(std::string const& name) const;
   // Returns a command from its name, or nullptr
   Command GetCommandByExactName(std::string const& name) const;
+  // Returns a shared command from its name, or nullptr.  The result is
+  // the current definition until GetCommandGeneration() changes.
+  std::shared_ptr<Command const> ResolveCommand(std::string const& name) const;
+  // Returns a value that changes whenever a command is added, replaced
+  // or removed.  Values are never reused, even across cmState instances.
+  std::size_t GetCommandGeneration() const { return this->CommandGeneration; }
 
   void AddBuiltinCommand(std::string const& name,
                          std::unique_ptr<cmCommand> command);
@@ -160,6 +167,8 @@ public:
                             cmPolicies::PolicyID policy, const char* message);
   void AddUnexpectedCommand(std::string const& name, const char* error);
   void AddScriptedCommand(std::string const& name, Command command);
+  // Returns true if the command was defined by function() or macro()
+  bool IsScriptedCommand(std::string const& name) const;
   void RemoveBuiltinCommand(std::string const& name);
   void RemoveUserDefinedCommands();
   std::vector<std::string> GetCommandNames() const;
@@ -209,6 +218,7 @@ private:
 
   bool DoWriteGlobVerifyTarget() const;
   std::string const& GetGlobVerifyScript() const;
+  std::string const& GetGlobVerifyState() const;
   std::string const& GetGlobVerifyStamp() const;
   bool SaveVerificationScript(const std::string& path);
   void AddGlobCacheEntry(bool recurse, bool listDirectories,
@@ -220,8 +230,11 @@ private:
 
   cmPropertyDefinitionMap PropertyDefinitions;
   std::vector<std::string> EnabledLanguages;
-  std::map<std::string, Command> BuiltinCommands;
-  std::map<std::string, Command> ScriptedCommands;
+  void BumpCommandGeneration();
+
+  std::map<std::string, std::shared_ptr<Command const>> BuiltinCommands;
+  std::map<std::string, std::shared_ptr<Command const>> ScriptedCommands;
+  std::size_t CommandGeneration = 0;
   cmPropertyMap GlobalProperties;
   std::unique_ptr<cmCacheManager> CacheManager;
   std::unique_ptr<cmGlobVerificationManager> GlobVerificationManager;
@@ -229,7 +242,7 @@ private:
   cmLinkedTree<cmStateDetail::BuildsystemDirectoryStateType>
     BuildsystemDirectory;
 
-  cmLinkedTree<std::string> ExecutionListFiles;
+  cmLinkedTree<cmInternedString> ExecutionListFiles;
 
   cmLinkedTree<cmStateDetail::PolicyStackEntry> PolicyStack;
   cmLinkedTree<cmStateDetail::SnapshotDataType> SnapshotData;
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "cmDefinitions.h"
+#include "cmInternedString.h"
 #include "cmLinkedTree.h"
 #include "cmListFileCache.h"
 #include "cmPolicies.h"
@@ -33,11 +34,10 @@ struct cmStateDetail::SnapshotDataType
   cmLinkedTree<cmStateDetail::PolicyStackEntry>::iterator PolicyScope;
   cmStateEnums::SnapshotType SnapshotType;
   bool Keep;
-  cmLinkedTree<std::string>::iterator ExecutionListFile;
+  cmLinkedTree<cmInternedString>::iterator ExecutionListFile;
   cmLinkedTree<cmStateDetail::BuildsystemDirectoryStateType>::iterator
     BuildSystemDirectory;
   cmLinkedTree<cmDefinitions>::iterator Vars;
-  cmLinkedTree<cmDefinitions>::iterator Root;
   cmLinkedTree<cmDefinitions>::iterator Parent;
   std::vector<std::string>::size_type IncludeDirectoryPosition;
   std::vector<std::string>::size_type CompileDefinitionsPosition;
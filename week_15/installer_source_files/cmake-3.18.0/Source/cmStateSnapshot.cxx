@@ -53,7 +53,7 @@ void cmStateSnapshot::SetListFile(const std::string& listfile)
   *this->Position->ExecutionListFile = listfile;
 }
 
-std::string cmStateSnapshot::GetExecutionListFile() const
+cmInternedString cmStateSnapshot::GetExecutionListFile() const
 {
   return *this->Position->ExecutionListFile;
 }
@@ -212,13 +212,12 @@ std::string const* cmStateSnapshot::GetDefinition(
   std::string const& name) const
 {
   assert(this->Position->Vars.IsValid());
-  return cmDefinitions::Get(name, this->Position->Vars, this->Position->Root);
+  return this->Position->Vars->Get(name);
 }
 
 bool cmStateSnapshot::IsInitialized(std::string const& name) const
 {
-  return cmDefinitions::HasKey(name, this->Position->Vars,
-                               this->Position->Root);
+  return this->Position->Vars->HasKey(name);
 }
 
 void cmStateSnapshot::SetDefinition(std::string const& name,
@@ -232,6 +231,26 @@ void cmStateSnapshot::RemoveDefinition(std::string const& name)
   this->Position->Vars->Unset(name);
 }
 
+std::vector<std::string> const* cmStateSnapshot::GetListDefinition(
+  std::string const& name) const
+{
+  assert(this->Position->Vars.IsValid());
+  return this->Position->Vars->GetList(name);
+}
+
+bool cmStateSnapshot::AppendListDefinition(
+  std::string const& name, std::vector<std::string>::const_iterator first,
+  std::vector<std::string>::const_iterator last)
+{
+  return this->Position->Vars->Append(name, first, last);
+}
+
+bool cmStateSnapshot::PopBackListDefinition(std::string const& name,
+                                            std::size_t count)
+{
+  return this->Position->Vars->PopBack(name, count);
+}
+
 std::vector<std::string> cmStateSnapshot::UnusedKeys() const
 {
   return this->Position->Vars->UnusedKeys();
@@ -239,8 +258,7 @@ std::vector<std::string> cmStateSnapshot::UnusedKeys() const
 
 std::vector<std::string> cmStateSnapshot::ClosureKeys() const
 {
-  return cmDefinitions::ClosureKeys(this->Position->Vars,
-                                    this->Position->Root);
+  return this->Position->Vars->ClosureKeys();
 }
 
 bool cmStateSnapshot::RaiseScope(std::string const& var, const char* varDef)
@@ -260,10 +278,8 @@ bool cmStateSnapshot::RaiseScope(std::string const& var, const char* varDef)
     }
     return true;
   }
-  // First localize the definition in the current scope.
-  cmDefinitions::Raise(var, this->Position->Vars, this->Position->Root);
-
-  // Now update the definition in the parent scope.
+  // Update the definition in the parent scope.  This scope keeps its
+  // own copy of the definitions, so it is not affected.
   if (varDef) {
     this->Position->Parent->Set(var, varDef);
   } else {
@@ -374,8 +390,7 @@ void cmStateSnapshot::InitializeFromParent()
   assert(this->Position->Vars.IsValid());
   assert(parent->Vars.IsValid());
 
-  *this->Position->Vars =
-    cmDefinitions::MakeClosure(parent->Vars, parent->Root);
+  *this->Position->Vars = parent->Vars->MakeClosure();
 
   InitializeContentFromParent(
     parent->BuildSystemDirectory->IncludeDirectories,
@@ -6,11 +6,13 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
 #include <cm/string_view>
 
+#include "cmInternedString.h"
 #include "cmLinkedTree.h"
 #include "cmPolicies.h"
 #include "cmStateTypes.h"
@@ -28,13 +30,19 @@ public:
   bool IsInitialized(std::string const& name) const;
   void SetDefinition(std::string const& name, cm::string_view value);
   void RemoveDefinition(std::string const& name);
+  std::vector<std::string> const* GetListDefinition(
+    std::string const& name) const;
+  bool AppendListDefinition(std::string const& name,
+                            std::vector<std::string>::const_iterator first,
+                            std::vector<std::string>::const_iterator last);
+  bool PopBackListDefinition(std::string const& name, std::size_t count);
   std::vector<std::string> UnusedKeys() const;
   std::vector<std::string> ClosureKeys() const;
   bool RaiseScope(std::string const& var, const char* varDef);
 
   void SetListFile(std::string const& listfile);
 
-  std::string GetExecutionListFile() const;
+  cmInternedString GetExecutionListFile() const;
 
   std::vector<cmStateSnapshot> GetChildren();
 
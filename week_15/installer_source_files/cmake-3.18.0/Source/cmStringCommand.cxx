@@ -21,12 +21,14 @@
 #include "cmMakefile.h"
 #include "cmMessageType.h"
 #include "cmRange.h"
+#include "cmRegularExpressionCache.h"
 #include "cmStringAlgorithms.h"
 #include "cmStringReplaceHelper.h"
 #include "cmSubcommandTable.h"
 #include "cmSystemTools.h"
 #include "cmTimestamp.h"
 #include "cmUuid.h"
+#include "cmake.h"
 
 namespace {
 
@@ -228,8 +230,10 @@ bool RegexMatch(std::vector<std::string> const& args,
 
   status.GetMakefile().ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  std::shared_ptr<cmsys::RegularExpression const> re =
+    status.GetMakefile().GetCMakeInstance()->GetRegularExpressionCache()->Get(
+      regex);
+  if (!re) {
     std::string e =
       "sub-command REGEX, mode MATCH failed to compile regex \"" + regex +
       "\".";
@@ -242,10 +246,11 @@ bool RegexMatch(std::vector<std::string> const& args,
 
   // Scan through the input for all matches.
   std::string output;
-  if (re.find(input)) {
-    status.GetMakefile().StoreMatches(re);
-    std::string::size_type l = re.start();
-    std::string::size_type r = re.end();
+  cmsys::RegularExpressionMatch match;
+  if (re->find(input.c_str(), match)) {
+    status.GetMakefile().StoreMatches(match);
+    std::string::size_type l = match.start();
+    std::string::size_type r = match.end();
     if (r - l == 0) {
       std::string e = "sub-command REGEX, mode MATCH regex \"" + regex +
         "\" matched an empty string.";
@@ -270,8 +275,10 @@ bool RegexMatchAll(std::vector<std::string> const& args,
 
   status.GetMakefile().ClearMatches();
   // Compile the regular expression.
-  cmsys::RegularExpression re;
-  if (!re.compile(regex.c_str())) {
+  std::shared_ptr<cmsys::RegularExpression const> re =
+    status.GetMakefile().GetCMakeInstance()->GetRegularExpressionCache()->Get(
+      regex);
+  if (!re) {
     std::string e =
       "sub-command REGEX, mode MATCHALL failed to compile regex \"" + regex +
       "\".";
@@ -285,11 +292,12 @@ bool RegexMatchAll(std::vector<std::string> const& args,
   // Scan through the input for all matches.
   std::string output;
   const char* p = input.c_str();
-  while (re.find(p)) {
+  cmsys::RegularExpressionMatch match;
+  while (re->find(p, match)) {
     status.GetMakefile().ClearMatches();
-    status.GetMakefile().StoreMatches(re);
-    std::string::size_type l = re.start();
-    std::string::size_type r = re.end();
+    status.GetMakefile().StoreMatches(match);
+    std::string::size_type l = match.start();
+    std::string::size_type r = match.end();
     if (r - l == 0) {
       std::string e = "sub-command REGEX, mode MATCHALL regex \"" + regex +
         "\" matched an empty string.";
@@ -3,6 +3,7 @@
 #ifndef cmStringReplaceHelper_h
 #define cmStringReplaceHelper_h
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,7 +20,7 @@ public:
 
   bool IsRegularExpressionValid() const
   {
-    return this->RegularExpression.is_valid();
+    return this->RegularExpression != nullptr;
   }
   bool IsReplaceExpressionValid() const
   {
@@ -58,7 +59,7 @@ private:
 
   std::string ErrorString;
   std::string RegExString;
-  cmsys::RegularExpression RegularExpression;
+  std::shared_ptr<cmsys::RegularExpression const> RegularExpression;
   bool ValidReplaceExpression = true;
   std::string ReplaceExpression;
   std::vector<RegexReplacement> Replacements;
@@ -683,6 +683,7 @@ void cmTarget::AddPostBuildCommand(cmCustomCommand&& cmd)
 
 void cmTarget::AddTracedSources(std::vector<std::string> const& srcs)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   if (!srcs.empty()) {
     cmListFileBacktrace lfbt = impl->Makefile->GetBacktrace();
     impl->SourceEntries.push_back(cmJoin(srcs, ";"));
@@ -692,6 +693,7 @@ void cmTarget::AddTracedSources(std::vector<std::string> const& srcs)
 
 void cmTarget::AddSources(std::vector<std::string> const& srcs)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   std::string srcFiles;
   const char* sep = "";
   for (auto filename : srcs) {
@@ -813,6 +815,7 @@ public:
 
 cmSourceFile* cmTarget::AddSource(const std::string& src, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   cmSourceFileLocation sfl(impl->Makefile, src,
                            cmSourceFileLocationKind::Known);
   if (std::find_if(impl->SourceEntries.begin(), impl->SourceEntries.end(),
@@ -1126,6 +1129,7 @@ void cmTarget::SetProperty(const std::string& prop, const char* value)
         impl->Makefile->GetBacktrace())) {
     return;
   }
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
 #define MAKE_STATIC_PROP(PROP) static const std::string prop##PROP = #PROP
   MAKE_STATIC_PROP(COMPILE_DEFINITIONS);
   MAKE_STATIC_PROP(COMPILE_FEATURES);
@@ -1323,6 +1327,7 @@ void cmTarget::AppendProperty(const std::string& prop,
         impl->Makefile->GetBacktrace())) {
     return;
   }
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   if (prop == "NAME") {
     impl->Makefile->IssueMessage(MessageType::FATAL_ERROR,
                                  "NAME property is read-only\n");
@@ -1448,6 +1453,7 @@ void cmTarget::AppendBuildInterfaceIncludes()
 void cmTarget::InsertInclude(std::string const& entry,
                              cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->IncludeDirectoriesEntries.begin()
                          : impl->IncludeDirectoriesEntries.end();
 
@@ -1461,6 +1467,7 @@ void cmTarget::InsertInclude(std::string const& entry,
 void cmTarget::InsertCompileOption(std::string const& entry,
                                    cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->CompileOptionsEntries.begin()
                          : impl->CompileOptionsEntries.end();
 
@@ -1474,6 +1481,7 @@ void cmTarget::InsertCompileOption(std::string const& entry,
 void cmTarget::InsertCompileDefinition(std::string const& entry,
                                        cmListFileBacktrace const& bt)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   impl->CompileDefinitionsEntries.push_back(entry);
   impl->CompileDefinitionsBacktraces.push_back(bt);
 }
@@ -1481,6 +1489,7 @@ void cmTarget::InsertCompileDefinition(std::string const& entry,
 void cmTarget::InsertLinkOption(std::string const& entry,
                                 cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position =
     before ? impl->LinkOptionsEntries.begin() : impl->LinkOptionsEntries.end();
 
@@ -1494,6 +1503,7 @@ void cmTarget::InsertLinkOption(std::string const& entry,
 void cmTarget::InsertLinkDirectory(std::string const& entry,
                                    cmListFileBacktrace const& bt, bool before)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   auto position = before ? impl->LinkDirectoriesEntries.begin()
                          : impl->LinkDirectoriesEntries.end();
 
@@ -1507,6 +1517,7 @@ void cmTarget::InsertLinkDirectory(std::string const& entry,
 void cmTarget::InsertPrecompileHeader(std::string const& entry,
                                       cmListFileBacktrace const& bt)
 {
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
   impl->PrecompileHeadersEntries.push_back(entry);
   impl->PrecompileHeadersBacktraces.push_back(bt);
 }
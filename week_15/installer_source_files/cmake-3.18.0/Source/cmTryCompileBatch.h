@@ -0,0 +1,57 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmTryCompileBatch_h
+#define cmTryCompileBatch_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cmListFileCache.h"
+#include "cmStateTypes.h"
+
+/** \class cmTryCompileBatch
+ * \brief try_compile checks queued by try_compile_batch(BEGIN).
+ *
+ * While a batch is open in a directory, source file signature checks
+ * announced by try_compile_batch(QUEUE) write their test project into a
+ * subdirectory of the batch directory instead of building it.
+ * try_compile_batch(END), or reading the result of a queued check,
+ * configures them as one project, builds each of its targets and then
+ * reports each result in queue order.
+ */
+struct cmTryCompileBatch
+{
+  /** What to do with the result of one try_compile call.  */
+  struct Check
+  {
+    std::string ResultVariable;
+    std::string OutputVariable;
+    std::string CopyFile;
+    std::string CopyFileError;
+    std::string BinaryDirectory;
+    std::string TargetName;
+    cmStateEnums::TargetType TargetType = cmStateEnums::EXECUTABLE;
+    std::string CacheEntry;
+
+    /** Commands given to try_compile_batch(CALL) for this check.  */
+    std::vector<cmListFileFunction> Calls;
+  };
+
+  std::string Directory;
+  cmListFileBacktrace Backtrace;
+  std::vector<Check> Checks;
+
+  /** Number of checks queued so far, used to name their directories.  */
+  std::size_t QueuedCount = 0;
+
+  /** Whether try_compile_batch(QUEUE) announced the next call.  */
+  bool QueueNext = false;
+
+  /** Whether the most recent try_compile call was queued.  */
+  bool LastQueued = false;
+};
+
+#endif
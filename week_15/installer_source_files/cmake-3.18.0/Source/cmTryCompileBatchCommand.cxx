@@ -0,0 +1,305 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#include "cmTryCompileBatchCommand.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include <thread>
+#endif
+
+#include <cmext/string_view>
+
+#include "cmsys/FStream.hxx"
+
+#include "cmExecutionStatus.h"
+#include "cmListFileCache.h"
+#include "cmMakefile.h"
+#include "cmMessageType.h"
+#include "cmOutputConverter.h"
+#include "cmStringAlgorithms.h"
+#include "cmSystemTools.h"
+#include "cmTryCompileBatch.h"
+#include "cmVersion.h"
+#include "cmake.h"
+
+#if !defined(CMAKE_BOOTSTRAP)
+#  include "cmVariableWatch.h"
+#endif
+
+namespace {
+std::array<cm::static_string_view, 12> const InvalidCommands{
+  { // clang-format off
+  "function"_s, "endfunction"_s,
+  "macro"_s, "endmacro"_s,
+  "if"_s, "elseif"_s, "else"_s, "endif"_s,
+  "while"_s, "endwhile"_s,
+  "foreach"_s, "endforeach"_s
+  } // clang-format on
+};
+
+// Number of jobs for building a batch: CMAKE_BUILD_PARALLEL_LEVEL if
+// set, otherwise one per processor.
+int GetBatchParallelLevel()
+{
+  std::string level;
+  unsigned long n;
+  if (cmSystemTools::GetEnv("CMAKE_BUILD_PARALLEL_LEVEL", level) &&
+      cmStrToULong(level, &n) && n > 0) {
+    return static_cast<int>(n);
+  }
+#if !defined(CMAKE_BOOTSTRAP)
+  if (unsigned int cpus = std::thread::hardware_concurrency()) {
+    return static_cast<int>(cpus);
+  }
+#endif
+  return cmake::NO_BUILD_PARALLEL_LEVEL;
+}
+}
+
+// cmTryCompileBatchCommand
+bool cmTryCompileBatchCommand::InitialPass(
+  std::vector<std::string> const& args, cmExecutionStatus& status)
+{
+  if (args.empty()) {
+    this->SetError("called with incorrect number of arguments");
+    return false;
+  }
+
+  if (this->Makefile->GetCMakeInstance()->GetWorkingMode() ==
+      cmake::FIND_PACKAGE_MODE) {
+    this->Makefile->IssueMessage(
+      MessageType::FATAL_ERROR,
+      "The TRY_COMPILE_BATCH() command is not supported in "
+      "--find-package mode.");
+    return false;
+  }
+
+  if (args[0] == "BEGIN") {
+    return this->HandleBegin(args);
+  }
+  if (args[0] == "QUEUE") {
+    return this->HandleQueue(args);
+  }
+  if (args[0] == "CALL") {
+    return this->HandleCall(args, status);
+  }
+  if (args[0] == "END") {
+    return this->HandleEnd(args);
+  }
+  this->SetError(cmStrCat("given unknown argument \"", args[0], "\"."));
+  return false;
+}
+
+bool cmTryCompileBatchCommand::HandleBegin(
+  std::vector<std::string> const& args)
+{
+  if (args.size() != 1) {
+    this->SetError("BEGIN does not take any arguments.");
+    return false;
+  }
+  if (this->Makefile->GetTryCompileBatch()) {
+    this->SetError("BEGIN called while a batch is already open.");
+    return false;
+  }
+
+  auto batch = cm::make_unique<cmTryCompileBatch>();
+  batch->Directory = cmStrCat(this->Makefile->GetCurrentBinaryDirectory(),
+                              "/CMakeFiles/CMakeTmpBatch");
+  batch->Backtrace = this->Makefile->GetBacktrace();
+
+  // Start from an empty directory in case a previous run was debugged.
+  cmSystemTools::RemoveADirectory(batch->Directory);
+  cmSystemTools::MakeDirectory(batch->Directory);
+
+  this->Makefile->SetTryCompileBatch(std::move(batch));
+  return true;
+}
+
+bool cmTryCompileBatchCommand::HandleQueue(
+  std::vector<std::string> const& args)
+{
+  if (args.size() != 1) {
+    this->SetError("QUEUE does not take any arguments.");
+    return false;
+  }
+  if (cmTryCompileBatch* batch = this->Makefile->GetTryCompileBatch()) {
+    batch->QueueNext = true;
+  }
+  return true;
+}
+
+bool cmTryCompileBatchCommand::HandleCall(std::vector<std::string> const& args,
+                                          cmExecutionStatus& status)
+{
+  if (args.size() < 2) {
+    this->SetError("CALL must be followed by a command name.");
+    return false;
+  }
+
+  std::string const cmd = cmSystemTools::LowerCase(args[1]);
+  if (std::find(InvalidCommands.cbegin(), InvalidCommands.cend(), cmd) !=
+      InvalidCommands.cend()) {
+    this->SetError(cmStrCat("CALL given invalid command: ", args[1]));
+    return false;
+  }
+
+  // The arguments have been evaluated already, so pass them on as
+  // bracket arguments to keep them from being evaluated again.
+  cmListFileContext context = this->Makefile->GetExecutionContext();
+  cmListFileFunction func;
+  func.Name = args[1];
+  func.Line = context.Line;
+  for (std::size_t i = 2; i < args.size(); ++i) {
+    func.Arguments.emplace_back(args[i], cmListFileArgument::Bracket,
+                                context.Line);
+  }
+
+  // Run the command once the result of the most recent try_compile is
+  // known, which is right now unless that check was queued.
+  cmTryCompileBatch* batch = this->Makefile->GetTryCompileBatch();
+  if (batch && batch->LastQueued) {
+    batch->Checks.back().Calls.push_back(std::move(func));
+    return true;
+  }
+  return this->Makefile->ExecuteCommand(func, status);
+}
+
+bool cmTryCompileBatchCommand::HandleEnd(std::vector<std::string> const& args)
+{
+  if (args.size() != 1) {
+    this->SetError("END does not take any arguments.");
+    return false;
+  }
+  std::unique_ptr<cmTryCompileBatch> batch =
+    this->Makefile->ReleaseTryCompileBatch();
+  if (!batch) {
+    this->SetError("END called without a matching BEGIN.");
+    return false;
+  }
+
+  this->BuildQueuedChecks(*batch);
+
+  if (!this->Makefile->GetCMakeInstance()->GetDebugTryCompile()) {
+    this->CleanupFiles(batch->Directory);
+  }
+  return true;
+}
+
+void cmTryCompileBatchCommand::BuildQueuedChecks(cmTryCompileBatch& batch)
+{
+  std::vector<cmTryCompileBatch::Check> checks;
+  checks.swap(batch.Checks);
+  batch.LastQueued = false;
+  if (checks.empty()) {
+    return;
+  }
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmVariableWatch* vv = this->Makefile->GetVariableWatch()) {
+    for (cmTryCompileBatch::Check const& check : checks) {
+      vv->RemoveWatch(check.ResultVariable,
+                      &cmTryCompileBatchCommand::QueuedResultAccessed);
+    }
+  }
+#endif
+
+  // Each check was written as a standalone project.  Add them all to
+  // one project, giving each the cache entries it would have been
+  // configured with.
+  std::string const projectFile = batch.Directory + "/CMakeLists.txt";
+  cmsys::ofstream fout(projectFile.c_str());
+  if (!fout) {
+    this->Makefile->IssueMessage(
+      MessageType::FATAL_ERROR,
+      cmStrCat("Failed to open\n  ", projectFile, "\n",
+               cmSystemTools::GetLastSystemError()));
+    return;
+  }
+  fout << "cmake_minimum_required(VERSION " << cmVersion::GetMajorVersion()
+       << '.' << cmVersion::GetMinorVersion() << '.'
+       << cmVersion::GetPatchVersion() << '.'
+       << cmVersion::GetTweakVersion() << ")\n"
+       << "project(CMAKE_TRY_COMPILE NONE)\n"
+       << "set(CMAKE_SUPPRESS_REGENERATION 1)\n"
+       << "set(CMAKE_VERBOSE_MAKEFILE 1)\n"
+       << "function(__cmake_try_compile_batch_add dir)\n"
+       << "  include(\"${dir}/TryCompileFlags.cmake\")\n"
+       << "  add_subdirectory(\"${dir}\" \"${dir}\")\n"
+       << "endfunction()\n";
+  std::vector<std::string> targetNames;
+  for (cmTryCompileBatch::Check const& check : checks) {
+    fout << "__cmake_try_compile_batch_add("
+         << cmOutputConverter::EscapeForCMake(check.BinaryDirectory) << ")\n";
+    targetNames.push_back(check.TargetName);
+  }
+  fout.close();
+
+  bool erroroc = cmSystemTools::GetErrorOccuredFlag();
+  cmSystemTools::ResetErrorOccuredFlag();
+  std::vector<std::string> outputs;
+  std::vector<int> results = this->Makefile->TryCompileTargets(
+    batch.Directory, batch.Directory, "CMAKE_TRY_COMPILE", targetNames,
+    GetBatchParallelLevel(), outputs);
+
+  // Report the results in the order the checks were made.
+  for (std::size_t i = 0; i < checks.size(); ++i) {
+    cmTryCompileBatch::Check const& check = checks[i];
+    this->FinishQueuedCheck(check, results[i], outputs[i]);
+    for (cmListFileFunction const& func : check.Calls) {
+      cmExecutionStatus callStatus(*this->Makefile);
+      this->Makefile->ExecuteCommand(func, callStatus);
+    }
+  }
+  if (erroroc) {
+    cmSystemTools::SetErrorOccured();
+  }
+}
+
+void cmTryCompileBatchCommand::WatchQueuedResult(cmMakefile& mf,
+                                                 std::string const& var)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (cmVariableWatch* vv = mf.GetVariableWatch()) {
+    vv->AddWatch(var, &cmTryCompileBatchCommand::QueuedResultAccessed);
+  }
+#else
+  static_cast<void>(mf);
+  static_cast<void>(var);
+#endif
+}
+
+void cmTryCompileBatchCommand::QueuedResultAccessed(
+  const std::string& variable, int access_type, void* /*client_data*/,
+  const char* /*newValue*/, const cmMakefile* mf)
+{
+#if !defined(CMAKE_BOOTSTRAP)
+  if (access_type != cmVariableWatch::VARIABLE_READ_ACCESS &&
+      access_type != cmVariableWatch::UNKNOWN_VARIABLE_READ_ACCESS &&
+      access_type != cmVariableWatch::UNKNOWN_VARIABLE_DEFINED_ACCESS) {
+    return;
+  }
+
+  // Only the batch of the directory reading the variable can be built.
+  cmMakefile* makefile = const_cast<cmMakefile*>(mf);
+  cmTryCompileBatch* batch = makefile->GetTryCompileBatch();
+  if (!batch ||
+      std::none_of(batch->Checks.begin(), batch->Checks.end(),
+                   [&variable](cmTryCompileBatch::Check const& check) {
+                     return check.ResultVariable == variable;
+                   })) {
+    return;
+  }
+
+  cmExecutionStatus status(*makefile);
+  cmTryCompileBatchCommand command;
+  command.SetExecutionStatus(&status);
+  command.BuildQueuedChecks(*batch);
+#else
+  static_cast<void>(variable);
+  static_cast<void>(access_type);
+  static_cast<void>(mf);
+#endif
+}
@@ -0,0 +1,66 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+#ifndef cmTryCompileBatchCommand_h
+#define cmTryCompileBatchCommand_h
+
+#include "cmConfigure.h" // IWYU pragma: keep
+
+#include <string>
+#include <vector>
+
+#include <cm/memory>
+
+#include "cmCommand.h"
+#include "cmCoreTryCompile.h"
+
+class cmExecutionStatus;
+class cmMakefile;
+struct cmTryCompileBatch;
+
+/** \class cmTryCompileBatchCommand
+ * \brief Build several try_compile checks as one project
+ *
+ * cmTryCompileBatchCommand queues the source file signature checks
+ * announced with QUEUE between BEGIN and END and builds them together
+ * in parallel.
+ */
+class cmTryCompileBatchCommand : public cmCoreTryCompile
+{
+public:
+  /**
+   * This is a virtual constructor for the command.
+   */
+  std::unique_ptr<cmCommand> Clone() override
+  {
+    return cm::make_unique<cmTryCompileBatchCommand>();
+  }
+
+  /**
+   * This is called when the command is first encountered in
+   * the CMakeLists.txt file.
+   */
+  bool InitialPass(std::vector<std::string> const& args,
+                   cmExecutionStatus& status) override;
+
+  /**
+   * Make reading the result variable of a queued check build the
+   * checks queued so far, so that code reading it before END still
+   * sees the right value.
+   */
+  static void WatchQueuedResult(cmMakefile& mf, std::string const& var);
+
+private:
+  static void QueuedResultAccessed(const std::string& variable,
+                                   int access_type, void* client_data,
+                                   const char* newValue,
+                                   const cmMakefile* mf);
+
+  bool HandleBegin(std::vector<std::string> const& args);
+  bool HandleQueue(std::vector<std::string> const& args);
+  bool HandleCall(std::vector<std::string> const& args,
+                  cmExecutionStatus& status);
+  bool HandleEnd(std::vector<std::string> const& args);
+  void BuildQueuedChecks(cmTryCompileBatch& batch);
+};
+
+#endif
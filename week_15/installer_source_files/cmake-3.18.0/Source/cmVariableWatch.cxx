@@ -3,6 +3,7 @@
 #include "cmVariableWatch.h"
 
 #include <array>
+#include <cstddef>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -32,6 +33,9 @@ bool cmVariableWatch::AddWatch(const std::string& variable, WatchMethod method,
   p->ClientData = client_data;
   p->DeleteDataCall = delete_data;
   cmVariableWatch::VectorOfPairs& vp = this->WatchMap[variable];
+  std::size_t const h = FilterHash(variable);
+  this->Filter.set(h % this->Filter.size());
+  this->Filter.set((h / this->Filter.size()) % this->Filter.size());
   for (auto& pair : vp) {
     if (pair->Method == method && client_data &&
         client_data == pair->ClientData) {
@@ -62,9 +66,9 @@ void cmVariableWatch::RemoveWatch(const std::string& variable,
   }
 }
 
-bool cmVariableWatch::VariableAccessed(const std::string& variable,
-                                       int access_type, const char* newValue,
-                                       const cmMakefile* mf) const
+bool cmVariableWatch::CallWatches(const std::string& variable,
+                                  int access_type, const char* newValue,
+                                  const cmMakefile* mf) const
 {
   auto mit = this->WatchMap.find(variable);
   if (mit != this->WatchMap.end()) {
@@ -84,3 +88,9 @@ bool cmVariableWatch::VariableAccessed(const std::string& variable,
   }
   return false;
 }
+
+bool cmVariableWatch::HasWatches(const std::string& variable) const
+{
+  auto mit = this->WatchMap.find(variable);
+  return mit != this->WatchMap.end() && !mit->second.empty();
+}
@@ -5,6 +5,9 @@
 
 #include "cmConfigure.h" // IWYU pragma: keep
 
+#include <bitset>
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -39,7 +42,19 @@ public:
    * This method is called when variable is accessed
    */
   bool VariableAccessed(const std::string& variable, int access_type,
-                        const char* newValue, const cmMakefile* mf) const;
+                        const char* newValue, const cmMakefile* mf) const
+  {
+    return this->MayBeWatched(variable) &&
+      this->CallWatches(variable, access_type, newValue, mf);
+  }
+
+  /**
+   * Whether any watch is registered for the variable
+   */
+  bool IsWatched(const std::string& variable) const
+  {
+    return this->MayBeWatched(variable) && this->HasWatches(variable);
+  }
 
   /**
    * Different access types.
@@ -79,7 +94,32 @@ protected:
   using VectorOfPairs = std::vector<std::shared_ptr<Pair>>;
   using StringToVectorOfPairs = std::map<std::string, VectorOfPairs>;
 
+  // Bloom filter over the keys of WatchMap.  It is consulted before the
+  // map so that accesses to variables nobody watches only cost a hash.
+  // Keys are never erased from WatchMap, so bits are never cleared.
+  using FilterBits = std::bitset<1024>;
+
+  static std::size_t FilterHash(const std::string& variable)
+  {
+    return std::hash<std::string>()(variable);
+  }
+
+  bool MayBeWatched(const std::string& variable) const
+  {
+    if (this->WatchMap.empty()) {
+      return false;
+    }
+    std::size_t const h = FilterHash(variable);
+    return this->Filter.test(h % this->Filter.size()) &&
+      this->Filter.test((h / this->Filter.size()) % this->Filter.size());
+  }
+
+  bool CallWatches(const std::string& variable, int access_type,
+                   const char* newValue, const cmMakefile* mf) const;
+  bool HasWatches(const std::string& variable) const;
+
   StringToVectorOfPairs WatchMap;
+  FilterBits Filter;
 };
 
 #endif
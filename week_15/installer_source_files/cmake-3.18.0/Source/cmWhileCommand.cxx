@@ -75,8 +75,8 @@ bool cmWhileFunctionBlocker::Replay(std::vector<cmListFileFunction> functions,
   cmConditionEvaluator conditionEvaluator(mf, this->GetStartingContext(),
                                           mf.GetBacktrace(commandContext));
 
-  bool isTrue =
-    conditionEvaluator.IsTrue(expandedArguments, errorString, messageType);
+  bool isTrue = conditionEvaluator.IsTrue(expandedArguments, errorString,
+                                          messageType, this->Args);
 
   while (isTrue) {
     if (!errorString.empty()) {
@@ -117,8 +117,8 @@ bool cmWhileFunctionBlocker::Replay(std::vector<cmListFileFunction> functions,
     }
     expandedArguments.clear();
     mf.ExpandArguments(this->Args, expandedArguments);
-    isTrue =
-      conditionEvaluator.IsTrue(expandedArguments, errorString, messageType);
+    isTrue = conditionEvaluator.IsTrue(expandedArguments, errorString,
+                                       messageType, this->Args);
   }
   return true;
 }
@@ -35,6 +35,7 @@
 #include "cmExternalMakefileProjectGenerator.h"
 #include "cmFileTimeCache.h"
 #include "cmGeneratorTarget.h"
+#include "cmGlobVerificationManager.h"
 #include "cmGlobalGenerator.h"
 #include "cmGlobalGeneratorFactory.h"
 #include "cmLinkLineComputer.h"
@@ -42,8 +43,10 @@
 #include "cmMakefile.h"
 #if !defined(CMAKE_BOOTSTRAP)
 #  include "cmMakefileProfilingData.h"
+#  include "cmMakefileProfilingSampler.h"
 #endif
 #include "cmMessenger.h"
+#include "cmRegularExpressionCache.h"
 #include "cmState.h"
 #include "cmStateDirectory.h"
 #include "cmStringAlgorithms.h"
@@ -59,8 +62,10 @@
 
 #  include <cm3p/json/writer.h>
 
+#  include "cmBinaryTraceWriter.h"
 #  include "cmFileAPI.h"
 #  include "cmGraphVizWriter.h"
+#  include "cmListFileDiskCache.h"
 #  include "cmVariableWatch.h"
 #endif
 
@@ -150,6 +155,7 @@ static void cmWarnUnusedCliWarning(const std::string& variable, int /*unused*/,
 
 cmake::cmake(Role role, cmState::Mode mode)
   : FileTimeCache(cm::make_unique<cmFileTimeCache>())
+  , RegularExpressionCache(cm::make_unique<cmRegularExpressionCache>())
 #ifndef CMAKE_BOOTSTRAP
   , VariableWatch(cm::make_unique<cmVariableWatch>())
 #endif
@@ -627,6 +633,7 @@ void cmake::SetArgs(const std::vector<std::string>& args)
 #if !defined(CMAKE_BOOTSTRAP)
   std::string profilingFormat;
   std::string profilingOutput;
+  std::string profilingSample;
 #endif
   for (unsigned int i = 1; i < args.size(); ++i) {
     std::string const& arg = args[i];
@@ -758,7 +765,7 @@ void cmake::SetArgs(const std::vector<std::string>& args)
         StringToTraceFormat(arg.substr(strlen("--trace-format=")));
       if (traceFormat == TraceFormat::TRACE_UNDEFINED) {
         cmSystemTools::Error("Invalid format specified for --trace-format. "
-                             "Valid formats are human, json-v1.");
+                             "Valid formats are human, json-v1, binary-v1.");
         return;
       }
       this->SetTraceFormat(traceFormat);
@@ -852,6 +859,13 @@ void cmake::SetArgs(const std::vector<std::string>& args)
       if (profilingFormat.empty()) {
         cmSystemTools::Error("No format specified for --profiling-format");
       }
+    } else if (arg == "--profiling-sample"_s) {
+      profilingSample = "1000";
+    } else if (cmHasLiteralPrefix(arg, "--profiling-sample=")) {
+      profilingSample = arg.substr(strlen("--profiling-sample="));
+      if (profilingSample.empty()) {
+        cmSystemTools::Error("No interval specified for --profiling-sample");
+      }
     } else if (cmHasLiteralPrefix(arg, "--profiling-output")) {
       profilingOutput = arg.substr(strlen("--profiling-output="));
       profilingOutput = cmSystemTools::CollapseFullPath(profilingOutput);
@@ -878,25 +892,73 @@ void cmake::SetArgs(const std::vector<std::string>& args)
   }
 
 #if !defined(CMAKE_BOOTSTRAP)
-  if (!profilingOutput.empty() || !profilingFormat.empty()) {
+  if (this->GetTraceFormat() == TraceFormat::TRACE_BINARY_V1) {
+    if (!this->TraceFile) {
+      cmSystemTools::Error(
+        "--trace-format=binary-v1 requires a --trace-redirect file.");
+      return;
+    }
+    // The writer thread owns the file from here on.
+    this->TraceFile.close();
+    this->BinaryTraceWriter = cm::make_unique<cmBinaryTraceWriter>();
+    if (!this->BinaryTraceWriter->Open(this->TraceFilePath)) {
+      this->BinaryTraceWriter.reset();
+      cmSystemTools::Error(cmStrCat("Error opening trace file ",
+                                    this->TraceFilePath, ": ",
+                                    cmSystemTools::GetLastSystemError()));
+      return;
+    }
+  }
+
+  if (!profilingSample.empty()) {
+    unsigned long interval = 0;
+    if (!cmStrToULong(profilingSample, &interval) || interval == 0) {
+      cmSystemTools::Error(
+        cmStrCat("Invalid interval specified for --profiling-sample: ",
+                 profilingSample));
+      return;
+    }
+    if (profilingOutput.empty()) {
+      cmSystemTools::Error(
+        "--profiling-sample specified but no --profiling-output!");
+      return;
+    }
+    if (!profilingFormat.empty() && profilingFormat != "folded"_s) {
+      cmSystemTools::Error(
+        "--profiling-sample only supports --profiling-format=folded");
+      return;
+    }
+    try {
+      this->ProfilingSampler = cm::make_unique<cmMakefileProfilingSampler>(
+        profilingOutput, std::chrono::microseconds(interval));
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(cmStrCat("Could not start profiling: ", e.what()));
+      return;
+    }
+  } else if (!profilingOutput.empty() || !profilingFormat.empty()) {
     if (profilingOutput.empty()) {
       cmSystemTools::Error(
         "--profiling-format specified but no --profiling-output!");
       return;
     }
+    cmMakefileProfilingData::Format format;
     if (profilingFormat == "google-trace"_s) {
-      try {
-        this->ProfilingOutput =
-          cm::make_unique<cmMakefileProfilingData>(profilingOutput);
-      } catch (std::runtime_error& e) {
-        cmSystemTools::Error(
-          cmStrCat("Could not start profiling: ", e.what()));
-        return;
-      }
+      format = cmMakefileProfilingData::Format::GoogleTrace;
+    } else if (profilingFormat == "aggregate"_s) {
+      format = cmMakefileProfilingData::Format::Aggregate;
+    } else if (profilingFormat == "folded"_s) {
+      format = cmMakefileProfilingData::Format::Folded;
     } else {
       cmSystemTools::Error("Invalid format specified for --profiling-format");
       return;
     }
+    try {
+      this->ProfilingOutput =
+        cm::make_unique<cmMakefileProfilingData>(profilingOutput, format);
+    } catch (std::runtime_error& e) {
+      cmSystemTools::Error(cmStrCat("Could not start profiling: ", e.what()));
+      return;
+    }
   }
 #endif
 
@@ -945,6 +1007,7 @@ cmake::TraceFormat cmake::StringToTraceFormat(const std::string& traceStr)
   static const std::vector<TracePair> levels = {
     { "human", TraceFormat::TRACE_HUMAN },
     { "json-v1", TraceFormat::TRACE_JSON_V1 },
+    { "binary-v1", TraceFormat::TRACE_BINARY_V1 },
   };
 
   const auto traceStrLowCase = cmSystemTools::LowerCase(traceStr);
@@ -958,6 +1021,7 @@ cmake::TraceFormat cmake::StringToTraceFormat(const std::string& traceStr)
 
 void cmake::SetTraceFile(const std::string& file)
 {
+  this->TraceFilePath = file;
   this->TraceFile.close();
   this->TraceFile.open(file.c_str());
   if (!this->TraceFile) {
@@ -993,6 +1057,8 @@ void cmake::PrintTraceFormatVersion()
       break;
     }
     case TraceFormat::TRACE_HUMAN:
+    case TraceFormat::TRACE_BINARY_V1:
+      // The binary trace file starts with its own header.
       msg = "";
       break;
     case TraceFormat::TRACE_UNDEFINED:
@@ -1647,10 +1713,25 @@ int cmake::ActualConfigure()
 #if !defined(CMAKE_BOOTSTRAP)
   this->FileAPI = cm::make_unique<cmFileAPI>(this);
   this->FileAPI->ReadQueries();
+
+  // Reuse list files parsed by previous runs in this build tree.
+  // Try-compile projects are thrown away, so do not bother for them.
+  if (!this->State->GetIsInTryCompile()) {
+    this->ListFileDiskCache = cm::make_unique<cmListFileDiskCache>(cmStrCat(
+      this->GetHomeOutputDirectory(), "/CMakeFiles/ListFileCache.bin"));
+    this->ListFileDiskCache->Load();
+  }
 #endif
 
   // actually do the configure
   this->GlobalGenerator->Configure();
+
+#if !defined(CMAKE_BOOTSTRAP)
+  if (this->ListFileDiskCache) {
+    this->ListFileDiskCache->Save();
+    this->ListFileDiskCache.reset();
+  }
+#endif
   // Before saving the cache
   // if the project did not define one of the entries below, add them now
   // so users can edit the values in the cache:
@@ -1953,6 +2034,11 @@ std::string const& cmake::GetGlobVerifyScript() const
   return this->State->GetGlobVerifyScript();
 }
 
+std::string const& cmake::GetGlobVerifyState() const
+{
+  return this->State->GetGlobVerifyState();
+}
+
 std::string const& cmake::GetGlobVerifyStamp() const
 {
   return this->State->GetGlobVerifyStamp();
@@ -2766,7 +2852,10 @@ int cmake::Build(int jobs, const std::string& dir,
     if (this->GlobalGenerator->MatchesGeneratorName("Visual Studio 9 2008")) {
       std::string const globVerifyScript =
         cachePath + "/" + "CMakeFiles/" + "VerifyGlobs.cmake";
-      if (cmSystemTools::FileExists(globVerifyScript)) {
+      std::string const globVerifyState =
+        cachePath + "/" + "CMakeFiles/" + "VerifyGlobs.state";
+      if (cmSystemTools::FileExists(globVerifyScript) &&
+          !cmGlobVerificationManager::VerifyGlobs(globVerifyState)) {
         std::vector<std::string> args;
         this->ReadListFile(args, globVerifyScript);
       }
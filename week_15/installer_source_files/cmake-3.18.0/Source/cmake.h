@@ -38,9 +38,13 @@ class cmGlobalGenerator;
 class cmGlobalGeneratorFactory;
 class cmMakefile;
 #if !defined(CMAKE_BOOTSTRAP)
+class cmBinaryTraceWriter;
+class cmListFileDiskCache;
 class cmMakefileProfilingData;
+class cmMakefileProfilingSampler;
 #endif
 class cmMessenger;
+class cmRegularExpressionCache;
 class cmVariableWatch;
 struct cmDocumentationEntry;
 
@@ -125,6 +129,7 @@ public:
     TRACE_UNDEFINED,
     TRACE_HUMAN,
     TRACE_JSON_V1,
+    TRACE_BINARY_V1,
   };
 
   struct GeneratorInfo
@@ -317,6 +322,7 @@ public:
 
   bool DoWriteGlobVerifyTarget() const;
   std::string const& GetGlobVerifyScript() const;
+  std::string const& GetGlobVerifyState() const;
   std::string const& GetGlobVerifyStamp() const;
   void AddGlobCacheEntry(bool recurse, bool listDirectories,
                          bool followSymlinks, const std::string& relative,
@@ -401,6 +407,24 @@ public:
    */
   cmFileTimeCache* GetFileTimeCache() { return this->FileTimeCache.get(); }
 
+  /**
+   * Get the cache of compiled regular expressions
+   */
+  cmRegularExpressionCache* GetRegularExpressionCache()
+  {
+    return this->RegularExpressionCache.get();
+  }
+
+#if !defined(CMAKE_BOOTSTRAP)
+  /**
+   * Get the persistent cache of parsed list files, if configuring.
+   */
+  cmListFileDiskCache* GetListFileDiskCache()
+  {
+    return this->ListFileDiskCache.get();
+  }
+#endif
+
   bool WasLogLevelSetViaCLI() const { return this->LogLevelWasSetViaCLI; }
 
   //! Get the selected log level for `message()` commands during the cmake run.
@@ -457,6 +481,12 @@ public:
   }
   cmGeneratedFileStream& GetTraceFile() { return this->TraceFile; }
   void SetTraceFile(std::string const& file);
+#if !defined(CMAKE_BOOTSTRAP)
+  cmBinaryTraceWriter* GetBinaryTraceWriter() const
+  {
+    return this->BinaryTraceWriter.get();
+  }
+#endif
   void PrintTraceFormatVersion();
 
   bool GetWarnUninitialized() { return this->WarnUninitialized; }
@@ -558,6 +588,10 @@ public:
 #if !defined(CMAKE_BOOTSTRAP)
   cmMakefileProfilingData& GetProfilingOutput();
   bool IsProfilingEnabled() const;
+  cmMakefileProfilingSampler* GetProfilingSampler() const
+  {
+    return this->ProfilingSampler.get();
+  }
 #endif
 
 protected:
@@ -615,6 +649,7 @@ private:
   bool TraceExpand = false;
   TraceFormat TraceFormatVar = TRACE_HUMAN;
   cmGeneratedFileStream TraceFile;
+  std::string TraceFilePath;
   bool WarnUninitialized = false;
   bool WarnUnused = false;
   bool WarnUnusedCli = true;
@@ -636,12 +671,15 @@ private:
   bool DebugTryCompile = false;
   bool RegenerateDuringBuild = false;
   std::unique_ptr<cmFileTimeCache> FileTimeCache;
+  std::unique_ptr<cmRegularExpressionCache> RegularExpressionCache;
   std::string GraphVizFile;
   InstalledFilesMap InstalledFiles;
 
 #if !defined(CMAKE_BOOTSTRAP)
   std::unique_ptr<cmVariableWatch> VariableWatch;
   std::unique_ptr<cmFileAPI> FileAPI;
+  std::unique_ptr<cmListFileDiskCache> ListFileDiskCache;
+  std::unique_ptr<cmBinaryTraceWriter> BinaryTraceWriter;
 #endif
 
   std::unique_ptr<cmState> State;
@@ -671,6 +709,7 @@ private:
 
 #if !defined(CMAKE_BOOTSTRAP)
   std::unique_ptr<cmMakefileProfilingData> ProfilingOutput;
+  std::unique_ptr<cmMakefileProfilingSampler> ProfilingSampler;
 #endif
 };
 
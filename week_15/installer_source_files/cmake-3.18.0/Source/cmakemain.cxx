@@ -99,10 +99,13 @@ const char* cmDocumentationOptions[][2] = {
 #  if !defined(CMAKE_BOOTSTRAP)
   { "--profiling-format=<fmt>",
     "Output data for profiling CMake scripts. Supported formats: "
-    "google-trace" },
+    "google-trace, aggregate, folded" },
   { "--profiling-output=<file>",
     "Select an output path for the profiling data enabled through "
-    "--profiling-format." },
+    "--profiling-format or --profiling-sample." },
+  { "--profiling-sample[=<interval>]",
+    "Sample the CMake script call stack every <interval> microseconds "
+    "and output the counts in the folded format." },
 #  endif
   { nullptr, nullptr }
 };
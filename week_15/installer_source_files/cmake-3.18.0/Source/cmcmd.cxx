@@ -8,6 +8,7 @@
 #include <fcntl.h>
 
 #include "cmDuration.h"
+#include "cmGlobVerificationManager.h"
 #include "cmGlobalGenerator.h"
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
@@ -25,6 +26,7 @@
 #include "cmake.h"
 
 #if !defined(CMAKE_BOOTSTRAP)
+#  include "cmBinaryTraceWriter.h"
 #  include "cmDependsFortran.h" // For -E cmake_copy_f90_mod callback.
 #  include "cmFileTime.h"
 #  include "cmServer.h"
@@ -92,6 +94,8 @@ void CMakeCommandUsage(const char* program)
     << "  chdir dir cmd [args...]   - run command in a given directory\n"
     << "  compare_files [--ignore-eol] file1 file2\n"
     << "                              - check if file1 is same as file2\n"
+    << "  convert_trace <binary-trace> [<json-trace>]\n"
+    << "                            - convert a binary-v1 trace to json-v1\n"
     << "  copy <file>... destination  - copy files to destination "
        "(either file or directory)\n"
     << "  copy_directory <dir>... destination   - copy content of <dir>... "
@@ -594,6 +598,29 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args)
     }
 
 #if !defined(CMAKE_BOOTSTRAP)
+    // Convert a binary trace to the json-v1 trace format
+    if (args[1] == "convert_trace" &&
+        (args.size() == 3 || args.size() == 4)) {
+      std::string error;
+      bool converted;
+      if (args.size() == 4) {
+        cmsys::ofstream fout(args[3].c_str());
+        if (!fout) {
+          std::cerr << "convert_trace: cannot write " << args[3] << "\n";
+          return 1;
+        }
+        converted = cmBinaryTraceWriter::ConvertToJson(args[2], fout, error);
+      } else {
+        converted =
+          cmBinaryTraceWriter::ConvertToJson(args[2], std::cout, error);
+      }
+      if (!converted) {
+        std::cerr << "convert_trace: " << error << "\n";
+        return 1;
+      }
+      return 0;
+    }
+
     if (args[1] == "__create_def") {
       if (args.size() < 4) {
         std::cerr << "__create_def Usage: -E __create_def outfile.def "
@@ -1136,6 +1163,21 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string> const& args)
       return cmcmd::ExecuteLinkScript(args);
     }
 
+    // Internal CMake glob verification support.
+    if (args[1] == "cmake_verify_globs" && args.size() == 4) {
+      if (cmGlobVerificationManager::VerifyGlobs(args[2])) {
+        return 0;
+      }
+      // The saved state cannot be used.  Run the verification script.
+      int ret = 0;
+      if (!cmSystemTools::RunSingleCommand(
+            { cmSystemTools::GetCMakeCommand(), "-P", args[3] }, nullptr,
+            nullptr, &ret, nullptr, cmSystemTools::OUTPUT_PASSTHROUGH)) {
+        return 1;
+      }
+      return ret;
+    }
+
 #ifndef CMAKE_BOOTSTRAP
     // Internal CMake ninja dependency scanning support.
     if (args[1] == "cmake_ninja_depends") {
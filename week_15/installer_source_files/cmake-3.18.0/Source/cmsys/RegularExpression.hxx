@@ -399,6 +399,25 @@ public:
    */
   inline void set_invalid();
 
+  /**
+   * Algorithms available to find().  Backtracking tries one alternative
+   * at a time and may take time exponential in the length of the input
+   * for some expressions.  Linear advances all alternatives in lockstep
+   * and takes time linear in the length of the input.  Both accept the
+   * same expressions and report the same matches and subexpressions.
+   */
+  enum Engine
+  {
+    Backtracking,
+    Linear
+  };
+
+  /**
+   * Select the algorithm used by find().  The default is Backtracking.
+   */
+  inline void set_engine(Engine);
+  inline Engine get_engine() const;
+
 private:
   RegularExpressionMatch regmatch;
   char regstart;                  // Internal use only
@@ -407,6 +426,7 @@ private:
   std::string::size_type regmlen; // Internal use only
   char* program;
   int progsize;
+  Engine engine;
 };
 
 /**
@@ -418,6 +438,7 @@ inline RegularExpression::RegularExpression()
   , regmust{}
   , program{ nullptr }
   , progsize{}
+  , engine{ Backtracking }
 {
 }
 
@@ -431,6 +452,7 @@ inline RegularExpression::RegularExpression(const char* s)
   , regmust{}
   , program{ nullptr }
   , progsize{}
+  , engine{ Backtracking }
 {
   if (s) {
     this->compile(s);
@@ -447,6 +469,7 @@ inline RegularExpression::RegularExpression(const std::string& s)
   , regmust{}
   , program{ nullptr }
   , progsize{}
+  , engine{ Backtracking }
 {
   this->compile(s);
 }
@@ -562,6 +585,22 @@ inline void RegularExpression::set_invalid()
   this->program = nullptr;
 }
 
+/**
+ * Select the algorithm used by find().
+ */
+inline void RegularExpression::set_engine(Engine e)
+{
+  this->engine = e;
+}
+
+/**
+ * Returns the algorithm used by find().
+ */
+inline RegularExpression::Engine RegularExpression::get_engine() const
+{
+  return this->engine;
+}
+
 } // namespace cmsys
 
 #endif
@@ -30,11 +30,13 @@
 
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 namespace KWSYS_NAMESPACE {
 
 // RegularExpression -- Copies the given regular expression.
 RegularExpression::RegularExpression(const RegularExpression& rxp)
+  : engine(rxp.engine)
 {
   if (!rxp.program) {
     this->program = nullptr;
@@ -68,6 +70,7 @@ RegularExpression& RegularExpression::operator=(const RegularExpression& rxp)
   if (this == &rxp) {
     return *this;
   }
+  this->engine = rxp.engine;
   if (!rxp.program) {
     this->program = nullptr;
     return *this;
@@ -854,6 +857,52 @@ public:
   int regrepeat(const char*);
 };
 
+/*
+ * Utility class for RegularExpression::find() with the Linear engine.
+ *
+ * This is a Thompson NFA simulation over the same program that RegExpFind
+ * interprets (a "Pike VM").  A thread is a position in the program at
+ * which a character is to be consumed, together with the subexpression
+ * boundaries seen on the way there.  All threads advance over the input
+ * in lockstep.  Threads are kept in the order RegExpFind would try the
+ * corresponding alternatives, and a thread reaching a state that a higher
+ * priority thread already occupies is dropped, so the first thread to
+ * reach END is the match RegExpFind would have found.  STAR and PLUS
+ * prefer another repetition over leaving the loop, as regrepeat's
+ * greedy backing up does.  A subexpression that is entered several times
+ * reports its last iteration, like the "already set" checks in regmatch.
+ */
+class RegExpLinearFind
+{
+public:
+  RegExpLinearFind(const char* prog, int progsize, const char* bol);
+
+  bool find(bool anchored, const char** start, const char** end);
+
+private:
+  struct Thread
+  {
+    const char* node; // ANY, ANYOF, ANYBUT, EXACTLY, STAR or PLUS node.
+    size_t offset;    // Characters of an EXACTLY operand already matched.
+    const char* startp[RegularExpressionMatch::NSUBEXP];
+    const char* endp[RegularExpressionMatch::NSUBEXP];
+  };
+
+  void add(std::vector<Thread>& list, const char* scan, Thread& t,
+           const char* input);
+  void addRepeat(std::vector<Thread>& list, const char* scan, Thread& t,
+                 const char* input);
+  void addState(std::vector<Thread>& list, size_t id, const char* node,
+                size_t offset, Thread const& t);
+  static bool consumes(const char* node, char c);
+
+  const char* program;
+  const char* regbol;
+  std::vector<unsigned int> visited; // Generation of last visit per id.
+  unsigned int generation;
+  bool matched;
+};
+
 // find -- Matches the regular expression to the given string.
 // Returns true if found, and sets start and end indexes accordingly.
 bool RegularExpression::find(char const* string,
@@ -888,6 +937,11 @@ bool RegularExpression::find(char const* string,
       return false;
   }
 
+  if (this->engine == Linear) {
+    RegExpLinearFind regFind(this->program, this->progsize, string);
+    return regFind.find(this->reganch != 0, rmatch.startp, rmatch.endp);
+  }
+
   RegExpFind regFind;
 
   // Mark beginning of line for ^ .
@@ -1177,6 +1231,209 @@ int RegExpFind::regrepeat(const char* p)
   return (count);
 }
 
+RegExpLinearFind::RegExpLinearFind(const char* prog, int progsize,
+                                   const char* bol)
+  : program(prog)
+  , regbol(bol)
+  , visited(static_cast<size_t>(progsize), 0)
+  , generation(0)
+  , matched(false)
+{
+}
+
+bool RegExpLinearFind::find(bool anchored, const char** start,
+                            const char** end)
+{
+  std::vector<Thread> clist;
+  std::vector<Thread> nlist;
+  Thread initial;
+  for (int i = 0; i < RegularExpressionMatch::NSUBEXP; ++i) {
+    initial.startp[i] = nullptr;
+    initial.endp[i] = nullptr;
+  }
+
+  const char* input = this->regbol;
+  ++this->generation;
+  for (;;) {
+    // A new attempt starting here has lower priority than all attempts
+    // that started earlier.
+    if (!this->matched && (!anchored || input == this->regbol)) {
+      Thread t = initial;
+      t.startp[0] = input;
+      this->add(clist, this->program + 1, t, input);
+    }
+    if (clist.empty()) {
+      if (this->matched || anchored || *input == '\0') {
+        break;
+      }
+      ++this->generation;
+      ++input;
+      continue;
+    }
+
+    ++this->generation;
+    nlist.clear();
+    char c = *input;
+    for (Thread& t : clist) {
+      if (OP(t.node) == END) {
+        // Lower priority threads cannot produce the reported match.
+        this->matched = true;
+        for (int i = 0; i < RegularExpressionMatch::NSUBEXP; ++i) {
+          start[i] = t.startp[i];
+          end[i] = t.endp[i];
+        }
+        end[0] = input;
+        break;
+      }
+      if (c == '\0') {
+        continue;
+      }
+      switch (OP(t.node)) {
+        case EXACTLY: {
+          const char* opnd = OPERAND(t.node);
+          if (opnd[t.offset] != c) {
+            break;
+          }
+          if (opnd[t.offset + 1] != '\0') {
+            size_t offset = t.offset + 1;
+            this->addState(nlist,
+                           static_cast<size_t>(opnd - this->program) + offset,
+                           t.node, offset, t);
+          } else {
+            this->add(nlist, regnext(t.node), t, input + 1);
+          }
+        } break;
+        case STAR:
+        case PLUS:
+          if (consumes(OPERAND(t.node), c)) {
+            this->addRepeat(nlist, t.node, t, input + 1);
+          }
+          break;
+        default:
+          if (consumes(t.node, c)) {
+            this->add(nlist, regnext(t.node), t, input + 1);
+          }
+          break;
+      }
+    }
+    clist.swap(nlist);
+    if (c == '\0') {
+      break;
+    }
+    ++input;
+  }
+  return this->matched;
+}
+
+// Follow the nodes that do not consume input from scan, adding a thread
+// for each state reached in priority order.  The thread is modified.
+void RegExpLinearFind::add(std::vector<Thread>& list, const char* scan,
+                           Thread& t, const char* input)
+{
+  while (scan != nullptr) {
+    size_t id = static_cast<size_t>(scan - this->program);
+    if (this->visited[id] == this->generation) {
+      return;
+    }
+    this->visited[id] = this->generation;
+
+    switch (OP(scan)) {
+      case BOL:
+        if (input != this->regbol) {
+          return;
+        }
+        break;
+      case EOL:
+        if (*input != '\0') {
+          return;
+        }
+        break;
+      case NOTHING:
+      case BACK:
+        break;
+      case BRANCH: {
+        const char* next = regnext(scan);
+        if (next == nullptr || OP(next) != BRANCH) {
+          scan = OPERAND(scan);
+          continue;
+        }
+        for (; scan != nullptr && OP(scan) == BRANCH; scan = regnext(scan)) {
+          Thread alternative = t;
+          this->add(list, OPERAND(scan), alternative, input);
+        }
+        return;
+      }
+      case STAR:
+        this->addRepeat(list, scan, t, input);
+        return;
+      case PLUS:
+      case ANY:
+      case ANYOF:
+      case ANYBUT:
+      case EXACTLY:
+      case END:
+        // Use the node itself as the state, it was just marked visited.
+        list.push_back(t);
+        list.back().node = scan;
+        list.back().offset = 0;
+        return;
+      default: {
+        int op = OP(scan);
+        if (op > OPEN && op < OPEN + RegularExpressionMatch::NSUBEXP) {
+          t.startp[op - OPEN] = input;
+        } else if (op > CLOSE &&
+                   op < CLOSE + RegularExpressionMatch::NSUBEXP) {
+          t.endp[op - CLOSE] = input;
+        } else {
+          printf("RegularExpression::find(): Internal error -- memory "
+                 "corrupted.\n");
+          return;
+        }
+      } break;
+    }
+    scan = regnext(scan);
+  }
+}
+
+// At a STAR or PLUS node after at least one repetition: prefer another
+// repetition, then continue after the loop.
+void RegExpLinearFind::addRepeat(std::vector<Thread>& list, const char* scan,
+                                 Thread& t, const char* input)
+{
+  this->addState(list, static_cast<size_t>(OPERAND(scan) - this->program),
+                 scan, 0, t);
+  this->add(list, regnext(scan), t, input);
+}
+
+void RegExpLinearFind::addState(std::vector<Thread>& list, size_t id,
+                                const char* node, size_t offset,
+                                Thread const& t)
+{
+  if (this->visited[id] == this->generation) {
+    return;
+  }
+  this->visited[id] = this->generation;
+  list.push_back(t);
+  list.back().node = node;
+  list.back().offset = offset;
+}
+
+bool RegExpLinearFind::consumes(const char* node, char c)
+{
+  switch (OP(node)) {
+    case ANY:
+      return true;
+    case EXACTLY:
+      return *OPERAND(node) == c;
+    case ANYOF:
+      return strchr(OPERAND(node), c) != nullptr;
+    case ANYBUT:
+      return strchr(OPERAND(node), c) == nullptr;
+    default:
+      return false;
+  }
+}
+
 /*
  - regnext - dig the "next" pointer out of a node
  */
@@ -0,0 +1,164 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "cmDefinitions.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+static bool hasValue(cmDefinitions const& defs, std::string const& key,
+                     std::string const& value)
+{
+  std::string const* def = defs.Get(key);
+  return def && *def == value;
+}
+
+static std::vector<std::string> sorted(std::vector<std::string> keys)
+{
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+static bool testCopyOnWrite()
+{
+  std::cout << "testCopyOnWrite()\n";
+  // Enough keys to share slots, so that sets copy nested nodes.
+  cmDefinitions parent;
+  for (int i = 0; i < 1000; ++i) {
+    parent.Set("key" + std::to_string(i), std::to_string(i));
+  }
+
+  cmDefinitions child = parent.MakeChild();
+  for (int i = 0; i < 1000; i += 2) {
+    child.Set("key" + std::to_string(i), "child");
+  }
+  child.Set("child_only", "1");
+  parent.Set("parent_only", "1");
+  parent.Set("key1", "parent");
+
+  for (int i = 2; i < 1000; ++i) {
+    std::string const key = "key" + std::to_string(i);
+    ASSERT_TRUE(hasValue(parent, key, std::to_string(i)));
+    ASSERT_TRUE(hasValue(child, key, i % 2 ? std::to_string(i) : "child"));
+  }
+  ASSERT_TRUE(hasValue(parent, "key1", "parent"));
+  ASSERT_TRUE(hasValue(child, "key1", "1"));
+  ASSERT_TRUE(!parent.Get("child_only"));
+  ASSERT_TRUE(!child.Get("parent_only"));
+
+  // List elements are shared until one of the scopes changes them.
+  std::vector<std::string> const elements = { "a", "b" };
+  parent.Set("list", "x");
+  cmDefinitions listChild = parent.MakeChild();
+  ASSERT_TRUE(listChild.Append("list", elements.begin(), elements.end()));
+  ASSERT_TRUE(hasValue(listChild, "list", "x;a;b"));
+  ASSERT_TRUE(hasValue(parent, "list", "x"));
+  ASSERT_TRUE(listChild.PopBack("list", 2));
+  ASSERT_TRUE(hasValue(listChild, "list", "x"));
+  return true;
+}
+
+static bool testParentScope()
+{
+  std::cout << "testParentScope()\n";
+  // set(... PARENT_SCOPE) and unset(... PARENT_SCOPE) change the parent
+  // after the child was made from it.
+  cmDefinitions parent;
+  parent.Set("set", "old");
+  parent.Set("unset", "old");
+  cmDefinitions child = parent.MakeChild();
+
+  parent.Set("set", "new");
+  parent.Unset("unset");
+  ASSERT_TRUE(hasValue(parent, "set", "new"));
+  ASSERT_TRUE(!parent.Get("unset"));
+  ASSERT_TRUE(parent.HasKey("unset"));
+  ASSERT_TRUE(hasValue(child, "set", "old"));
+  ASSERT_TRUE(hasValue(child, "unset", "old"));
+  return true;
+}
+
+static bool testUnsetShadowsParent()
+{
+  std::cout << "testUnsetShadowsParent()\n";
+  cmDefinitions parent;
+  parent.Set("key", "parent");
+  cmDefinitions child = parent.MakeChild();
+  child.Unset("key");
+  ASSERT_TRUE(!child.Get("key"));
+  ASSERT_TRUE(child.HasKey("key"));
+  ASSERT_TRUE(hasValue(parent, "key", "parent"));
+
+  // A grandchild sees the unset, and may set the key again.
+  cmDefinitions grandchild = child.MakeChild();
+  ASSERT_TRUE(!grandchild.Get("key"));
+  grandchild.Set("key", "grandchild");
+  ASSERT_TRUE(hasValue(grandchild, "key", "grandchild"));
+  ASSERT_TRUE(!child.Get("key"));
+
+  // A directory does not consider keys unset by its parent initialized.
+  cmDefinitions closure = child.MakeClosure();
+  ASSERT_TRUE(!closure.Get("key"));
+  ASSERT_TRUE(!closure.HasKey("key"));
+  ASSERT_TRUE(closure.ClosureKeys().empty());
+  return true;
+}
+
+static bool testUnusedKeys()
+{
+  std::cout << "testUnusedKeys()\n";
+  cmDefinitions parent;
+  parent.Set("read_by_parent", "1");
+  parent.Set("read_by_directory", "1");
+  parent.Set("never_read", "1");
+  ASSERT_TRUE(parent.Get("read_by_parent"));
+
+  // A directory reports the unused values it inherited and its own.
+  cmDefinitions directory = parent.MakeClosure();
+  ASSERT_TRUE(directory.Get("read_by_directory"));
+  directory.Set("directory_never_read", "1");
+  ASSERT_TRUE(sorted(directory.UnusedKeys()) ==
+              sorted({ "directory_never_read", "never_read" }));
+
+  // A function scope only reports its own, and reading a value marks it
+  // used in the scope it comes from.
+  cmDefinitions function = directory.MakeChild();
+  function.Set("function_never_read", "1");
+  ASSERT_TRUE(function.Get("directory_never_read"));
+  ASSERT_TRUE(function.UnusedKeys() ==
+              std::vector<std::string>{ "function_never_read" });
+  ASSERT_TRUE(directory.UnusedKeys() ==
+              std::vector<std::string>{ "never_read" });
+
+  // Reads in the directory do not mark the values of its parent.
+  ASSERT_TRUE(sorted(parent.UnusedKeys()) ==
+              sorted({ "never_read", "read_by_directory" }));
+  return true;
+}
+
+int testDefinitions(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testCopyOnWrite()) {
+    return 1;
+  }
+  if (!testParentScope()) {
+    return 1;
+  }
+  if (!testUnsetShadowsParent()) {
+    return 1;
+  }
+  if (!testUnusedKeys()) {
+    return 1;
+  }
+  return 0;
+}
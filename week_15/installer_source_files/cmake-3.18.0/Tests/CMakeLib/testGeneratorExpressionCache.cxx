@@ -0,0 +1,173 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <cm/memory>
+
+#include "cmGeneratorExpression.h"
+#include "cmGeneratorTarget.h"
+#include "cmGlobalGenerator.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmState.h"
+#include "cmStateSnapshot.h"
+#include "cmStateTypes.h"
+#include "cmTarget.h"
+#include "cmake.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+namespace {
+// A project with the targets "first" and "second" and a local generator
+// to evaluate expressions with.
+struct Project
+{
+  Project()
+    : CMake(cmake::RoleProject, cmState::Project)
+  {
+    this->CMake.SetHomeDirectory("");
+    this->CMake.SetHomeOutputDirectory("");
+    this->CMake.GetCurrentSnapshot().SetDefaultDefinitions();
+    this->GlobalGenerator = cm::make_unique<cmGlobalGenerator>(&this->CMake);
+    this->Makefile = cm::make_unique<cmMakefile>(
+      this->GlobalGenerator.get(), this->CMake.GetCurrentSnapshot());
+    this->First = this->AddTarget("first");
+    this->Second = this->AddTarget("second");
+    this->LocalGenerator =
+      this->GlobalGenerator->CreateLocalGenerator(this->Makefile.get());
+    for (cmTarget* target : { this->First, this->Second }) {
+      this->LocalGenerator->AddGeneratorTarget(
+        cm::make_unique<cmGeneratorTarget>(target,
+                                           this->LocalGenerator.get()));
+    }
+  }
+
+  cmTarget* AddTarget(std::string const& name)
+  {
+    return this->Makefile->AddNewTarget(cmStateEnums::UTILITY, name);
+  }
+
+  cmGeneratorTarget const* Find(std::string const& name) const
+  {
+    return this->LocalGenerator->FindGeneratorTargetToUse(name);
+  }
+
+  std::string Evaluate(cmCompiledGeneratorExpression const& cge,
+                       std::string const& config,
+                       cmGeneratorTarget const* head = nullptr)
+  {
+    return cge.Evaluate(this->LocalGenerator.get(), config, head);
+  }
+
+  cmake CMake;
+  std::unique_ptr<cmGlobalGenerator> GlobalGenerator;
+  std::unique_ptr<cmMakefile> Makefile;
+  std::unique_ptr<cmLocalGenerator> LocalGenerator;
+  cmTarget* First;
+  cmTarget* Second;
+};
+}
+
+static bool testPropertyChange()
+{
+  std::cout << "testPropertyChange()\n";
+  Project project;
+  project.First->SetProperty("VALUE", "old");
+
+  cmGeneratorExpression ge;
+  auto cge = ge.Parse("$<TARGET_PROPERTY:first,VALUE>");
+  ASSERT_TRUE(project.Evaluate(*cge, "Debug") == "old");
+  ASSERT_TRUE(project.Evaluate(*cge, "Debug") == "old");
+
+  project.First->SetProperty("VALUE", "new");
+  ASSERT_TRUE(project.Evaluate(*cge, "Debug") == "new");
+
+  project.First->AppendProperty("VALUE", "appended");
+  ASSERT_TRUE(project.Evaluate(*cge, "Debug") == "new;appended");
+  return true;
+}
+
+static bool testEntryChange()
+{
+  std::cout << "testEntryChange()\n";
+  Project project;
+  project.First->InsertCompileOption("-old", cmListFileBacktrace());
+
+  cmGeneratorExpression ge;
+  auto cge = ge.Parse("$<TARGET_PROPERTY:first,COMPILE_OPTIONS>");
+  ASSERT_TRUE(project.Evaluate(*cge, "") == "-old");
+
+  project.First->InsertCompileOption("-new", cmListFileBacktrace(), true);
+  ASSERT_TRUE(project.Evaluate(*cge, "") == "-new;-old");
+  return true;
+}
+
+static bool testContexts()
+{
+  std::cout << "testContexts()\n";
+  Project project;
+  project.First->SetProperty("VALUE", "first");
+  project.Second->SetProperty("VALUE", "second");
+  cmGeneratorTarget const* first = project.Find("first");
+  cmGeneratorTarget const* second = project.Find("second");
+  ASSERT_TRUE(first && second);
+
+  cmGeneratorExpression ge;
+  auto config = ge.Parse("$<CONFIG>");
+  ASSERT_TRUE(project.Evaluate(*config, "Debug") == "Debug");
+  ASSERT_TRUE(project.Evaluate(*config, "Release") == "Release");
+  ASSERT_TRUE(project.Evaluate(*config, "Debug") == "Debug");
+
+  auto head = ge.Parse("$<TARGET_PROPERTY:VALUE>");
+  ASSERT_TRUE(project.Evaluate(*head, "", first) == "first");
+  ASSERT_TRUE(project.Evaluate(*head, "", second) == "second");
+  ASSERT_TRUE(project.Evaluate(*head, "", first) == "first");
+  return true;
+}
+
+static bool testInvalidate()
+{
+  std::cout << "testInvalidate()\n";
+  Project project;
+  cmGeneratorTarget const* first = project.Find("first");
+  ASSERT_TRUE(first);
+  project.Makefile->AddDefinition("CMAKE_C_COMPILER_ID", "Old");
+
+  cmGeneratorExpression ge;
+  auto cge = ge.Parse("$<C_COMPILER_ID>");
+  ASSERT_TRUE(project.Evaluate(*cge, "", first) == "Old");
+
+  // Variables may only change before generation starts, which drops the
+  // remembered results.
+  project.Makefile->AddDefinition("CMAKE_C_COMPILER_ID", "New");
+  ASSERT_TRUE(project.Evaluate(*cge, "", first) == "Old");
+  cmCompiledGeneratorExpression::InvalidateEvaluationCaches();
+  ASSERT_TRUE(project.Evaluate(*cge, "", first) == "New");
+  return true;
+}
+
+int testGeneratorExpressionCache(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testPropertyChange()) {
+    return 1;
+  }
+  if (!testEntryChange()) {
+    return 1;
+  }
+  if (!testContexts()) {
+    return 1;
+  }
+  if (!testInvalidate()) {
+    return 1;
+  }
+  return 0;
+}
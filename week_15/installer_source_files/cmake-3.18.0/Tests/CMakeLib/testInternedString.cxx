@@ -0,0 +1,134 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <cm/string_view>
+
+#include "cmInternedString.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+static bool testConstructDefault()
+{
+  std::cout << "testConstructDefault()\n";
+  cmInternedString str;
+  ASSERT_TRUE(str.empty());
+  ASSERT_TRUE(str.size() == 0);
+  ASSERT_TRUE(str.str().empty());
+  ASSERT_TRUE(str == cmInternedString(""));
+  ASSERT_TRUE(str == cmInternedString(std::string()));
+  ASSERT_TRUE(str == cmInternedString(static_cast<const char*>(nullptr)));
+  return true;
+}
+
+static bool testIdentity()
+{
+  std::cout << "testIdentity()\n";
+  std::string const value = "CMAKE_CURRENT_SOURCE_DIR";
+  cmInternedString a(value);
+  cmInternedString b{ cm::string_view(value) };
+  cmInternedString c(value.c_str());
+  ASSERT_TRUE(a == b);
+  ASSERT_TRUE(a == c);
+  ASSERT_TRUE(&a.str() == &b.str());
+  ASSERT_TRUE(a.str() == value);
+  ASSERT_TRUE(a.str().c_str() != value.c_str());
+  ASSERT_TRUE(a.hash() == std::hash<cm::string_view>{}(value));
+  ASSERT_TRUE(std::hash<cmInternedString>{}(a) == a.hash());
+
+  cmInternedString d("CMAKE_CURRENT_BINARY_DIR");
+  ASSERT_TRUE(a != d);
+  ASSERT_TRUE(d < a);
+  ASSERT_TRUE(!(a < d));
+  ASSERT_TRUE(!(a < a));
+  return true;
+}
+
+static bool testCompareStrings()
+{
+  std::cout << "testCompareStrings()\n";
+  cmInternedString a("abc");
+  std::string const s = "abc";
+  ASSERT_TRUE(a == s);
+  ASSERT_TRUE(s == a);
+  ASSERT_TRUE(a == "abc");
+  ASSERT_TRUE(a != "abd");
+  ASSERT_TRUE(a != std::string("ab"));
+  std::string const& ref = a;
+  ASSERT_TRUE(ref == s);
+  std::ostringstream os;
+  os << a;
+  ASSERT_TRUE(os.str() == s);
+  return true;
+}
+
+static bool testFind()
+{
+  std::cout << "testFind()\n";
+  cmInternedString result;
+  ASSERT_TRUE(!cmInternedString::Find("testFind-never-interned", result));
+  ASSERT_TRUE(result.empty());
+  cmInternedString a("testFind-interned");
+  ASSERT_TRUE(cmInternedString::Find("testFind-interned", result));
+  ASSERT_TRUE(result == a);
+  ASSERT_TRUE(cmInternedString::Find("", result));
+  ASSERT_TRUE(result == cmInternedString());
+  return true;
+}
+
+static bool testThreads()
+{
+  std::cout << "testThreads()\n";
+  std::vector<std::vector<cmInternedString>> results(4);
+  std::vector<std::thread> threads;
+  for (auto& result : results) {
+    threads.emplace_back([&result]() {
+      for (int i = 0; i < 1000; ++i) {
+        result.emplace_back("testThreads-" + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto const& result : results) {
+    ASSERT_TRUE(result == results.front());
+  }
+  std::unordered_set<cmInternedString> unique(results.front().begin(),
+                                              results.front().end());
+  ASSERT_TRUE(unique.size() == 1000);
+  return true;
+}
+
+int testInternedString(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testConstructDefault()) {
+    return 1;
+  }
+  if (!testIdentity()) {
+    return 1;
+  }
+  if (!testCompareStrings()) {
+    return 1;
+  }
+  if (!testFind()) {
+    return 1;
+  }
+  if (!testThreads()) {
+    return 1;
+  }
+  return 0;
+}
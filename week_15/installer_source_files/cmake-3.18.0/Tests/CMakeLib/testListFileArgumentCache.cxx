@@ -0,0 +1,111 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "cmExecutionStatus.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmMakefile.h"
+#include "cmState.h"
+#include "cmStateSnapshot.h"
+#include "cmake.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+// The commands of the loop are only ever run from the copies that the
+// foreach() and if() blockers record.
+static const char* const script = R"(
+cmake_policy(VERSION 3.18)
+set(out "")
+foreach(i 1 2 3)
+  if(i EQUAL 2)
+    string(APPEND out "<${i}>")
+  elseif(i EQUAL 3)
+    string(APPEND out "[${i}]")
+  endif()
+endforeach()
+)";
+
+static void run(cmMakefile& mf, cmListFile const& listFile, std::size_t first)
+{
+  for (std::size_t i = first; i < listFile.Functions.size(); ++i) {
+    cmExecutionStatus status(mf);
+    mf.ExecuteCommand(listFile.Functions[i], status);
+  }
+}
+
+static bool testCopiesShareCache()
+{
+  std::cout << "testCopiesShareCache()\n";
+  cmListFileArgument arg("${a}", cmListFileArgument::Quoted, 1);
+  cmListFileArgument copy = arg;
+  ASSERT_TRUE(arg.Cache);
+  ASSERT_TRUE(arg.Cache == copy.Cache);
+
+  cmListFileArgument other("${a}", cmListFileArgument::Quoted, 1);
+  ASSERT_TRUE(other.Cache != arg.Cache);
+  return true;
+}
+
+static bool testReuseInLoopBody()
+{
+  std::cout << "testReuseInLoopBody()\n";
+  cmake cm(cmake::RoleScript, cmState::Script);
+  cm.SetHomeDirectory("");
+  cm.SetHomeOutputDirectory("");
+  cm.GetCurrentSnapshot().SetDefaultDefinitions();
+  cmGlobalGenerator gg(&cm);
+  cmMakefile mf(&gg, cm.GetCurrentSnapshot());
+
+  cmListFile listFile;
+  ASSERT_TRUE(listFile.ParseString(script, "script", mf.GetMessenger(),
+                                   mf.GetBacktrace()));
+  ASSERT_TRUE(listFile.Functions.size() == 9);
+  cmListFileFunction const& ifCommand = listFile.Functions[3];
+  cmListFileFunction const& ifBody = listFile.Functions[4];
+  cmListFileFunction const& elseifCommand = listFile.Functions[5];
+  cmListFileFunction const& elseifBody = listFile.Functions[6];
+
+  run(mf, listFile, 0);
+  ASSERT_TRUE(mf.GetSafeDefinition("out") == "<2>[3]");
+
+  // The copies replayed by the blockers filled in the parsed arguments.
+  auto const ifTokens = ifBody.Arguments[2].Cache->Tokens;
+  auto const elseifTokens = elseifBody.Arguments[2].Cache->Tokens;
+  auto const ifCondition = ifCommand.Arguments[0].Cache->Condition;
+  auto const elseifCondition = elseifCommand.Arguments[0].Cache->Condition;
+  ASSERT_TRUE(ifTokens);
+  ASSERT_TRUE(elseifTokens);
+  ASSERT_TRUE(ifCondition);
+  ASSERT_TRUE(elseifCondition);
+
+  // Running the loop again reuses them.
+  run(mf, listFile, 2);
+  ASSERT_TRUE(mf.GetSafeDefinition("out") == "<2>[3]<2>[3]");
+  ASSERT_TRUE(ifBody.Arguments[2].Cache->Tokens == ifTokens);
+  ASSERT_TRUE(elseifBody.Arguments[2].Cache->Tokens == elseifTokens);
+  ASSERT_TRUE(ifCommand.Arguments[0].Cache->Condition == ifCondition);
+  ASSERT_TRUE(elseifCommand.Arguments[0].Cache->Condition == elseifCondition);
+  return true;
+}
+
+int testListFileArgumentCache(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testCopiesShareCache()) {
+    return 1;
+  }
+  if (!testReuseInLoopBody()) {
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,156 @@
+/* Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+   file Copyright.txt or https://cmake.org/licensing for details.  */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "cmsys/RegularExpression.hxx"
+
+#include "cmRegularExpressionCache.h"
+
+#define ASSERT_TRUE(x)                                                        \
+  do {                                                                        \
+    if (!(x)) {                                                               \
+      std::cout << "ASSERT_TRUE(" #x ") failed on line " << __LINE__ << "\n"; \
+      return false;                                                           \
+    }                                                                         \
+  } while (false)
+
+static bool sameMatch(std::string const& pattern, std::string const& input)
+{
+  cmsys::RegularExpression backtracking;
+  if (!backtracking.compile(pattern)) {
+    return true;
+  }
+  cmsys::RegularExpression linear(backtracking);
+  linear.set_engine(cmsys::RegularExpression::Linear);
+
+  cmsys::RegularExpressionMatch expect;
+  cmsys::RegularExpressionMatch actual;
+  bool found = backtracking.find(input.c_str(), expect);
+  if (linear.find(input.c_str(), actual) != found) {
+    std::cout << "\"" << pattern << "\" on \"" << input
+              << "\": engines disagree on whether it matches\n";
+    return false;
+  }
+  if (!found) {
+    return true;
+  }
+  // Unset subexpressions have equal out-of-range positions in both.
+  for (int i = 0; i < cmsys::RegularExpressionMatch::NSUBEXP; ++i) {
+    if (expect.start(i) != actual.start(i) || expect.end(i) != actual.end(i)) {
+      std::cout << "\"" << pattern << "\" on \"" << input
+                << "\": engines disagree on subexpression " << i << "\n";
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool testEnginesAgree()
+{
+  std::cout << "testEnginesAgree()\n";
+  static char const* const cases[][2] = {
+    { "abc", "xxabcxx" },
+    { "^abc", "xxabc" },
+    { "abc$", "abcabc" },
+    { "a*", "" },
+    { "a*b", "aaab" },
+    { "a+b", "b" },
+    { "(a|ab)(c|bcd)(d*)", "abcd" },
+    { "(a+)+b", "aab" },
+    { "(a|b)*c", "ababc" },
+    { "((a)|b)*", "ab" },
+    { "x(a|b)?y", "xy" },
+    { "[a-c]+[^a-c]", "abcabcd" },
+    { ".*foo", "afoobfoo" },
+    { "^(.*)/([^/]*)$", "/usr/local/bin/cmake" },
+    { "^([^=]+)=(.*)$", "KEY=value=more" },
+    { "(ab|a)(bc|c)", "abc" },
+    { "([0-9]+)\\.([0-9]+)(\\.([0-9]+))?", "version 3.18.0-rc1" },
+    { "(a)(b)(c)(d)(e)(f)(g)(h)(i)", "abcdefghi" },
+    { "^$", "" },
+    { "$", "abc" },
+    { "b*$", "abbb" },
+  };
+  for (auto const& c : cases) {
+    ASSERT_TRUE(sameMatch(c[0], c[1]));
+  }
+
+  // Combine pieces of expressions into many small ones.
+  static char const* const pieces[] = { "a",  "b",   "ab", ".",  "a*",
+                                        "b+", "[ab]", "(a", "(b", ")",
+                                        ")*", ")?",  "|",  "^",  "$" };
+  static char const* const inputs[] = { "", "a", "b", "ab", "ba", "aab",
+                                        "abab", "bbaab", "abba" };
+  unsigned int seed = 1;
+  for (int n = 0; n < 5000; ++n) {
+    std::string pattern;
+    seed = seed * 1103515245u + 12345u;
+    int length = 1 + static_cast<int>((seed >> 16) % 6);
+    for (int i = 0; i < length; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      pattern += pieces[(seed >> 16) % (sizeof(pieces) / sizeof(*pieces))];
+    }
+    for (char const* input : inputs) {
+      ASSERT_TRUE(sameMatch(pattern, input));
+    }
+  }
+  return true;
+}
+
+static bool testLinearTime()
+{
+  std::cout << "testLinearTime()\n";
+  // Backtracking would try every way of splitting the a's between the two
+  // alternatives before giving up at the final b.
+  cmsys::RegularExpression re;
+  ASSERT_TRUE(re.compile("^(a|a)*$"));
+  re.set_engine(cmsys::RegularExpression::Linear);
+  std::string input(100000, 'a');
+  ASSERT_TRUE(re.find(input));
+  ASSERT_TRUE(re.end() == input.size());
+  ASSERT_TRUE(re.start(1) == input.size() - 1);
+  input += 'b';
+  ASSERT_TRUE(!re.find(input));
+  return true;
+}
+
+static bool testCache()
+{
+  std::cout << "testCache()\n";
+  cmRegularExpressionCache cache(2);
+  auto a = cache.Get("a+");
+  ASSERT_TRUE(a);
+  ASSERT_TRUE(a->get_engine() == cmsys::RegularExpression::Linear);
+  ASSERT_TRUE(cache.Get("a+") == a);
+  ASSERT_TRUE(!cache.Get("a**"));
+
+  auto b = cache.Get("b+");
+  ASSERT_TRUE(cache.Get("a+") == a);
+  // Evicts b+, the least recently used.
+  auto c = cache.Get("c+");
+  ASSERT_TRUE(cache.Get("a+") == a);
+  ASSERT_TRUE(cache.Get("c+") == c);
+  ASSERT_TRUE(cache.Get("b+") != b);
+
+  cmsys::RegularExpressionMatch match;
+  ASSERT_TRUE(b->find("xbbx", match));
+  ASSERT_TRUE(match.start() == 1 && match.end() == 3);
+  return true;
+}
+
+int testRegularExpressionCache(int /*unused*/, char* /*unused*/ [])
+{
+  if (!testEnginesAgree()) {
+    return 1;
+  }
+  if (!testLinearTime()) {
+    return 1;
+  }
+  if (!testCache()) {
+    return 1;
+  }
+  return 0;
+}
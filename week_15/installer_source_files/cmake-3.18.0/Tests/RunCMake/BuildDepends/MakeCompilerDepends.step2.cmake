@@ -0,0 +1,3 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeCompilerDepends.h" [[
+#define MAKE_COMPILER_DEPENDS 2
+]])
@@ -68,6 +68,7 @@ if(RunCMake_GENERATOR MATCHES "Make")
   if(NOT "${RunCMake_BINARY_DIR}" STREQUAL "${RunCMake_SOURCE_DIR}")
     run_BuildDepends(MakeInProjectOnly)
   endif()
+  run_BuildDepends(MakeCompilerDepends)
 endif()
 
 function(run_ReGeneration)
@@ -0,0 +1,45 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(READ "${ProfilingTestOutput}" output)
+string(REGEX REPLACE "[ \t\n]" "" output "${output}")
+foreach(section commands functions files)
+  if (NOT output MATCHES "\"${section}\":\\[")
+    set(RunCMake_TEST_FAILED "Expected \"${section}\" list")
+    return()
+  endif()
+endforeach()
+
+# Each function is reported in both the commands and the functions, with
+# the calls made under either case of its name added up.
+foreach(func __testing_outer __testing_inner)
+  if (func STREQUAL "__testing_outer")
+    set(calls 2)
+  else()
+    set(calls 6)
+  endif()
+  string(REGEX MATCHALL
+    "{\"calls\":${calls},\"name\":\"${func}\",\"selfTime\":[0-9]+,\"totalTime\":[0-9]+}"
+    entries "${output}")
+  list(LENGTH entries numEntries)
+  if (NOT numEntries EQUAL 2)
+    set(RunCMake_TEST_FAILED
+      "Expected 2 entries for ${func} with ${calls} calls, got ${numEntries}")
+    return()
+  endif()
+endforeach()
+
+# Other commands are only reported in the commands.
+string(REGEX MATCHALL "{\"calls\":3,\"name\":\"foreach\"" entries "${output}")
+list(LENGTH entries numEntries)
+if (NOT numEntries EQUAL 1)
+  set(RunCMake_TEST_FAILED
+    "Expected 1 entry for foreach with 3 calls, got ${numEntries}")
+  return()
+endif()
+
+if (NOT output MATCHES "\"file\":\"[^\"]*/ProfilingAggregate.cmake\"")
+  set(RunCMake_TEST_FAILED "Expected an entry for ProfilingAggregate.cmake")
+endif()
@@ -0,0 +1,11 @@
+function(__testing_inner)
+endfunction()
+function(__testing_outer)
+  foreach(i RANGE 1 3)
+    __testing_inner()
+  endforeach()
+endfunction()
+
+# Calls are counted per command, whatever the case of their name.
+__TESTING_OUTER()
+__testing_outer()
@@ -0,0 +1,18 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+set(file "[^;]*/ProfilingFolded.cmake")
+set(outer "^include [^;]*;__testing_outer \\(${file}:10\\)")
+file(STRINGS ${ProfilingTestOutput} outerStack
+  REGEX "${outer} [0-9]+$")
+list(LENGTH outerStack numOuter)
+# The calls from the loop have the same stack, so they fold into one line.
+file(STRINGS ${ProfilingTestOutput} innerStacks
+  REGEX "${outer};__testing_inner \\(${file}:[46]\\) [0-9]+$")
+list(LENGTH innerStacks numInner)
+if (NOT numOuter EQUAL 1 OR NOT numInner EQUAL 2)
+  set(RunCMake_TEST_FAILED
+    "Unexpected folded stacks:\n ${outerStack}\n ${innerStacks}")
+endif()
@@ -0,0 +1,10 @@
+function(__testing_inner)
+endfunction()
+function(__testing_outer)
+  __testing_inner()
+  foreach(i RANGE 1 3)
+    __testing_inner()
+  endforeach()
+endfunction()
+
+__testing_outer()
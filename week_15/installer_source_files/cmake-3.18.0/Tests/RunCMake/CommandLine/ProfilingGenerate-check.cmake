@@ -0,0 +1,20 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+file(READ "${ProfilingTestOutput}" output)
+foreach(step AddAutomaticSources QtAutoGen TraceDependencies
+             ComputeTargetDepends)
+  if (NOT output MATCHES "(^|\n)generate: Compute;generate: ${step} [0-9]+\n")
+    set(RunCMake_TEST_FAILED "Expected a stack for the ${step} step")
+    return()
+  endif()
+endforeach()
+
+# Property values are evaluated below the generator of their target.
+if (NOT output MATCHES
+    "(^|\n)generate: Generate;directory: [^;\n]*;target: profiled;genex: [^;\n]+;genex: COMPILE_DEFINITIONS [0-9]+\n")
+  set(RunCMake_TEST_FAILED
+    "Expected a genex stack for COMPILE_DEFINITIONS below target profiled")
+endif()
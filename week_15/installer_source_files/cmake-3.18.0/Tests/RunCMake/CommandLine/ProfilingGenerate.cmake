@@ -0,0 +1,3 @@
+add_custom_target(profiled ALL
+  COMMAND ${CMAKE_COMMAND} -E echo $<TARGET_PROPERTY:profiled,COMPILE_DEFINITIONS>)
+set_property(TARGET profiled PROPERTY COMPILE_DEFINITIONS "$<1:value>")
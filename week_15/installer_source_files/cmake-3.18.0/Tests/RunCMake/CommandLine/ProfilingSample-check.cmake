@@ -0,0 +1,10 @@
+if (NOT EXISTS ${ProfilingTestOutput})
+  set(RunCMake_TEST_FAILED "Expected ${ProfilingTestOutput} to exists")
+  return()
+endif()
+
+# The sleep spans many sampling intervals, so it cannot go unnoticed.
+file(READ "${ProfilingTestOutput}" output)
+if (NOT output MATCHES ";__testing_sleep \\([^)]*/ProfilingSample.cmake:5\\);execute_process \\([^)]*/ProfilingSample.cmake:2\\) [1-9][0-9]*\n")
+  set(RunCMake_TEST_FAILED "Expected samples for the execute_process call")
+endif()
@@ -0,0 +1,5 @@
+function(__testing_sleep)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 0.2)
+endfunction()
+
+__testing_sleep()
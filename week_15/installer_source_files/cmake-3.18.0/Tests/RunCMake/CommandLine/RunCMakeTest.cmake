@@ -654,6 +654,20 @@ set(RunCMake_TEST_OPTIONS --trace-expand --trace-format=json-v1 --trace-redirect
 run_cmake(trace-json-v1-expand)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS --trace        --trace-format=binary-v1 --trace-redirect=${RunCMake_BINARY_DIR}/binary-v1.trace)
+run_cmake(trace-binary-v1)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --trace-expand --trace-format=binary-v1 --trace-redirect=${RunCMake_BINARY_DIR}/binary-v1-expand.trace)
+run_cmake(trace-binary-v1-expand)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --trace-format=binary-v1)
+run_cmake(trace-binary-v1-no-redirect)
+unset(RunCMake_TEST_OPTIONS)
+
+run_cmake_command(E_convert_trace-invalid ${CMAKE_COMMAND} -E convert_trace ${RunCMake_SOURCE_DIR}/trace-json-v1.cmake)
+
 set(RunCMake_TEST_OPTIONS -Wno-deprecated --warn-uninitialized)
 run_cmake(warn-uninitialized)
 unset(RunCMake_TEST_OPTIONS)
@@ -752,8 +766,36 @@ set(RunCMake_TEST_OPTIONS --profiling-format=google-trace)
 run_cmake(profiling-missing-output)
 unset(RunCMake_TEST_OPTIONS)
 
+set(RunCMake_TEST_OPTIONS --profiling-sample)
+run_cmake(profiling-sample-missing-output)
+unset(RunCMake_TEST_OPTIONS)
+
+set(RunCMake_TEST_OPTIONS --profiling-sample=0 --profiling-output=/no/such/file.txt)
+run_cmake(profiling-sample-invalid-interval)
+unset(RunCMake_TEST_OPTIONS)
+
 set(RunCMake_TEST_BINARY_DIR "${RunCMake_BINARY_DIR}/profiling-test")
 set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output.json)
 set(RunCMake_TEST_OPTIONS --profiling-format=google-trace --profiling-output=${ProfilingTestOutput})
 run_cmake(ProfilingTest)
 unset(RunCMake_TEST_OPTIONS)
+
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output-aggregate.json)
+set(RunCMake_TEST_OPTIONS --profiling-format=aggregate --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingAggregate)
+unset(RunCMake_TEST_OPTIONS)
+
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output-folded.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=folded --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingFolded)
+unset(RunCMake_TEST_OPTIONS)
+
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output-generate.txt)
+set(RunCMake_TEST_OPTIONS --profiling-format=folded --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingGenerate)
+unset(RunCMake_TEST_OPTIONS)
+
+set(ProfilingTestOutput ${RunCMake_TEST_BINARY_DIR}/output-sample.txt)
+set(RunCMake_TEST_OPTIONS --profiling-sample=1000 --profiling-output=${ProfilingTestOutput})
+run_cmake(ProfilingSample)
+unset(RunCMake_TEST_OPTIONS)
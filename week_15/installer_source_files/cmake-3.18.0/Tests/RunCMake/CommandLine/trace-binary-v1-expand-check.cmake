@@ -0,0 +1,23 @@
+set(json_trace "${RunCMake_BINARY_DIR}/binary-v1-expand.json")
+execute_process(
+  COMMAND ${CMAKE_COMMAND} -E convert_trace "${RunCMake_BINARY_DIR}/binary-v1-expand.trace" "${json_trace}"
+  RESULT_VARIABLE result
+  OUTPUT_VARIABLE output
+  ERROR_VARIABLE output
+  )
+if(NOT result EQUAL 0)
+  set(RunCMake_TEST_FAILED "Binary trace conversion failed:\n${output}")
+  return()
+endif()
+
+if(PYTHON_EXECUTABLE)
+  execute_process(
+    COMMAND ${PYTHON_EXECUTABLE} "${RunCMake_SOURCE_DIR}/trace-json-v1-check.py" --expand "${json_trace}"
+    RESULT_VARIABLE result
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output
+    )
+  if(NOT result EQUAL 0)
+    set(RunCMake_TEST_FAILED "JSON trace validation failed:\n${output}")
+  endif()
+endif()
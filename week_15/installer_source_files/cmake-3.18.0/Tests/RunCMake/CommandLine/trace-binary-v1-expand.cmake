@@ -0,0 +1 @@
+include(trace-json-v1.cmake)
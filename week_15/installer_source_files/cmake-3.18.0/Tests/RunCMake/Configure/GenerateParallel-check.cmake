@@ -0,0 +1,9 @@
+foreach(i RANGE 1 8)
+  if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/sub${i}-build/cmake_install.cmake")
+    string(APPEND RunCMake_TEST_FAILED "sub${i}-build/cmake_install.cmake not written\n")
+  endif()
+endforeach()
+file(GLOB_RECURSE tmp_files "${RunCMake_TEST_BINARY_DIR}/*.tmp")
+if(tmp_files)
+  string(APPEND RunCMake_TEST_FAILED "Temporary files left behind:\n  ${tmp_files}\n")
+endif()
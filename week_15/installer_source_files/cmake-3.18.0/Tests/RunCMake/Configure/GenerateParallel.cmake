@@ -0,0 +1,6 @@
+foreach(i RANGE 1 8)
+  set(dir "${CMAKE_CURRENT_BINARY_DIR}/sub${i}")
+  file(WRITE "${dir}/CMakeLists.txt"
+    "add_custom_target(sub${i} ALL COMMAND \${CMAKE_COMMAND} -E echo sub${i})\n")
+  add_subdirectory("${dir}" "sub${i}-build")
+endforeach()
@@ -0,0 +1,14 @@
+set(cache "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache.bin")
+if(NOT EXISTS "${cache}")
+  set(RunCMake_TEST_FAILED "CMakeFiles/ListFileCache.bin not written")
+  return()
+endif()
+
+# A configure that reads every list file from the cache leaves it alone.
+if(DEFINED ListFileCache_TIMESTAMP)
+  file(TIMESTAMP "${cache}" timestamp "%Y-%m-%dT%H:%M:%S")
+  if(NOT timestamp STREQUAL ListFileCache_TIMESTAMP)
+    set(RunCMake_TEST_FAILED
+      "CMakeFiles/ListFileCache.bin was rewritten at ${timestamp}, so the configure did not reuse the parsed list files.")
+  endif()
+endif()
@@ -0,0 +1,2 @@
+include(${CMAKE_CURRENT_LIST_DIR}/ListFileCacheWarn.cmake)
+message(WARNING "Parsed from cache")
@@ -51,6 +51,35 @@ run_cmake(RemoveCache)
 file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeCache.txt")
 run_cmake(RemoveCache)
 
+# Configure again so later runs read the persisted list files.
+function(run_ListFileCache)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ListFileCache-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(ListFileCache)
+  # The second run drops the modules only the first run reads.  After
+  # that the cache file is only rewritten when a list file misses it.
+  run_cmake(ListFileCache)
+  file(TIMESTAMP "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/ListFileCache.bin"
+    ListFileCache_TIMESTAMP "%Y-%m-%dT%H:%M:%S")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1) # handle 1s resolution
+  run_cmake(ListFileCache)
+endfunction()
+run_ListFileCache()
+
+# Generate twice so the second run compares against existing files.
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/GenerateParallel-build)
+set(RunCMake_TEST_NO_CLEAN 1)
+file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+set(ENV{CMAKE_GENERATE_PARALLEL_LEVEL} 4)
+run_cmake(GenerateParallel)
+run_cmake(GenerateParallel)
+unset(ENV{CMAKE_GENERATE_PARALLEL_LEVEL})
+unset(RunCMake_TEST_BINARY_DIR)
+unset(RunCMake_TEST_NO_CLEAN)
+
 if(NOT RunCMake_GENERATOR MATCHES "^Ninja Multi-Config$")
   run_cmake(NoCMAKE_CROSS_CONFIGS)
   run_cmake(NoCMAKE_DEFAULT_BUILD_TYPE)
@@ -0,0 +1,10 @@
+enable_language(C)
+
+include_directories(${CMAKE_CURRENT_SOURCE_DIR})
+add_compile_definitions(GREETING_STATIC)
+
+add_library(shard_a STATIC greeting.c)
+add_library(shard_b STATIC greeting2.c)
+target_compile_definitions(shard_b PRIVATE "SHARD_B=${SHARD_B}")
+add_executable(hello hello_with_two_greetings.c)
+target_link_libraries(hello shard_a shard_b)
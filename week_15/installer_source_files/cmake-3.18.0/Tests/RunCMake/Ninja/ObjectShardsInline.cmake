@@ -0,0 +1,3 @@
+# Exporting compile commands keeps the object statements inline.
+set(CMAKE_EXPORT_COMPILE_COMMANDS ON)
+include(ObjectShards.cmake)
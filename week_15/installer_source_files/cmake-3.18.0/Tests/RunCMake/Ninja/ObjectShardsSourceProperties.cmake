@@ -0,0 +1,5 @@
+enable_language(C)
+
+add_library(shard_a STATIC greeting.c)
+set_property(SOURCE greeting.c PROPERTY COMPILE_OPTIONS ${SOURCE_OPTIONS})
+set_property(SOURCE greeting.c PROPERTY COMPILE_DEFINITIONS ${SOURCE_DEFINITIONS})
@@ -157,6 +157,128 @@ function (run_LooseObjectDepends)
 endfunction ()
 run_LooseObjectDepends()
 
+function(check_object_shard shard kept)
+  file(READ "${shard}" shard_content)
+  if(kept AND NOT shard_content MATCHES "\n# kept\n$")
+    message(FATAL_ERROR "Object shard was rewritten:\n  ${shard}")
+  elseif(NOT kept AND shard_content MATCHES "\n# kept\n$")
+    message(FATAL_ERROR "Object shard was not rewritten:\n  ${shard}")
+  endif()
+endfunction()
+
+function(ninja_commands dir out)
+  execute_process(
+    COMMAND "${RunCMake_MAKE_PROGRAM}" -t commands
+    WORKING_DIRECTORY "${dir}"
+    OUTPUT_VARIABLE commands
+    RESULT_VARIABLE result
+    )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "ninja -t commands failed in:\n  ${dir}")
+  endif()
+  string(REPLACE "${dir}" "<BUILD_DIR>" commands "${commands}")
+  set("${out}" "${commands}" PARENT_SCOPE)
+endfunction()
+
+function(run_ObjectShards)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ObjectShards-build)
+  set(RunCMake_TEST_OPTIONS -DSHARD_B=1)
+  run_cmake(ObjectShards)
+  unset(RunCMake_TEST_OPTIONS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+
+  # Compiler detection leaves variables behind that change the statements
+  # of the first run, so start from a run that loads the detected compiler.
+  run_cmake_command(ObjectShards-loaded ${CMAKE_COMMAND} .)
+
+  # Mark the shards to tell which ones a later run rewrites.
+  set(shard_a "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/shard_a.dir/objects.ninja")
+  set(shard_b "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/shard_b.dir/objects.ninja")
+  foreach(shard IN ITEMS "${shard_a}" "${shard_b}")
+    if(NOT EXISTS "${shard}")
+      message(FATAL_ERROR "Object shard was not generated:\n  ${shard}")
+    endif()
+    file(APPEND "${shard}" "# kept\n")
+  endforeach()
+
+  run_cmake_command(ObjectShards-reconfigure ${CMAKE_COMMAND} .)
+  check_object_shard("${shard_a}" 1)
+  check_object_shard("${shard_b}" 1)
+
+  run_cmake_command(ObjectShards-change ${CMAKE_COMMAND} -DSHARD_B=2 .)
+  check_object_shard("${shard_a}" 1)
+  check_object_shard("${shard_b}" 0)
+  file(READ "${shard_b}" shard_content)
+  if(NOT shard_content MATCHES "SHARD_B=2")
+    message(FATAL_ERROR "Object shard does not have the new definition:\n  ${shard_b}")
+  endif()
+  run_ninja("${RunCMake_TEST_BINARY_DIR}")
+  ninja_commands("${RunCMake_TEST_BINARY_DIR}" sharded_commands)
+
+  # The same project with its object statements inline builds the same.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ObjectShardsInline-build)
+  set(RunCMake_TEST_OPTIONS -DSHARD_B=2)
+  unset(RunCMake_TEST_NO_CLEAN)
+  run_cmake(ObjectShardsInline)
+  if(EXISTS "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/shard_a.dir/objects.ninja")
+    message(FATAL_ERROR "Object shard generated with CMAKE_EXPORT_COMPILE_COMMANDS")
+  endif()
+  run_ninja("${RunCMake_TEST_BINARY_DIR}")
+  ninja_commands("${RunCMake_TEST_BINARY_DIR}" inline_commands)
+  if(NOT sharded_commands STREQUAL inline_commands)
+    message(FATAL_ERROR "Sharded build commands:\n${sharded_commands}\n"
+      "differ from inline build commands:\n${inline_commands}")
+  endif()
+endfunction()
+run_ObjectShards()
+
+function(run_ObjectShardsSourceProperties)
+  # Start from runs that load the detected compiler, see run_ObjectShards.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ObjectShardsSourceProperties-build)
+  run_cmake(ObjectShardsSourceProperties)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(ObjectShardsSourceProperties-loaded ${CMAKE_COMMAND} .)
+  run_cmake_command(ObjectShardsSourceProperties-change ${CMAKE_COMMAND}
+    -DSOURCE_OPTIONS=-DFROM_OPTIONS -DSOURCE_DEFINITIONS=FROM_DEFINITIONS .)
+  set(shard "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/shard_a.dir/objects.ninja")
+  file(READ "${shard}" changed_shard)
+  if(NOT changed_shard MATCHES "-DFROM_OPTIONS" OR
+     NOT changed_shard MATCHES "-DFROM_DEFINITIONS")
+    message(FATAL_ERROR "Object shard misses the source properties:\n  ${shard}")
+  endif()
+
+  # Generator expressions keep the statements inline.
+  run_cmake_command(ObjectShardsSourceProperties-genex ${CMAKE_COMMAND}
+    "-DSOURCE_OPTIONS=$<1:-DFROM_GENEX>" .)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+  if(build_ninja MATCHES "shard_a\\.dir/objects\\.ninja" OR
+     NOT build_ninja MATCHES "-DFROM_GENEX")
+    message(FATAL_ERROR "Statements with generator expressions are not inline.")
+  endif()
+
+  # A fresh build tree with the same properties writes the same shard.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ObjectShardsSourceProperties-fresh-build)
+  set(RunCMake_TEST_OPTIONS -DSOURCE_OPTIONS=-DFROM_OPTIONS -DSOURCE_DEFINITIONS=FROM_DEFINITIONS)
+  unset(RunCMake_TEST_NO_CLEAN)
+  run_cmake(ObjectShardsSourceProperties)
+  unset(RunCMake_TEST_OPTIONS)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(ObjectShardsSourceProperties-fresh-loaded ${CMAKE_COMMAND} .)
+  file(READ "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/shard_a.dir/objects.ninja" fresh_shard)
+  if(NOT changed_shard STREQUAL fresh_shard)
+    message(FATAL_ERROR "Object shard after changing source properties:\n"
+      "${changed_shard}\ndiffers from a fresh one:\n${fresh_shard}")
+  endif()
+endfunction()
+run_ObjectShardsSourceProperties()
+
+function(run_ShardByDirectory)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShardByDirectory-build)
+  run_cmake(ShardByDirectory)
+  run_ninja("${RunCMake_TEST_BINARY_DIR}")
+endfunction()
+run_ShardByDirectory()
+
 function (run_AssumedSources)
   set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/AssumedSources-build)
   run_cmake(AssumedSources)
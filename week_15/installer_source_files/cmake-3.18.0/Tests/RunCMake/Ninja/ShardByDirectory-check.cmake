@@ -0,0 +1,25 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/build.ninja" build_ninja)
+if(NOT build_ninja MATCHES "\nsubninja CMakeFiles/directory\\.ninja\nsubninja SubDirPrefix/CMakeFiles/directory\\.ninja\n")
+  string(APPEND RunCMake_TEST_FAILED "build.ninja does not reference the directory shards.\n")
+endif()
+if(build_ninja MATCHES "\n# Link build statements for ")
+  string(APPEND RunCMake_TEST_FAILED "build.ninja has link statements of its own.\n")
+endif()
+
+set(top_shard "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory.ninja")
+set(sub_shard "${RunCMake_TEST_BINARY_DIR}/SubDirPrefix/CMakeFiles/directory.ninja")
+foreach(shard IN ITEMS "${top_shard}" "${sub_shard}")
+  if(NOT EXISTS "${shard}")
+    string(APPEND RunCMake_TEST_FAILED "Directory shard does not exist:\n  ${shard}\n")
+    return()
+  endif()
+endforeach()
+
+file(READ "${top_shard}" top_content)
+if(NOT top_content MATCHES "\n# Link build statements for EXECUTABLE target hello\n")
+  string(APPEND RunCMake_TEST_FAILED "Target hello is missing from:\n  ${top_shard}\n")
+endif()
+file(READ "${sub_shard}" sub_content)
+if(NOT sub_content MATCHES "\n# Link build statements for SHARED_LIBRARY target greeting\n")
+  string(APPEND RunCMake_TEST_FAILED "Target greeting is missing from:\n  ${sub_shard}\n")
+endif()
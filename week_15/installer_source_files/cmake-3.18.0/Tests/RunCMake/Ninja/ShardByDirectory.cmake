@@ -0,0 +1,8 @@
+enable_language(C)
+
+set(CMAKE_NINJA_SHARD_BY_DIRECTORY ON)
+
+add_subdirectory(SubDirPrefix)
+include_directories(${CMAKE_CURRENT_SOURCE_DIR})
+add_executable(hello hello_sub_greeting.c)
+target_link_libraries(hello greeting)
@@ -112,6 +112,13 @@ run_ninja(Simple default-build-file-clean build.ninja clean)
 run_ninja(Simple default-build-file-clean-minsizerel build.ninja clean:MinSizeRel)
 run_ninja(Simple default-build-file-all build.ninja all)
 
+set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShardByDirectory-build)
+set(RunCMake_TEST_OPTIONS "-DCMAKE_CONFIGURATION_TYPES=Debug\\;Release")
+run_cmake_configure(ShardByDirectory)
+unset(RunCMake_TEST_OPTIONS)
+include(${RunCMake_TEST_BINARY_DIR}/target_files.cmake)
+run_cmake_build(ShardByDirectory debug-all Debug all)
+
 set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/SimpleDefaultBuildAlias-build)
 set(RunCMake_TEST_OPTIONS "-DCMAKE_CONFIGURATION_TYPES=Debug\\;Release\\;MinSizeRel\\;RelWithDebInfo;-DCMAKE_DEFAULT_BUILD_TYPE=Release;-DCMAKE_DEFAULT_CONFIGS=all;-DCMAKE_CROSS_CONFIGS=all")
 run_cmake_configure(SimpleDefaultBuildAlias)
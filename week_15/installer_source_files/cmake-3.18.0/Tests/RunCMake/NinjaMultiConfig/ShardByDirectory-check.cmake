@@ -0,0 +1,15 @@
+check_file_contents("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/common.ninja"
+  "\nsubninja CMakeFiles/directory-common\\.ninja\nsubninja SimpleSubdir/CMakeFiles/directory-common\\.ninja\n")
+
+foreach(config IN ITEMS Debug Release)
+  check_file_contents("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/impl-${config}.ninja"
+    "\nsubninja CMakeFiles/directory-impl-${config}\\.ninja\nsubninja SimpleSubdir/CMakeFiles/directory-impl-${config}\\.ninja\n")
+  check_file_contents("${RunCMake_TEST_BINARY_DIR}/CMakeFiles/directory-impl-${config}.ninja"
+    "\n# Link build statements for STATIC_LIBRARY target simplestatic\n")
+  check_file_contents("${RunCMake_TEST_BINARY_DIR}/SimpleSubdir/CMakeFiles/directory-impl-${config}.ninja"
+    "\n# Link build statements for EXECUTABLE target simpleexe\n")
+endforeach()
+
+if(NOT EXISTS "${RunCMake_TEST_BINARY_DIR}/SimpleSubdir/CMakeFiles/directory-common.ninja")
+  string(APPEND RunCMake_TEST_FAILED "Directory shard SimpleSubdir/CMakeFiles/directory-common.ninja does not exist\n")
+endif()
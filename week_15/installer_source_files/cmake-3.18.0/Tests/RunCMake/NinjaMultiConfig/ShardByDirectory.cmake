@@ -0,0 +1,2 @@
+set(CMAKE_NINJA_SHARD_BY_DIRECTORY ON)
+include("${CMAKE_CURRENT_SOURCE_DIR}/Simple.cmake")
@@ -0,0 +1,11 @@
+cmake_policy(SET CMP0053 NEW)
+
+set(ENV{CMP0053_Repeated} env)
+set(name a)
+function(show)
+  message("-->${ARGV0} ${${name}} $ENV{CMP0053_Repeated} [\t\;\$] ${CMAKE_CURRENT_LIST_LINE}<--")
+endfunction()
+foreach(a 1 2)
+  show(${a})
+  set(name ARGV0)
+endforeach()
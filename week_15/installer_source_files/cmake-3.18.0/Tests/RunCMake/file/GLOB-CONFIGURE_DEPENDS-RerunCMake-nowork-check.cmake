@@ -0,0 +1,4 @@
+if(actual_stdout MATCHES "Running CMake on" OR
+   actual_stderr MATCHES "GLOB mismatch")
+  set(RunCMake_TEST_FAILED "The build unexpectedly re-ran CMake.")
+endif()
@@ -133,6 +133,18 @@ else()
   run_cmake_command(GLOB-CONFIGURE_DEPENDS-RerunCMake-rebuild_second ${CMAKE_COMMAND} --build .)
   run_cmake_command(GLOB-CONFIGURE_DEPENDS-RerunCMake-nowork ${CMAKE_COMMAND} --build .)
 
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep ${fs_delay})
+  message(STATUS "GLOB-CONFIGURE_DEPENDS-RerunCMake: modify a test file...")
+  file(WRITE "${tf_2}" "2.1")
+  run_cmake_command(GLOB-CONFIGURE_DEPENDS-RerunCMake-nowork ${CMAKE_COMMAND} --build .)
+
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep ${fs_delay})
+  message(STATUS "GLOB-CONFIGURE_DEPENDS-RerunCMake: restore first test file without saved state...")
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/VerifyGlobs.state")
+  file(WRITE "${tf_1}" "1")
+  run_cmake_command(GLOB-CONFIGURE_DEPENDS-RerunCMake-rebuild_third ${CMAKE_COMMAND} --build .)
+  run_cmake_command(GLOB-CONFIGURE_DEPENDS-RerunCMake-nowork ${CMAKE_COMMAND} --build .)
+
   if(NOT WIN32 OR CYGWIN)
     message(STATUS "GLOB-CONFIGURE_DEPENDS-CMP0009-RerunCMake: link the first test directory into a new directory...")
     file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}/test2")
@@ -0,0 +1,29 @@
+# Calls made from the same place must see the current definition.
+function(redefined)
+  list(APPEND results "first")
+  set(results "${results}" PARENT_SCOPE)
+endfunction()
+set(results)
+foreach(i RANGE 1 3)
+  if(i EQUAL 2)
+    function(redefined)
+      list(APPEND results "second")
+      set(results "${results}" PARENT_SCOPE)
+    endfunction()
+  endif()
+  redefined()
+endforeach()
+
+# A function may redefine itself while it runs.
+function(self_redefining)
+  function(self_redefining)
+    message(STATUS "self_redefining: new")
+  endfunction()
+  message(STATUS "self_redefining: old")
+endfunction()
+self_redefining()
+self_redefining()
+
+# The previous definition stays available with a leading underscore.
+_redefined()
+message(STATUS "results: ${results}")
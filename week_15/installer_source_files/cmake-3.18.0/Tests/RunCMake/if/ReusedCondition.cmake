@@ -0,0 +1,51 @@
+function(check)
+  if(${ARGV})
+    set(results "${results}1" PARENT_SCOPE)
+  else()
+    set(results "${results}0" PARENT_SCOPE)
+  endif()
+endfunction()
+
+set(results "")
+check(a STREQUAL a)
+check(b STRLESS a)
+check(NOT 1)
+check(1.2 VERSION_LESS 1.10)
+check(( 0 OR 1 ) AND ( 1 ))
+check(( 0 OR 1 ) AND ( 0 ))
+check(DEFINED results)
+check(xyz MATCHES "^x(y)z$")
+check(2 GREATER 10)
+message(STATUS "check: ${results}")
+
+set(results "")
+foreach(op LESS GREATER EQUAL STRLESS STRGREATER STREQUAL)
+  if(1 ${op} 10)
+    string(APPEND results "1")
+  else()
+    string(APPEND results "0")
+  endif()
+endforeach()
+message(STATUS "operators: ${results}")
+
+set(results "")
+set(y x)
+cmake_policy(PUSH)
+foreach(policy NEW OLD NEW)
+  cmake_policy(SET CMP0054 ${policy})
+  if("y" STREQUAL "x")
+    string(APPEND results "1")
+  else()
+    string(APPEND results "0")
+  endif()
+endforeach()
+cmake_policy(POP)
+message(STATUS "CMP0054: ${results}")
+
+set(i 0)
+set(results "")
+while(i LESS 5 AND NOT i EQUAL 3)
+  math(EXPR i "${i} + 1")
+  string(APPEND results "${i}")
+endwhile()
+message(STATUS "while: ${results}")
@@ -13,3 +13,4 @@ run_cmake(MatchesSelf)
 
 run_cmake(TestNameThatExists)
 run_cmake(TestNameThatDoesNotExist)
+run_cmake(ReusedCondition)
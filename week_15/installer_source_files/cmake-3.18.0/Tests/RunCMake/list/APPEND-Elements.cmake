@@ -0,0 +1,72 @@
+cmake_policy(SET CMP0007 NEW)
+
+function(assert_list list_var expected)
+  if(NOT "${${list_var}}" STREQUAL "${expected}")
+    message(FATAL_ERROR "`${list_var}` expected to be `${expected}`, got `${${list_var}}` instead")
+  endif()
+endfunction()
+
+# Grow a list one element at a time and query it on the way.
+set(test)
+foreach(i RANGE 9)
+  list(APPEND test "item${i}")
+  list(LENGTH test len)
+  math(EXPR expected "${i} + 1")
+  assert_list(len ${expected})
+  list(GET test ${i} last)
+  assert_list(last "item${i}")
+endforeach()
+list(FIND test item7 index)
+assert_list(index 7)
+list(POP_BACK test a b)
+assert_list(a item9)
+assert_list(b item8)
+list(GET test -1 last)
+assert_list(last item7)
+
+# Elements that do not join back into the same string.
+set(test "a[b;c]")
+list(APPEND test d)
+assert_list(test "a[b;c];d")
+list(LENGTH test len)
+assert_list(len 2)
+set(test "a\;b")
+list(APPEND test c)
+assert_list(test "a\;b;c")
+list(LENGTH test len)
+assert_list(len 2)
+set(test x)
+list(APPEND test "" y)
+assert_list(test "x;;y")
+list(LENGTH test len)
+assert_list(len 3)
+unset(test)
+list(APPEND test "")
+assert_list(test "")
+list(LENGTH test len)
+assert_list(len 0)
+
+# Appending in a function scope does not change the parent scope.
+set(test a b)
+set(copy "${test}")
+function(append_in_function)
+  list(APPEND test c)
+  assert_list(test "a;b;c")
+  set(result "${test}" PARENT_SCOPE)
+endfunction()
+append_in_function()
+list(APPEND test d)
+assert_list(test "a;b;d")
+assert_list(copy "a;b")
+assert_list(result "a;b;c")
+
+# A list popped into itself keeps the remaining elements.
+set(test 1 2 3)
+list(POP_BACK test x test)
+assert_list(test 1)
+assert_list(x 3)
+
+# A cache entry is read when no normal variable is set.
+set(cached c1 CACHE STRING "")
+list(APPEND cached c2)
+assert_list(cached "c1;c2")
@@ -112,3 +112,4 @@ run_cmake(POP_FRONT-NoArgs)
 # Successful tests
 run_cmake(POP_BACK)
 run_cmake(POP_FRONT)
+run_cmake(APPEND-Elements)
@@ -0,0 +1,34 @@
+set(INHERITED "top")
+set(LIST "a")
+
+function(_inner)
+  set(INNER "inner" PARENT_SCOPE)
+  unset(INHERITED PARENT_SCOPE)
+  list(APPEND LIST "inner")
+endfunction()
+
+function(_outer)
+  list(APPEND LIST "outer")
+  _inner()
+  if(DEFINED INHERITED)
+    message(FATAL_ERROR "INHERITED still defined in _outer")
+  endif()
+  if(NOT "${INNER}" STREQUAL "inner")
+    message(FATAL_ERROR "INNER should be \"inner\", not \"${INNER}\"")
+  endif()
+  if(NOT "${LIST}" STREQUAL "a;outer")
+    message(FATAL_ERROR "LIST should be \"a;outer\" in _outer, not \"${LIST}\"")
+  endif()
+endfunction()
+
+_outer()
+
+if(NOT "${INHERITED}" STREQUAL "top")
+  message(FATAL_ERROR "INHERITED should be \"top\", not \"${INHERITED}\"")
+endif()
+if(DEFINED INNER)
+  message(FATAL_ERROR "INNER defined")
+endif()
+if(NOT "${LIST}" STREQUAL "a")
+  message(FATAL_ERROR "LIST should be \"a\", not \"${LIST}\"")
+endif()
@@ -1,7 +1,12 @@
 include(RunCMake)
 
 run_cmake(ParentScope)
+run_cmake(ParentScopeNested)
 run_cmake(ParentPulling)
 run_cmake(ParentPullingRecursive)
 run_cmake(UnknownCacheType)
 run_cmake(ExtraEnvValue)
+
+set(RunCMake_TEST_OPTIONS --warn-unused-vars)
+run_cmake(WarnUnusedDirectory)
+unset(RunCMake_TEST_OPTIONS)
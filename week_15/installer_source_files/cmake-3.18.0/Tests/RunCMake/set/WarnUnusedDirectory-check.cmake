@@ -0,0 +1,23 @@
+function(check_unused where var expect)
+  set(warning "in [^\n]*${where}:\n  unused variable \\(out of scope\\) '${var}'\n")
+  if(expect AND NOT actual_stderr MATCHES "${warning}")
+    string(APPEND RunCMake_TEST_FAILED "${var} is not reported unused in ${where}.\n")
+  elseif(NOT expect AND actual_stderr MATCHES "${warning}")
+    string(APPEND RunCMake_TEST_FAILED "${var} is reported unused in ${where}.\n")
+  endif()
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}" PARENT_SCOPE)
+endfunction()
+
+# A directory reports the values it inherited and did not use, but not
+# those its parent used before adding it.  A use in a function counts for
+# the directory it was called from.
+check_unused("WarnUnusedDirectory/CMakeLists.txt" NEVER_READ 1)
+check_unused("WarnUnusedDirectory/CMakeLists.txt" SUBDIR_NEVER_READ 1)
+check_unused("WarnUnusedDirectory/CMakeLists.txt" READ_BY_PARENT 0)
+check_unused("WarnUnusedDirectory/CMakeLists.txt" READ_BY_SUBDIR 0)
+check_unused("WarnUnusedDirectory/CMakeLists.txt" READ_BY_FUNCTION 0)
+
+# Uses in a subdirectory do not count for its parent.
+check_unused("WarnUnusedDirectory.cmake" NEVER_READ 1)
+check_unused("WarnUnusedDirectory.cmake" READ_BY_SUBDIR 1)
+check_unused("WarnUnusedDirectory.cmake" READ_BY_PARENT 0)
@@ -0,0 +1,5 @@
+set(READ_BY_SUBDIR 1)
+set(READ_BY_PARENT 1)
+set(NEVER_READ 1)
+message(STATUS "${READ_BY_PARENT}")
+add_subdirectory(WarnUnusedDirectory)
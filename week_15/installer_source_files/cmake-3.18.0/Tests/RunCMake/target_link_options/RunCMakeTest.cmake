@@ -56,6 +56,7 @@ if (NOT CMAKE_C_COMPILER_ID STREQUAL "Intel")
       run_cmake_target(genex_DEVICE_LINK CMP0105_OLD LinkOptions_CMP0105_OLD --config Release)
       run_cmake_target(genex_DEVICE_LINK CMP0105_NEW LinkOptions_CMP0105_NEW --config Release)
       run_cmake_target(genex_DEVICE_LINK device LinkOptions_device --config Release)
+      run_cmake_target(genex_DEVICE_LINK device_interface LinkOptions_device_interface --config Release)
     endif()
 
     run_cmake_target(genex_DEVICE_LINK no_device LinkOptions_no_device --config Release)
@@ -43,6 +43,11 @@ if (CMake_TEST_CUDA)
     set_property(TARGET LinkOptions_device PROPERTY CUDA_SEPARABLE_COMPILATION ON)
     target_link_options(LinkOptions_device PRIVATE $<DEVICE_LINK:${pre}BADFLAG_DEVICE_LINK${obj}>
                                                   $<HOST_LINK:${pre}BADFLAG_NORMAL_LINK${obj}>)
+
+    # Shares the interface closure with LinkOptions_shared_interface.
+    add_executable(LinkOptions_device_interface LinkOptionsDevice.cu)
+    set_property(TARGET LinkOptions_device_interface PROPERTY CUDA_SEPARABLE_COMPILATION ON)
+    target_link_libraries(LinkOptions_device_interface PRIVATE LinkOptions_interface)
   endif()
 
   add_executable(LinkOptions_no_device LinkOptionsDevice.cu)
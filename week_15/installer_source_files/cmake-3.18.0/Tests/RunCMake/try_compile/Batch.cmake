@@ -0,0 +1,52 @@
+enable_language(C)
+
+set(bad_src ${CMAKE_CURRENT_BINARY_DIR}/bad.c)
+file(WRITE "${bad_src}" "int main(void) { return undeclared; }\n")
+
+function(record name)
+  set_property(GLOBAL APPEND PROPERTY calls "${name}=${${name}}")
+endfunction()
+
+try_compile_batch(BEGIN)
+
+try_compile_batch(QUEUE)
+try_compile(good ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE good_out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
+try_compile_batch(CALL record good)
+
+try_compile_batch(QUEUE)
+try_compile(bad ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${bad_src}
+  OUTPUT_VARIABLE bad_out
+  )
+try_compile_batch(CALL record bad)
+
+# A call not announced by QUEUE is built right away.
+try_compile(now ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  )
+try_compile_batch(CALL record now)
+
+get_property(calls GLOBAL PROPERTY calls)
+if(NOT calls STREQUAL "now=TRUE")
+  message(FATAL_ERROR "calls before END are:\n  ${calls}")
+endif()
+
+try_compile_batch(END)
+
+get_property(calls GLOBAL PROPERTY calls)
+if(NOT calls STREQUAL "now=TRUE;good=TRUE;bad=FALSE")
+  message(FATAL_ERROR "calls after END are:\n  ${calls}")
+endif()
+if(NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/copy")
+  message(FATAL_ERROR "COPY_FILE did not produce\n  ${CMAKE_CURRENT_BINARY_DIR}/copy")
+endif()
+if(NOT good_out MATCHES "src\\.c")
+  message(FATAL_ERROR "output of good check is:\n${good_out}")
+endif()
+if(NOT bad_out MATCHES "undeclared")
+  message(FATAL_ERROR "output of bad check is:\n${bad_out}")
+endif()
@@ -0,0 +1,3 @@
+try_compile_batch(BEGIN)
+try_compile_batch(BEGIN)
+try_compile_batch(END)
@@ -0,0 +1,18 @@
+enable_language(C)
+
+set(src_dir ${CMAKE_CURRENT_BINARY_DIR}/src)
+file(WRITE "${src_dir}/header.h" "#define VALUE 0\n")
+file(WRITE "${src_dir}/main.c" "#include \"header.h\"\nint main(void) { return VALUE; }\n")
+
+try_compile_batch(BEGIN)
+try_compile_batch(QUEUE)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${src_dir}/main.c
+  OUTPUT_VARIABLE out
+  )
+try_compile_batch(END)
+
+# The queued copy of the source still finds the header next to it.
+if(NOT result)
+  message(FATAL_ERROR "result of the check is '${result}':\n${out}")
+endif()
@@ -0,0 +1,22 @@
+enable_language(C)
+include(CheckIncludeFile)
+include(CheckCSourceCompiles)
+
+try_compile_batch(BEGIN)
+check_include_file(stdio.h HAVE_STDIO_H)
+check_include_file(does_not_exist.h HAVE_DOES_NOT_EXIST_H)
+check_c_source_compiles("int main(void) { return 0; }" SOURCE_COMPILES)
+check_c_source_compiles("int main(void) { return 0; }" SOURCE_FAIL_REGEX
+  FAIL_REGEX "Change Dir")
+try_compile_batch(END)
+
+foreach(var HAVE_STDIO_H SOURCE_COMPILES)
+  if(NOT ${var})
+    message(FATAL_ERROR "${var} is '${${var}}'")
+  endif()
+endforeach()
+foreach(var HAVE_DOES_NOT_EXIST_H SOURCE_FAIL_REGEX)
+  if(NOT DEFINED ${var} OR ${var})
+    message(FATAL_ERROR "${var} is '${${var}}'")
+  endif()
+endforeach()
@@ -0,0 +1,12 @@
+enable_language(C)
+
+try_compile_batch(BEGIN)
+try_compile_batch(QUEUE)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  )
+# Reading the result before END builds the checks queued so far.
+if(NOT result)
+  message(FATAL_ERROR "result read before END is '${result}'")
+endif()
+try_compile_batch(END)
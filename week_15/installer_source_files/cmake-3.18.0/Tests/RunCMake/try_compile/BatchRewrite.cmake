@@ -0,0 +1,17 @@
+enable_language(C)
+
+set(src ${CMAKE_CURRENT_BINARY_DIR}/rewrite.c)
+file(WRITE "${src}" "int main(void) { return 0; }\n")
+
+try_compile_batch(BEGIN)
+try_compile_batch(QUEUE)
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${src}
+  )
+# The queued check builds the source as it was when queued.
+file(WRITE "${src}" "int main(void) { return undeclared; }\n")
+try_compile_batch(END)
+
+if(NOT result)
+  message(FATAL_ERROR "result of the rewritten source is '${result}'")
+endif()
@@ -0,0 +1,3 @@
+set(expect_result TRUE)
+set(CMAKE_TRY_COMPILE_CACHE_INVALIDATE ON)
+include(${CMAKE_CURRENT_LIST_DIR}/ResultCache.cmake)
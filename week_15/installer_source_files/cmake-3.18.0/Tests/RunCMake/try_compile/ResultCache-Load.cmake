@@ -0,0 +1,2 @@
+set(expect_result FALSE)
+include(${CMAKE_CURRENT_LIST_DIR}/ResultCache.cmake)
@@ -0,0 +1,25 @@
+enable_language(C)
+
+# Share try_compile outcomes through a directory outside the build tree.
+set(CMAKE_TRY_COMPILE_CACHE_DIR "${cache_dir}")
+
+try_compile(result ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${CMAKE_CURRENT_SOURCE_DIR}/src.c
+  OUTPUT_VARIABLE out
+  COPY_FILE ${CMAKE_CURRENT_BINARY_DIR}/copy
+  )
+if(NOT "${result}" STREQUAL "${expect_result}")
+  message(FATAL_ERROR "try_compile result is '${result}', not '${expect_result}'")
+endif()
+if(result AND NOT EXISTS "${CMAKE_CURRENT_BINARY_DIR}/copy")
+  message(FATAL_ERROR "COPY_FILE did not produce\n  ${CMAKE_CURRENT_BINARY_DIR}/copy")
+endif()
+if(out MATCHES "CMAKE_TRY_COMPILE_(BINARY_DIR|TARGET_NAME)")
+  message(FATAL_ERROR "try_compile output not restored:\n${out}")
+endif()
+
+file(GLOB entries "${cache_dir}/*")
+list(LENGTH entries count)
+if(NOT count EQUAL 1)
+  message(FATAL_ERROR "expected one cache entry, got:\n  ${entries}")
+endif()
@@ -0,0 +1,18 @@
+enable_language(C)
+
+set(CMAKE_TRY_COMPILE_CACHE_DIR "${CMAKE_CURRENT_BINARY_DIR}/cache")
+set(src_dir ${CMAKE_CURRENT_BINARY_DIR}/src)
+file(WRITE "${src_dir}/main.c" "#include \"header.h\"\nint main(void) { return VALUE; }\n")
+
+# A header the source includes with quotes is part of the stored key.
+file(WRITE "${src_dir}/header.h" "#define VALUE 0\n")
+try_compile(first ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${src_dir}/main.c
+  )
+file(WRITE "${src_dir}/header.h" "#error header changed\n")
+try_compile(second ${CMAKE_CURRENT_BINARY_DIR}
+  SOURCES ${src_dir}/main.c
+  )
+if(NOT first OR second)
+  message(FATAL_ERROR "results are '${first}' and '${second}', not 'TRUE' and 'FALSE'")
+endif()
@@ -102,3 +102,28 @@ endif()
 if(UNIX)
   run_cmake(CleanupNoFollowSymlink)
 endif()
+
+# Share try_compile outcomes between build trees.
+set(cache_dir ${RunCMake_BINARY_DIR}/ResultCache-dir)
+file(REMOVE_RECURSE "${cache_dir}")
+set(RunCMake_TEST_OPTIONS -Dcache_dir=${cache_dir})
+run_cmake(ResultCache-Store)
+# Make the stored outcome a failure so that using it can be observed.
+file(GLOB results "${cache_dir}/*/result.txt")
+foreach(result IN LISTS results)
+  file(WRITE "${result}" "1")
+endforeach()
+run_cmake(ResultCache-Load)
+run_cmake(ResultCache-Invalidate)
+run_cmake(ResultCache-Store)
+unset(RunCMake_TEST_OPTIONS)
+run_cmake(ResultCacheHeader)
+
+run_cmake(Batch)
+run_cmake(BatchRead)
+run_cmake(BatchRewrite)
+run_cmake(BatchInclude)
+run_cmake(BatchModules)
+run_cmake(BatchEndNoBegin)
+run_cmake(BatchBeginTwice)
+run_cmake(BatchNoEnd)